@@ -0,0 +1,184 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Workloads drawn to in-memory sink. Each prints one JSON line with CPU
+// time per operation, bytes per frame and heap allocations.
+//
+// msos_curses_bench [operations] [terminal]
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <time.h>
+
+#include "curses.h"
+
+#include "workloads.hpp"
+
+namespace
+{
+
+std::size_t allocations = 0;
+
+constexpr int default_operations = 2000;
+
+struct Result
+{
+    const char* workload;
+    int operations;
+    long long cpu_ns;
+    std::size_t bytes;
+    int max_frame_bytes;
+    std::size_t allocations;
+};
+
+long long cpu_time_ns()
+{
+    struct timespec now = {};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<long long>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+class Bench
+{
+public:
+    Bench(const char* terminal, int operations)
+        : terminal_(terminal)
+        , operations_(operations)
+    {
+        output_ = std::fopen("/dev/null", "w");
+        input_ = std::fopen("/dev/null", "r");
+        screen_ = newterm(terminal, output_, input_);
+        start_color();
+        workloads::init_pairs();
+    }
+
+    ~Bench()
+    {
+        endwin();
+        delscreen(screen_);
+        std::fclose(output_);
+        std::fclose(input_);
+    }
+
+    bool ready() const
+    {
+        return screen_ != nullptr;
+    }
+
+    void run(const workloads::Workload& workload)
+    {
+        wattrset(stdscr, A_NORMAL);
+        clear();
+        workload.setup();
+        frame([](int) {}, 0);
+
+        const auto operation = workload.operation;
+        for (int i = 0; i < operations_ / 10; ++i)
+        {
+            frame(operation, i);
+        }
+
+        Result result = {workload.name, operations_, 0, 0, 0, 0};
+        const std::size_t allocated = allocations;
+        const long long start = cpu_time_ns();
+        for (int i = 0; i < operations_; ++i)
+        {
+            const int bytes = frame(operation, i);
+            result.bytes += static_cast<std::size_t>(bytes);
+            result.max_frame_bytes = bytes > result.max_frame_bytes ? bytes : result.max_frame_bytes;
+        }
+        result.cpu_ns = cpu_time_ns() - start;
+        result.allocations = allocations - allocated;
+        report(result);
+    }
+
+private:
+    template <typename Operation>
+    int frame(const Operation& operation, int i)
+    {
+        set_output_buffer(screen_, output_buffer_, sizeof(output_buffer_));
+        operation(i);
+        refresh();
+        return output_buffer_size(screen_);
+    }
+
+    void report(const Result& result) const
+    {
+        std::fprintf(stdout,
+            "{\"workload\": \"%s\", \"terminal\": \"%s\", \"operations\": %d, \"ns_per_op\": %.1f, "
+            "\"bytes_per_frame\": %.1f, \"max_frame_bytes\": %d, \"allocations\": %zu}\n",
+            result.workload, terminal_, result.operations,
+            static_cast<double>(result.cpu_ns) / result.operations,
+            static_cast<double>(result.bytes) / result.operations,
+            result.max_frame_bytes, result.allocations);
+    }
+
+    const char* terminal_;
+    int operations_;
+    std::FILE* output_;
+    std::FILE* input_;
+    SCREEN* screen_;
+    char output_buffer_[64 * 1024];
+};
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* memory = std::malloc(size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+int main(int argc, char* argv[])
+{
+    const int operations = argc > 1 ? std::atoi(argv[1]) : default_operations;
+    const char* terminal = argc > 2 ? argv[2] : "xterm-256color";
+    if (operations <= 0)
+    {
+        std::fprintf(stderr, "usage: %s [operations] [terminal]\n", argv[0]);
+        return 1;
+    }
+
+    static Bench bench(terminal, operations);
+    if (!bench.ready())
+    {
+        std::fprintf(stderr, "no screen for terminal %s\n", terminal);
+        return 1;
+    }
+
+    for (const workloads::Workload& workload : workloads::all)
+    {
+        bench.run(workload);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Draws workloads on terminal at standard output, built once with
+// msos_curses and once with host ncurses, see scripts/compare_ncurses.py.
+// After each workload OSC marker with its name splits captured output,
+// timing goes as JSON lines to results file.
+//
+// pty_driver operations results_file
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <time.h>
+#include <unistd.h>
+
+#include "workloads.hpp"
+
+namespace
+{
+
+long long wall_time_ns()
+{
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<long long>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+void mark(const char* name)
+{
+    char marker[64];
+    const int size = std::snprintf(marker, sizeof(marker), "\033]bench;%s\007", name);
+    static_cast<void>(write(STDOUT_FILENO, marker, static_cast<std::size_t>(size)));
+}
+
+bool start()
+{
+#ifdef MSOS_CURSES_DRIVER
+    // Unbuffered stream, each write of renderer reaches pty like on UART
+    std::FILE* output = fdopen(dup(STDOUT_FILENO), "w");
+    if (output == nullptr)
+    {
+        return false;
+    }
+    setvbuf(output, nullptr, _IONBF, 0);
+    return newterm(nullptr, output, stdin) != nullptr;
+#else
+    return initscr() != nullptr;
+#endif // MSOS_CURSES_DRIVER
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int operations = argc > 2 ? std::atoi(argv[1]) : 0;
+    std::FILE* results = argc > 2 ? std::fopen(argv[2], "w") : nullptr;
+    if (operations <= 0 || results == nullptr || !start())
+    {
+        std::fprintf(stderr, "usage: %s operations results_file\n", argv[0]);
+        return 1;
+    }
+    start_color();
+    workloads::init_pairs();
+
+    for (const workloads::Workload& workload : workloads::all)
+    {
+        wattrset(stdscr, A_NORMAL);
+        clear();
+        workload.setup();
+        refresh();
+        mark("setup");
+
+        const long long begin = wall_time_ns();
+        for (int i = 0; i < operations; ++i)
+        {
+            workload.operation(i);
+            refresh();
+        }
+        const long long elapsed = wall_time_ns() - begin;
+        mark(workload.name);
+        std::fprintf(results, "{\"workload\": \"%s\", \"operations\": %d, \"wall_ns\": %lld}\n",
+            workload.name, operations, elapsed);
+    }
+
+    endwin();
+    std::fclose(results);
+    return 0;
+}
@@ -0,0 +1,214 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+// Scripted drawing shared by msos_curses_bench and drivers comparing
+// with host ncurses, so uses only API common to both libraries.
+
+#include <cstdio>
+#include <cstring>
+
+#include <curses.h>
+
+namespace workloads
+{
+
+constexpr int table_rows = 20;
+constexpr int table_columns = 4;
+constexpr int line_size = 80;
+constexpr int log_lines = 24;
+
+// Deterministic text, same for every run
+inline void fill_line(char* line, int size, unsigned seed)
+{
+    constexpr const char* words[] = {"sensor", "value", "ok", "warning", "temperature", "42", "pump", "-", "3.14"};
+    int position = 0;
+    while (position < size)
+    {
+        seed = seed * 1103515245u + 12345u;
+        const char* word = words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+        for (const char* c = word; *c != 0 && position < size; ++c)
+        {
+            line[position++] = *c;
+        }
+        if (position < size)
+        {
+            line[position++] = ' ';
+        }
+    }
+    line[size] = 0;
+}
+
+inline int columns()
+{
+    return getmaxx(stdscr) < line_size ? getmaxx(stdscr) : line_size;
+}
+
+inline void draw_base()
+{
+    char line[line_size + 1];
+    for (int y = 0; y < getmaxy(stdscr); ++y)
+    {
+        fill_line(line, columns(), static_cast<unsigned>(y));
+        mvaddstr(y, 0, line);
+    }
+}
+
+inline void init_pairs()
+{
+    for (short pair = 1; pair < 8; ++pair)
+    {
+        init_pair(pair, static_cast<short>(COLOR_BLACK + pair), COLOR_BLACK);
+    }
+}
+
+inline char log[log_lines][line_size + 1];
+inline char text[line_size + 1];
+inline int text_length = 0;
+
+struct Workload
+{
+    const char* name;
+    // Drawn before measuring
+    void (*setup)();
+    // Followed by refresh
+    void (*operation)(int i);
+};
+
+inline const Workload all[] = {
+    {"full_repaint", [] {}, [](int i) {
+        char line[line_size + 1];
+        clear();
+        for (int y = 0; y < getmaxy(stdscr); ++y)
+        {
+            fill_line(line, columns(), static_cast<unsigned>(y + i));
+            mvaddstr(y, 0, line);
+        }
+    }},
+
+    {"status_field", draw_base, [](int i) {
+        char field[16];
+        std::snprintf(field, sizeof(field), "%8d", i);
+        mvaddstr(0, columns() - 8, field);
+    }},
+
+    {"log_tail", [] {
+        for (int y = 0; y < log_lines; ++y)
+        {
+            fill_line(log[y], line_size, static_cast<unsigned>(y));
+        }
+    }, [](int i) {
+        // Lines move up by one, without scrolling region whole screen is sent again
+        const int lines = getmaxy(stdscr) < log_lines ? getmaxy(stdscr) : log_lines;
+        std::memmove(log[0], log[1], sizeof(log[0]) * (log_lines - 1));
+        const int size = static_cast<int>(static_cast<unsigned>(i * 7) % line_size);
+        fill_line(log[log_lines - 1], size, static_cast<unsigned>(i));
+        std::memset(log[log_lines - 1] + size, ' ', static_cast<std::size_t>(line_size - size));
+        for (int y = 0; y < lines; ++y)
+        {
+            mvaddnstr(y, 0, log[log_lines - lines + y], columns());
+        }
+    }},
+
+    {"color_table", [] {
+        for (int row = 0; row < table_rows; ++row)
+        {
+            for (int column = 0; column < table_columns; ++column)
+            {
+                wattrset(stdscr, COLOR_PAIR((1 + (row + column) % 7)));
+                mvaddstr(row + 2, column * 12, "         0");
+            }
+        }
+    }, [](int i) {
+        char value[16];
+        for (int cell = 0; cell < 3; ++cell)
+        {
+            const unsigned seed = static_cast<unsigned>(i * 3 + cell) * 2654435761u;
+            const int row = static_cast<int>(seed % table_rows);
+            const int column = static_cast<int>((seed >> 8) % table_columns);
+            std::snprintf(value, sizeof(value), "%10d", static_cast<int>(seed >> 12) % 100000);
+            wattrset(stdscr, COLOR_PAIR((1 + static_cast<int>(seed >> 20) % 7)));
+            mvaddstr(row + 2, column * 12, value);
+        }
+    }},
+
+    {"popup", draw_base, [](int i) {
+        constexpr int top = 6;
+        constexpr int left = 20;
+        constexpr int height = 10;
+        constexpr int width = 40;
+        if (i % 2 == 1)
+        {
+            // Closing shows content under popup again
+            char line[line_size + 1];
+            for (int y = top; y < top + height; ++y)
+            {
+                fill_line(line, columns(), static_cast<unsigned>(y));
+                mvaddnstr(y, left, line + left, width);
+            }
+            return;
+        }
+        for (int y = top; y < top + height; ++y)
+        {
+            const bool edge = y == top || y == top + height - 1;
+            move(y, left);
+            addch(static_cast<chtype>((y == top ? 'l' : edge ? 'm' : 'x') | A_ALTCHARSET));
+            for (int x = 1; x < width - 1; ++x)
+            {
+                addch(edge ? static_cast<chtype>('q' | A_ALTCHARSET) : static_cast<chtype>(' '));
+            }
+            addch(static_cast<chtype>((y == top ? 'k' : edge ? 'j' : 'x') | A_ALTCHARSET));
+        }
+        mvaddstr(top + 4, left + 12, "Confirm action?");
+    }},
+
+    {"text_editing", [] {
+        draw_base();
+        text_length = 0;
+    }, [](int i) {
+        constexpr int row = 20;
+        int cursor = static_cast<int>(static_cast<unsigned>(i * 13) % static_cast<unsigned>(text_length + 1));
+        if (i % 10 == 9 && cursor > 0)
+        {
+            std::memmove(text + cursor - 1, text + cursor, static_cast<std::size_t>(text_length - cursor));
+            --text_length;
+            --cursor;
+        }
+        else
+        {
+            if (text_length == columns() - 1)
+            {
+                text_length = 0;
+                cursor = 0;
+            }
+            std::memmove(text + cursor + 1, text + cursor, static_cast<std::size_t>(text_length - cursor));
+            text[cursor++] = static_cast<char>('a' + i % 26);
+            ++text_length;
+        }
+        // Line is drawn from edited position to its end
+        const int from = cursor > 0 ? cursor - 1 : 0;
+        mvaddnstr(row, from, text + from, text_length - from);
+        for (int x = text_length; x < columns(); ++x)
+        {
+            addch(' ');
+        }
+        move(row, cursor);
+    }},
+};
+
+} // namespace workloads
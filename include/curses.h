@@ -18,6 +18,7 @@
 
 #include <term.h>
 #include <stdio.h>
+#include <wchar.h>
 
 #if defined(__cplusplus)
 extern "C"
@@ -30,15 +31,38 @@ extern "C"
     //------         CONFIG               -------//
     //-------------------------------------------//
 
-    typedef char cchar_t;
+    // Store unicode text in window cells, costs 4 bytes per cell
+    #ifndef CURSES_WIDECHAR
+        #define CURSES_WIDECHAR 1
+    #endif // CURSES_WIDECHAR
+
+    #ifndef CCHARW_MAX
+        #define CCHARW_MAX 5
+    #endif // CCHARW_MAX
 
     #ifndef COLOR_PAIRS
         #define COLOR_PAIRS 16
     #endif // COLOR_PAIRS
 
     #ifndef COLORS
-        #define COLORS 8
-    #endif
+        #define COLORS 256
+    #endif // COLORS
+
+    // Screens available to initscr and newterm, each holds its own buffers,
+    // hosts driving several terminals raise it
+    #ifndef MAX_SCREENS
+        #define MAX_SCREENS 1
+    #endif // MAX_SCREENS
+
+    // Lock-free draw queue per screen, needs atomic compare and swap
+    #ifndef CURSES_DRAW_QUEUE
+        #define CURSES_DRAW_QUEUE 1
+    #endif // CURSES_DRAW_QUEUE
+
+    // Per screen counters read with screen_stats, 0 leaves no cost
+    #ifndef CURSES_STATS
+        #define CURSES_STATS 1
+    #endif // CURSES_STATS
 
     // -----------------------------------------//
     // -------         types            --------//
@@ -53,11 +77,22 @@ extern "C"
 
     // maximum color pairs = 16 due to implementation limit, violates X/Open Curses Issue 4 version 2
     typedef short chtype;
+    typedef chtype attr_t;
+
+    typedef struct cchar_t
+    {
+        attr_t attr;
+        wchar_t chars[CCHARW_MAX];
+    } cchar_t;
 
     typedef struct WINDOW
     {
         bool key_translation;
+        // Cursor is left where update ends instead of moved back, see leaveok
+        bool leave_cursor;
         char attributes;
+        // Character and attributes merged into written cells, see wbkgd
+        chtype background;
 
         short max_x;
         short max_y;
@@ -65,11 +100,12 @@ extern "C"
         short cursor_y;
 
         chtype* screen_buffer;
+        // Unicode text of cells, NULL when CURSES_WIDECHAR is disabled
+        wchar_t* wide_buffer;
     } WINDOW;
 
-    typedef struct SCREEN {
-
-    } SCREEN;
+    // Terminal driven by library, opaque
+    typedef struct SCREEN SCREEN;
 
     // Initialization
 
@@ -101,6 +137,24 @@ extern "C"
     int wechochar(WINDOW* win, const chtype ch);
     #define echochar(ch) wechochar(stdscr, ch)
 
+    // https://invisible-island.net/ncurses/man/curs_add_wch.3x.html
+    int wadd_wch(WINDOW* win, const cchar_t* wch);
+    #define add_wch(wch) wadd_wch(stdscr, wch)
+    int mvwadd_wch(WINDOW* win, int y, int x, const cchar_t* wch);
+    #define mvadd_wch(y, x, wch) mvwadd_wch(stdscr, y, x, wch)
+
+    // https://invisible-island.net/ncurses/man/curs_addwstr.3x.html
+    int waddnwstr(WINDOW* win, const wchar_t* wstr, int n);
+    int waddwstr(WINDOW* win, const wchar_t* wstr);
+    #define addwstr(wstr) waddwstr(stdscr, wstr)
+    #define addnwstr(wstr, n) waddnwstr(stdscr, wstr, n)
+    int mvwaddwstr(WINDOW* win, int y, int x, const wchar_t* wstr);
+    #define mvaddwstr(y, x, wstr) mvwaddwstr(stdscr, y, x, wstr)
+
+    // https://invisible-island.net/ncurses/man/curs_getcchar.3x.html
+    int setcchar(cchar_t* wcval, const wchar_t* wch, attr_t attrs, short pair, const void* opts);
+    int getcchar(const cchar_t* wcval, wchar_t* wch, attr_t* attrs, short* pair, void* opts);
+
     // https://invisible-island.net/ncurses/man/curs_addchstr.3x.html
     int waddchstr(WINDOW *win, const chtype *chstr);
     #define addchstr(chstr) waddchstr(stdscr, chstr)
@@ -144,6 +198,14 @@ extern "C"
     int mvwvline(WINDOW *, int y, int x, chtype ch, int n);
 
     // https://invisible-island.net/ncurses/man/curs_border_set.3x.html
+    // Box drawing characters taken for NULL arguments of border functions
+    extern const cchar_t wacs_lines[6];
+    #define WACS_HLINE    (&wacs_lines[0])
+    #define WACS_VLINE    (&wacs_lines[1])
+    #define WACS_ULCORNER (&wacs_lines[2])
+    #define WACS_URCORNER (&wacs_lines[3])
+    #define WACS_LLCORNER (&wacs_lines[4])
+    #define WACS_LRCORNER (&wacs_lines[5])
 int border_set(
           const cchar_t *ls, const cchar_t *rs,
           const cchar_t *ts, const cchar_t *bs,
@@ -306,9 +368,30 @@ int border_set(
 
        int endwin(void);
        bool isendwin(void);
-    //    SCREEN *newterm(const char *type, FILE *outfd, FILE *infd);
-    //    SCREEN *set_term(SCREEN *new);
-    //    void delscreen(SCREEN* sp);
+       // Up to MAX_SCREENS terminals, initscr always uses the first one.
+       // newterm makes created screen current, NULL type means TERM.
+       SCREEN *newterm(const char *type, FILE *outfd, FILE *infd);
+       SCREEN *set_term(SCREEN *new_screen);
+       void delscreen(SCREEN* sp);
+       // Safe to call from any thread. Commands wait in queue of screen
+       // until doupdate on render thread applies them in order. ERR when
+       // queue is full, then caller may retry after next doupdate, or when
+       // position is outside of screen.
+       int queue_mvaddnstr(SCREEN* sp, int y, int x, int attrs, const char* str, int n);
+       int queue_move(SCREEN* sp, int y, int x);
+       // Viewer shows stdscr of source, sized as source. doupdate of source
+       // draws all its viewers, ones of same terminal type and state share
+       // one encoded update. Viewer losing output is cleared and redrawn.
+       int attach_screen(SCREEN* source, SCREEN* viewer);
+       int detach_screen(SCREEN* viewer);
+       // Output of screen, stdout of initscr goes to console with printf.
+       // Callback returns number of bytes taken, fewer when it is full.
+       typedef int (*output_callback)(void* context, const char* data, int size);
+       int set_output_fd(SCREEN* sp, int fd);
+       int set_output_buffer(SCREEN* sp, char* buffer, int size);
+       // Bytes stored since set_output_buffer
+       int output_buffer_size(SCREEN* sp);
+       int set_output_callback(SCREEN* sp, output_callback callback, void* context);
 
        // https://invisible-island.net/ncurses/man/curs_window.3x.html
 
@@ -337,6 +420,17 @@ int border_set(
        int redrawwin(WINDOW *win);
        int wredrawln(WINDOW *win, int beg_line, int num_lines);
 
+    // https://invisible-island.net/ncurses/man/resizeterm.3x.html
+    // Cells that still fit are kept, next refresh sends only exposed and
+    // cut off parts. Sizes above SCREEN_BUFFER_SIZE cells are clipped.
+    // Unless application has own SIGWINCH handler at initscr or newterm,
+    // one is installed with SA_RESTART, so blocking calls of application
+    // are not interrupted. wgetch then returns KEY_RESIZE once new size is
+    // applied, also when it was waiting for input.
+       bool is_term_resized(int lines, int columns);
+       int resize_term(int lines, int columns);
+       int resizeterm(int lines, int columns);
+
 // https://invisible-island.net/ncurses/man/curs_getyx.3x.html
 
        void getyx(WINDOW *win, int y, int x);
@@ -354,8 +448,16 @@ int border_set(
        int ungetch(int ch);
        int has_key(int ch);
 
+       // https://invisible-island.net/ncurses/man/curs_get_wch.3x.html
+       // UTF-8 input is assembled into single character, OK is returned for
+       // characters and KEY_CODE_YES for function keys
+       int wget_wch(WINDOW *win, wint_t *wch);
+       #define get_wch(wch) wget_wch(stdscr, wch)
+
        //https://invisible-island.net/ncurses/man/curs_getstr.3x.html
-            int getstr(char *str);
+       // Line is edited inside window row at cursor, str must hold n + 1 bytes.
+       // Text is UTF-8 and n counts bytes, editing works on whole characters.
+       int getstr(char *str);
        int getnstr(char *str, int n);
        int wgetstr(WINDOW *win, char *str);
        int wgetnstr(WINDOW *win, char *str, int n);
@@ -419,6 +521,7 @@ int inchstr(chtype *chstr);
     int wmove(WINDOW *win, int y, int x);
     int move(int y, int x);
 // https://invisible-island.net/ncurses/man/curs_addstr.3x.html
+// Strings are decoded as UTF-8
         int addstr(const char *str);
        int addnstr(const char *str, int n);
        int waddstr(WINDOW *win, const char *str);
@@ -487,8 +590,195 @@ int inchstr(chtype *chstr);
     // Input
     int getch(void);
 
-    // Settings
-    #define getstr(str) getstr_(str, sizeof(str));
+    extern int ESCDELAY;
+
+    //-------------------------------------------//
+    //------            KEYS              -------//
+    //-------------------------------------------//
+
+    // Values follow ncurses numbering
+    #define KEY_CODE_YES  0400
+    #define KEY_DOWN      0402
+    #define KEY_UP        0403
+    #define KEY_LEFT      0404
+    #define KEY_RIGHT     0405
+    #define KEY_HOME      0406
+    #define KEY_BACKSPACE 0407
+    #define KEY_F0        0410
+    #define KEY_F(n)      (KEY_F0 + (n))
+    #define KEY_DC        0512
+    #define KEY_IC        0513
+    #define KEY_NPAGE     0522
+    #define KEY_PPAGE     0523
+    #define KEY_ENTER     0527
+    #define KEY_BTAB      0541
+    #define KEY_END       0550
+    #define KEY_MOUSE     0631
+    #define KEY_RESIZE    0632
+    // Extension, bracketed paste payload available through getpaste
+    #define KEY_PASTE     01000
+
+    //-------------------------------------------//
+    //------           MOUSE              -------//
+    //-------------------------------------------//
+
+    // https://invisible-island.net/ncurses/man/curs_mouse.3x.html
+    typedef unsigned long mmask_t;
+
+    typedef struct MEVENT
+    {
+        short id;
+        int x;
+        int y;
+        int z;
+        mmask_t bstate;
+    } MEVENT;
+
+    #define NCURSES_MOUSE_MASK(b, m) ((m) << (((b) - 1) * 5))
+
+    #define NCURSES_BUTTON_RELEASED 001UL
+    #define NCURSES_BUTTON_PRESSED  002UL
+    #define NCURSES_BUTTON_CLICKED  004UL
+
+    #define BUTTON1_RELEASED NCURSES_MOUSE_MASK(1, NCURSES_BUTTON_RELEASED)
+    #define BUTTON1_PRESSED  NCURSES_MOUSE_MASK(1, NCURSES_BUTTON_PRESSED)
+    #define BUTTON1_CLICKED  NCURSES_MOUSE_MASK(1, NCURSES_BUTTON_CLICKED)
+    #define BUTTON2_RELEASED NCURSES_MOUSE_MASK(2, NCURSES_BUTTON_RELEASED)
+    #define BUTTON2_PRESSED  NCURSES_MOUSE_MASK(2, NCURSES_BUTTON_PRESSED)
+    #define BUTTON2_CLICKED  NCURSES_MOUSE_MASK(2, NCURSES_BUTTON_CLICKED)
+    #define BUTTON3_RELEASED NCURSES_MOUSE_MASK(3, NCURSES_BUTTON_RELEASED)
+    #define BUTTON3_PRESSED  NCURSES_MOUSE_MASK(3, NCURSES_BUTTON_PRESSED)
+    #define BUTTON3_CLICKED  NCURSES_MOUSE_MASK(3, NCURSES_BUTTON_CLICKED)
+    #define BUTTON4_RELEASED NCURSES_MOUSE_MASK(4, NCURSES_BUTTON_RELEASED)
+    #define BUTTON4_PRESSED  NCURSES_MOUSE_MASK(4, NCURSES_BUTTON_PRESSED)
+    #define BUTTON4_CLICKED  NCURSES_MOUSE_MASK(4, NCURSES_BUTTON_CLICKED)
+    #define BUTTON5_RELEASED NCURSES_MOUSE_MASK(5, NCURSES_BUTTON_RELEASED)
+    #define BUTTON5_PRESSED  NCURSES_MOUSE_MASK(5, NCURSES_BUTTON_PRESSED)
+    #define BUTTON5_CLICKED  NCURSES_MOUSE_MASK(5, NCURSES_BUTTON_CLICKED)
+
+    #define BUTTON_CTRL           NCURSES_MOUSE_MASK(6, 001UL)
+    #define BUTTON_SHIFT          NCURSES_MOUSE_MASK(6, 002UL)
+    #define BUTTON_ALT            NCURSES_MOUSE_MASK(6, 004UL)
+    #define REPORT_MOUSE_POSITION NCURSES_MOUSE_MASK(6, 010UL)
+    #define ALL_MOUSE_EVENTS      (REPORT_MOUSE_POSITION - 1)
+
+    // Terminal reports are decoded in both SGR (1006) and X10 formats.
+    // Consecutive motion events not fetched yet by getmouse are merged
+    // into single event holding the latest position.
+    mmask_t mousemask(mmask_t newmask, mmask_t* oldmask);
+    int getmouse(MEVENT* event);
+    int ungetmouse(MEVENT* event);
+    bool has_mouse(void);
+
+    //-------------------------------------------//
+    //------       BRACKETED PASTE        -------//
+    //-------------------------------------------//
+
+    // Enables DECSET 2004, text pasted into terminal is collected in bulk and
+    // reported as single KEY_PASTE (or several when exceeds PASTE_BUFFER_SIZE)
+    int bracketed_paste(bool bf);
+    // Returns payload of last KEY_PASTE, valid until next key is read
+    const char* getpaste(int* size);
+
+    //-------------------------------------------//
+    //------         EVENT LOOP           -------//
+    //-------------------------------------------//
+
+    // Non-blocking integration for single threaded event loops.
+    // When enabled library never reads input fd and never blocks on output,
+    // output is queued until drained by evloop_drain.
+    int evloop_enable(bool bf);
+    // File descriptor to wait for readability
+    int evloop_input_fd(void);
+    // Milliseconds to wait before calling evloop_feed(NULL, 0, ...) to resolve
+    // lone ESC, -1 when nothing is pending
+    int evloop_input_timeout(void);
+    bool evloop_output_pending(void);
+    // Decodes data and stores up to max_keys keys, returns number of keys.
+    // Keys that do not fit stay queued for next call or wgetch.
+    // Input queue holds INPUT_BUFFER_SIZE bytes, bytes beyond it are not
+    // taken: consumed (may be NULL) receives number of bytes taken and the
+    // rest must be fed again after the returned keys are handled.
+    // KEY_PASTE is always last key returned from single call, paste longer
+    // than PASTE_BUFFER_SIZE is returned in several KEY_PASTE chunks.
+    // With max_keys 0 data is only queued for wgetch.
+    // NULL data releases pending escape sequence bytes as plain keys.
+    int evloop_feed(const char* data, int size, int* keys, int max_keys, int* consumed);
+    // Copies up to size pending output bytes, returns number of bytes copied
+    int evloop_drain(char* buffer, int size);
+
+    //-------------------------------------------//
+    //------         STATISTICS           -------//
+    //-------------------------------------------//
+
+    // Counted since screen was created or stats were reset. Bytes are all
+    // bytes sent to terminal, ones of kinds below included.
+    typedef struct SCREEN_STATS
+    {
+        unsigned long frames;
+        // Cells of changed lines compared, cells sent (erased ones too)
+        unsigned long cells_diffed;
+        unsigned long cells_changed;
+        unsigned long bytes;
+        unsigned long text_bytes;
+        unsigned long motion_bytes;
+        unsigned long attribute_bytes;
+        unsigned long erase_bytes;
+        // Writes, flushes, reads and polls that reach operating system
+        unsigned long syscalls;
+        // doupdate duration, percentiles are rounded up by at most 25%
+        unsigned long refresh_p50_us;
+        unsigned long refresh_p90_us;
+        unsigned long refresh_p99_us;
+        unsigned long refresh_max_us;
+        unsigned long input_bytes;
+        unsigned long keys;
+    } SCREEN_STATS;
+
+    // NULL means current screen, ERR when CURSES_STATS is disabled
+    int screen_stats(SCREEN* sp, SCREEN_STATS* stats);
+    int reset_screen_stats(SCREEN* sp);
+
+    //-------------------------------------------//
+    //------          RECORDING           -------//
+    //-------------------------------------------//
+
+    // Output chunks and input read by library are stored in buffer with
+    // time they passed, recording stops when buffer is full.
+    // NULL means current screen.
+    int start_recording(SCREEN* sp, char* buffer, int size);
+    // Returns size of recording, which stays in buffer for export
+    int stop_recording(SCREEN* sp);
+    // Writes recording as asciicast v2, input is kept as "i" events
+    int export_asciicast(SCREEN* sp, output_callback callback, void* context);
+
+    //-------------------------------------------//
+    //------            RESYNC            -------//
+    //-------------------------------------------//
+
+    // Each doupdate draws next lines_per_frame lines again in full, round
+    // robin, so output lost on noisy line is repaired within few frames
+    // without clearing whole screen. 0 disables, NULL means current screen.
+    int resync_lines(SCREEN* sp, int lines_per_frame);
+
+    //-------------------------------------------//
+    //------        TERMINAL PROBE        -------//
+    //-------------------------------------------//
+
+    #define TERMINAL_REPEAT              0x01
+    #define TERMINAL_ERASE_CHARACTERS    0x02
+    #define TERMINAL_SCROLL_REGION       0x04
+    #define TERMINAL_DIRECT_COLOR        0x08
+    #define TERMINAL_SYNCHRONIZED_OUTPUT 0x10
+
+    // Called before initscr. Terminal is asked for Device Attributes,
+    // cursor position and modes, replies are awaited up to timeout_ms
+    // (negative for default). Encodings it confirms are enabled in addition
+    // to ones from terminfo. Skipped in event loop mode.
+    int use_terminal_probe(bool bf, int timeout_ms);
+    // TERMINAL_* flags of encodings used for current terminal
+    int terminal_features(void);
+
 
 
     //-------------------------------------------//
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+
+# This file is part of MSOS Curses project.
+# Copyright (C) 2020 Mateusz Stadnik
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Compares two outputs of msos_curses_bench. Fails when any workload sends
+# more bytes per frame, allocates more, or takes more CPU time than
+# tolerance allows. Bytes and allocations are exact, time is noisy.
+#
+# compare_bench.py baseline.json current.json [time_tolerance_percent]
+
+import json
+import sys
+
+
+def load(path):
+    with open(path) as results:
+        return {(entry["workload"], entry["terminal"]): entry
+                for entry in map(json.loads, filter(str.strip, results))}
+
+
+def main():
+    if len(sys.argv) < 3:
+        print("usage: compare_bench.py baseline.json current.json [time_tolerance_percent]")
+        return 2
+
+    baseline = load(sys.argv[1])
+    current = load(sys.argv[2])
+    tolerance = float(sys.argv[3]) if len(sys.argv) > 3 else 10.0
+    regressions = 0
+    for key, entry in sorted(current.items()):
+        before = baseline.get(key)
+        if before is None:
+            continue
+        problems = []
+        if entry["bytes_per_frame"] > before["bytes_per_frame"]:
+            problems.append("bytes per frame %.1f -> %.1f" % (before["bytes_per_frame"], entry["bytes_per_frame"]))
+        if entry["allocations"] > before["allocations"]:
+            problems.append("allocations %d -> %d" % (before["allocations"], entry["allocations"]))
+        if entry["ns_per_op"] > before["ns_per_op"] * (1 + tolerance / 100):
+            problems.append("ns per op %.1f -> %.1f" % (before["ns_per_op"], entry["ns_per_op"]))
+        for problem in problems:
+            print("%s (%s): %s" % (key[0], key[1], problem))
+        regressions += len(problems)
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
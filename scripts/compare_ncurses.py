@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+
+# This file is part of MSOS Curses project.
+# Copyright (C) 2020 Mateusz Stadnik
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Runs the same workloads through msos_curses and host ncurses, each
+# driving its own pty, and reports bytes emitted per workload, wall time
+# and peak resident memory. Drivers are built by benchmarks/CMakeLists.txt.
+#
+# compare_ncurses.py msos_curses_pty_driver ncurses_pty_driver
+#     [--operations N] [--term TERM] [--size LINESxCOLUMNS] [--json]
+
+import argparse
+import fcntl
+import json
+import os
+import re
+import select
+import struct
+import subprocess
+import tempfile
+import termios
+import time
+
+MARKER = re.compile(rb"\033\]bench;([a-z_]+)\007")
+
+
+def run(driver, operations, term, lines, columns):
+    master, slave = os.openpty()
+    fcntl.ioctl(slave, termios.TIOCSWINSZ, struct.pack("HHHH", lines, columns, 0, 0))
+    with tempfile.NamedTemporaryFile(mode="r", suffix=".json") as results:
+        environment = dict(os.environ, TERM=term, LINES=str(lines), COLUMNS=str(columns))
+        start = time.monotonic()
+        process = subprocess.Popen([driver, str(operations), results.name], stdin=slave, stdout=slave,
+                                   stderr=subprocess.DEVNULL, env=environment, start_new_session=True)
+        os.close(slave)
+
+        # Pty is drained all the time, so driver never waits for reader
+        output = bytearray()
+        while True:
+            ready, _, _ = select.select([master], [], [], 0.1)
+            if ready:
+                try:
+                    data = os.read(master, 65536)
+                except OSError:
+                    data = b""
+                if not data:
+                    break
+                output += data
+            elif process.poll() is not None:
+                break
+        _, status, usage = os.wait4(process.pid, 0) if process.returncode is None else (0, 0, None)
+        elapsed = time.monotonic() - start
+        os.close(master)
+        timings = {entry["workload"]: entry for entry in map(json.loads, filter(str.strip, results))}
+
+    workloads = {}
+    previous = 0
+    for match in MARKER.finditer(output):
+        name = match.group(1).decode()
+        if name != "setup":
+            workloads[name] = {
+                "bytes": match.start() - previous,
+                "wall_ns": timings.get(name, {}).get("wall_ns", 0),
+            }
+        previous = match.end()
+    return {
+        "workloads": workloads,
+        "total_bytes": len(output),
+        "wall_s": elapsed,
+        "max_rss_kb": usage.ru_maxrss if usage is not None else 0,
+        "status": status,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("msos_driver")
+    parser.add_argument("ncurses_driver")
+    parser.add_argument("--operations", type=int, default=500)
+    parser.add_argument("--term", default="xterm-256color")
+    parser.add_argument("--size", default="24x80")
+    parser.add_argument("--json", action="store_true")
+    arguments = parser.parse_args()
+    lines, columns = map(int, arguments.size.split("x"))
+
+    results = {
+        "msos_curses": run(arguments.msos_driver, arguments.operations, arguments.term, lines, columns),
+        "ncurses": run(arguments.ncurses_driver, arguments.operations, arguments.term, lines, columns),
+    }
+    if arguments.json:
+        print(json.dumps(results, indent=2))
+        return 0
+
+    ours = results["msos_curses"]
+    theirs = results["ncurses"]
+    print("%-14s %12s %12s %7s %12s %12s" % ("workload", "msos bytes", "ncurses", "ratio", "msos ms", "ncurses ms"))
+    for name, entry in ours["workloads"].items():
+        other = theirs["workloads"].get(name, {"bytes": 0, "wall_ns": 0})
+        ratio = entry["bytes"] / other["bytes"] if other["bytes"] else float("inf")
+        print("%-14s %12d %12d %7.2f %12.1f %12.1f" % (name, entry["bytes"], other["bytes"], ratio,
+                                                       entry["wall_ns"] / 1e6, other["wall_ns"] / 1e6))
+    print("%-14s %12d %12d" % ("total bytes", ours["total_bytes"], theirs["total_bytes"]))
+    print("%-14s %12d %12d" % ("max rss kB", ours["max_rss_kb"], theirs["max_rss_kb"]))
+    return 0 if ours["status"] == 0 and theirs["status"] == 0 else 1
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
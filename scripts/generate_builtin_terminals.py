@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+
+# This file is part of MSOS Curses project.
+# Copyright (C) 2020 Mateusz Stadnik
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Regenerates sources/builtin_terminals.hpp from terminfo database of
+# host with infocmp. Result is kept in repository, targets without file
+# system cannot run it.
+
+import subprocess
+import sys
+
+TERMINALS = ["vt100", "vt220", "xterm-256color", "linux", "screen"]
+
+# Some compilers predefine linux macro
+IDENTIFIERS = {"linux": "linux_console"}
+
+LICENSE = """// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+"""
+
+
+def unescape(value):
+    result = bytearray()
+    i = 0
+    while i < len(value):
+        c = value[i]
+        if c == "^" and i + 1 < len(value):
+            i += 1
+            result.append(0x7F if value[i] == "?" else ord(value[i]) & 0x1F)
+        elif c == "\\" and i + 1 < len(value):
+            i += 1
+            c = value[i]
+            simple = {"E": 0x1B, "e": 0x1B, "n": 0x0A, "l": 0x0A, "r": 0x0D, "t": 0x09,
+                      "b": 0x08, "f": 0x0C, "s": 0x20, "^": 0x5E, "\\": 0x5C, ",": 0x2C,
+                      ":": 0x3A, "a": 0x07}
+            if c in simple:
+                result.append(simple[c])
+            elif c.isdigit():
+                digits = value[i:i + 3]
+                number = int(digits, 8)
+                # Compiled format cannot hold NUL, \0 stands for \200
+                result.append(0x80 if number == 0 else number)
+                i += 2
+            else:
+                result.append(ord(c))
+        else:
+            result.append(ord(c))
+        i += 1
+    return bytes(result)
+
+
+def c_string(data):
+    out = '"'
+    for byte in data:
+        if byte in (0x22, 0x5C) or byte < 0x20 or byte > 0x7E:
+            out += "\\%03o" % byte
+        else:
+            out += chr(byte)
+    return out + '"'
+
+
+def describe(term):
+    text = subprocess.run(["infocmp", "-1", "-L", "-q", term], check=True,
+                          capture_output=True, text=True).stdout
+    lines = [line.strip() for line in text.splitlines()
+             if line.strip() and not line.startswith("#")]
+    names = lines[0].rstrip(",")
+    booleans, numbers, strings = [], [], []
+    for line in lines[1:]:
+        line = line[:-1] if line.endswith(",") else line
+        if "=" in line:
+            name, value = line.split("=", 1)
+            strings.append((name, unescape(value)))
+        elif "#" in line:
+            name, value = line.split("#", 1)
+            numbers.append((name, int(value, 0)))
+        elif not line.endswith("@"):
+            booleans.append(line)
+    return names, booleans, numbers, strings
+
+
+def main(path):
+    out = [LICENSE, "#pragma once", "", '#include "description.hpp"', "",
+           "// Generated by scripts/generate_builtin_terminals.py", "",
+           "namespace msos::curses::terminals", "{", ""]
+    for term in TERMINALS:
+        names, booleans, numbers, strings = describe(term)
+        identifier = IDENTIFIERS.get(term, term.replace("-", "_"))
+        out.append("constexpr Boolean %s_booleans[] = {" % identifier)
+        out += ["    Boolean::%s," % name for name in booleans]
+        out.append("};")
+        out.append("")
+        out.append("constexpr NumberValue %s_numbers[] = {" % identifier)
+        out += ["    {Number::%s, %d}," % (name, value) for name, value in numbers]
+        out.append("};")
+        out.append("")
+        out.append("constexpr StringValue %s_strings[] = {" % identifier)
+        out += ["    {String::%s, %s}," % (name, c_string(value)) for name, value in strings]
+        out.append("};")
+        out.append("")
+        out.append("constexpr Description %s(%s, %s_booleans, %s_numbers, %s_strings);"
+                   % (identifier, c_string(names.encode()), identifier, identifier, identifier))
+        out.append("")
+    out.append("constexpr const Description* all[] = {")
+    out += ["    &%s," % IDENTIFIERS.get(term, term.replace("-", "_")) for term in TERMINALS]
+    out.append("};")
+    out.append("")
+    out.append("} // namespace msos::curses::terminals")
+    with open(path, "w") as file:
+        file.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1])
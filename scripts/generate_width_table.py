@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+
+# This file is part of MSOS Curses project.
+# Copyright (C) 2020 Mateusz Stadnik
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Generates column width table used by curses instead of locale wcwidth.
+# Only ranges with width different than 1 are stored.
+
+import sys
+import unicodedata
+
+MAX_CODEPOINT = 0x10ffff
+
+# Unassigned codepoints reserved for CJK ideographs are wide
+WIDE_RESERVED = [
+    (0x3400, 0x4dbf),
+    (0x4e00, 0x9fff),
+    (0xf900, 0xfaff),
+    (0x20000, 0x2fffd),
+    (0x30000, 0x3fffd),
+]
+
+
+def width(codepoint):
+    if codepoint == 0:
+        return 1
+    character = chr(codepoint)
+    category = unicodedata.category(character)
+    if category == "Cn":
+        return 2 if any(first <= codepoint <= last for first, last in WIDE_RESERVED) else 1
+    if category in ("Mn", "Me") or codepoint == 0x200b:
+        return 0
+    if category == "Cf" and codepoint != 0x00ad:
+        return 0
+    # Hangul Jamo medial vowels and final consonants combine with initial consonant
+    if 0x1160 <= codepoint <= 0x11ff:
+        return 0
+    if unicodedata.east_asian_width(character) in ("W", "F"):
+        return 2
+    return 1
+
+
+def ranges():
+    start = 0
+    current = width(0)
+    for codepoint in range(1, MAX_CODEPOINT + 2):
+        value = width(codepoint) if codepoint <= MAX_CODEPOINT else None
+        if value != current:
+            if current != 1:
+                yield start, codepoint - 1, current
+            start = codepoint
+            current = value
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: generate_width_table.py <output header>")
+        return 1
+
+    lines = [
+        "// Generated by scripts/generate_width_table.py from Unicode "
+        + unicodedata.unidata_version + ", do not edit",
+        "",
+        "#pragma once",
+        "",
+        "#include <cstdint>",
+        "",
+        "namespace msos::curses",
+        "{",
+        "",
+        "// {first | width << 21, last}, sorted by codepoint",
+        "constexpr std::uint32_t width_table[][2] = {",
+    ]
+    for first, last, value in ranges():
+        lines.append("    {{0x{:06x}, 0x{:06x}}},".format(first | value << 21, last))
+    lines += [
+        "};",
+        "",
+        "} // namespace msos::curses",
+        "",
+    ]
+
+    with open(sys.argv[1], "w") as output:
+        output.write("\n".join(lines))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+
+# This file is part of MSOS Curses project.
+# Copyright (C) 2020 Mateusz Stadnik
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Replays input events of asciicast v2 recording, as written by
+# export_asciicast, into application running on a pty and records its
+# output again. With --baud output is read no faster than serial line of
+# that speed would carry it, so slow terminal problems show up offline.
+# Prints bytes sent after first input and input latency of recording and
+# of replay, fails when replay sends more bytes than tolerance allows.
+#
+# replay_asciicast.py recording.cast [--baud N] [--speed F] [--idle S]
+#     [--output replay.cast] [--tolerance PERCENT] -- command [args...]
+
+import argparse
+import codecs
+import fcntl
+import json
+import os
+import select
+import struct
+import subprocess
+import sys
+import termios
+import time
+import tty
+
+
+# Bytes that are not UTF-8 are kept as Latin-1 characters, like library does
+codecs.register_error("latin1", lambda error: (error.object[error.start:error.end].decode("latin-1"), error.end))
+
+
+def load(path):
+    with open(path) as recording:
+        header = json.loads(recording.readline())
+        events = [json.loads(line) for line in recording if line.strip()]
+    return header, [(float(time_s), kind, data) for time_s, kind, data in events]
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+# Time from each input to first output after it and to last output before next input
+def latencies(events):
+    responses = []
+    settles = []
+    inputs = [time_s for time_s, kind, _ in events if kind == "i"]
+    outputs = [time_s for time_s, kind, _ in events if kind == "o"]
+    for index, start in enumerate(inputs):
+        end = inputs[index + 1] if index + 1 < len(inputs) else float("inf")
+        answered = [time_s for time_s in outputs if start <= time_s < end]
+        if answered:
+            responses.append(answered[0] - start)
+            settles.append(answered[-1] - start)
+    return responses, settles
+
+
+# Output that answers input, recording may start after application did
+def output_bytes(events):
+    first_input = next((time_s for time_s, kind, _ in events if kind == "i"), 0.0)
+    return sum(len(data.encode("utf-8")) for time_s, kind, data in events if kind == "o" and time_s >= first_input)
+
+
+def replay(header, events, command, baud, speed, idle):
+    master, slave = os.openpty()
+    # Recorded input is delivered as is, application sets its own modes
+    tty.setraw(slave)
+    fcntl.ioctl(slave, termios.TIOCSWINSZ, struct.pack("HHHH", header["height"], header["width"], 0, 0))
+    environment = dict(os.environ, TERM=header.get("env", {}).get("TERM", "xterm-256color"))
+    process = subprocess.Popen(command, stdin=slave, stdout=slave, stderr=subprocess.DEVNULL,
+                               env=environment, start_new_session=True)
+    os.close(slave)
+
+    inputs = [(time_s / speed, data.encode("utf-8")) for time_s, kind, data in events if kind == "i"]
+    decoder = codecs.getincrementaldecoder("utf-8")("latin1")
+    recorded = []
+    start = time.monotonic()
+    last_output = start
+    received = 0
+    while True:
+        now = time.monotonic() - start
+        while inputs and inputs[0][0] <= now:
+            _, data = inputs.pop(0)
+            os.write(master, data)
+            recorded.append((time.monotonic() - start, "i", data.decode("utf-8", "latin1")))
+
+        # Line of given speed carries ten bits per byte
+        allowed = int(now * baud / 10) - received if baud else 65536
+        timeout = min(inputs[0][0] - now if inputs else idle, 0.01 if baud else idle)
+        ready, _, _ = select.select([master] if allowed > 0 else [], [], [], max(timeout, 0))
+        if ready:
+            try:
+                data = os.read(master, min(allowed, 65536))
+            except OSError:
+                data = b""
+            if not data:
+                break
+            received += len(data)
+            last_output = time.monotonic()
+            recorded.append((last_output - start, "o", decoder.decode(data)))
+        elif not inputs and time.monotonic() - last_output >= idle:
+            break
+
+    process.kill()
+    process.wait()
+    os.close(master)
+    return recorded
+
+
+def write(path, header, events):
+    with open(path, "w") as output:
+        output.write(json.dumps(header) + "\n")
+        for time_s, kind, data in events:
+            output.write(json.dumps([round(time_s, 6), kind, data], ensure_ascii=False) + "\n")
+
+
+def report(name, events):
+    responses, settles = latencies(events)
+    print("%-10s %10d bytes %6d inputs  response p50 %7.1f ms p90 %7.1f ms  settle p50 %7.1f ms p90 %7.1f ms" % (
+        name, output_bytes(events), len(responses),
+        percentile(responses, 0.5) * 1000, percentile(responses, 0.9) * 1000,
+        percentile(settles, 0.5) * 1000, percentile(settles, 0.9) * 1000))
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("recording")
+    parser.add_argument("--baud", type=int, default=0)
+    parser.add_argument("--speed", type=float, default=1.0)
+    parser.add_argument("--idle", type=float, default=1.0)
+    parser.add_argument("--output")
+    parser.add_argument("--tolerance", type=float, default=10.0)
+    options = sys.argv[1:sys.argv.index("--")] if "--" in sys.argv else sys.argv[1:]
+    command = sys.argv[len(options) + 2:]
+    arguments = parser.parse_args(options)
+    if not command:
+        parser.error("command to replay into is missing, give it after --")
+
+    header, events = load(arguments.recording)
+    replayed = replay(header, events, command, arguments.baud, arguments.speed, arguments.idle)
+    if arguments.output:
+        write(arguments.output, header, replayed)
+
+    report("recording", events)
+    report("replay", replayed)
+    if output_bytes(replayed) > output_bytes(events) * (1 + arguments.tolerance / 100):
+        print("replay sends more bytes than recording")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,704 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "description.hpp"
+
+// Generated by scripts/generate_builtin_terminals.py
+
+namespace msos::curses::terminals
+{
+
+constexpr Boolean vt100_booleans[] = {
+    Boolean::auto_right_margin,
+    Boolean::backspaces_with_bs,
+    Boolean::eat_newline_glitch,
+    Boolean::move_standout_mode,
+    Boolean::prtr_silent,
+    Boolean::xon_xoff,
+};
+
+constexpr NumberValue vt100_numbers[] = {
+    {Number::columns, 80},
+    {Number::init_tabs, 8},
+    {Number::lines, 24},
+    {Number::virtual_terminal, 3},
+};
+
+constexpr StringValue vt100_strings[] = {
+    {String::acs_chars, "``aaffggjjkkllmmnnooppqqrrssttuuvvwwxxyyzz{{||}}~~"},
+    {String::bell, "\007"},
+    {String::carriage_return, "\015"},
+    {String::change_scroll_region, "\033[%i%p1%d;%p2%dr"},
+    {String::clear_all_tabs, "\033[3g"},
+    {String::clear_screen, "\033[H\033[J$<50>"},
+    {String::clr_bol, "\033[1K$<3>"},
+    {String::clr_eol, "\033[K$<3>"},
+    {String::clr_eos, "\033[J$<50>"},
+    {String::cursor_address, "\033[%i%p1%d;%p2%dH$<5>"},
+    {String::cursor_down, "\012"},
+    {String::cursor_home, "\033[H"},
+    {String::cursor_left, "\010"},
+    {String::cursor_right, "\033[C$<2>"},
+    {String::cursor_up, "\033[A$<2>"},
+    {String::ena_acs, "\033(B\033)0"},
+    {String::enter_alt_charset_mode, "\016"},
+    {String::enter_am_mode, "\033[?7h"},
+    {String::enter_blink_mode, "\033[5m$<2>"},
+    {String::enter_bold_mode, "\033[1m$<2>"},
+    {String::enter_reverse_mode, "\033[7m$<2>"},
+    {String::enter_standout_mode, "\033[7m$<2>"},
+    {String::enter_underline_mode, "\033[4m$<2>"},
+    {String::exit_alt_charset_mode, "\017"},
+    {String::exit_am_mode, "\033[?7l"},
+    {String::exit_attribute_mode, "\033[m\017$<2>"},
+    {String::exit_standout_mode, "\033[m$<2>"},
+    {String::exit_underline_mode, "\033[m$<2>"},
+    {String::key_a1, "\033Oq"},
+    {String::key_a3, "\033Os"},
+    {String::key_b2, "\033Or"},
+    {String::key_backspace, "\010"},
+    {String::key_c1, "\033Op"},
+    {String::key_c3, "\033On"},
+    {String::key_down, "\033OB"},
+    {String::key_enter, "\033OM"},
+    {String::key_f0, "\033Oy"},
+    {String::key_f1, "\033OP"},
+    {String::key_f10, "\033Ox"},
+    {String::key_f2, "\033OQ"},
+    {String::key_f3, "\033OR"},
+    {String::key_f4, "\033OS"},
+    {String::key_f5, "\033Ot"},
+    {String::key_f6, "\033Ou"},
+    {String::key_f7, "\033Ov"},
+    {String::key_f8, "\033Ol"},
+    {String::key_f9, "\033Ow"},
+    {String::key_left, "\033OD"},
+    {String::key_right, "\033OC"},
+    {String::key_up, "\033OA"},
+    {String::keypad_local, "\033[?1l\033>"},
+    {String::keypad_xmit, "\033[?1h\033="},
+    {String::lab_f1, "pf1"},
+    {String::lab_f2, "pf2"},
+    {String::lab_f3, "pf3"},
+    {String::lab_f4, "pf4"},
+    {String::parm_down_cursor, "\033[%p1%dB"},
+    {String::parm_left_cursor, "\033[%p1%dD"},
+    {String::parm_right_cursor, "\033[%p1%dC"},
+    {String::parm_up_cursor, "\033[%p1%dA"},
+    {String::print_screen, "\033[0i"},
+    {String::prtr_off, "\033[4i"},
+    {String::prtr_on, "\033[5i"},
+    {String::reset_2string, "\033<\033>\033[?3;4;5l\033[?7;8h\033[r"},
+    {String::restore_cursor, "\0338"},
+    {String::save_cursor, "\0337"},
+    {String::scroll_forward, "\012"},
+    {String::scroll_reverse, "\033M$<5>"},
+    {String::set_attributes, "\033[0%?%p1%p6%|%t;1%;%?%p2%t;4%;%?%p1%p3%|%t;7%;%?%p4%t;5%;m%?%p9%t\016%e\017%;$<2>"},
+    {String::set_tab, "\033H"},
+    {String::tab, "\011"},
+    {String::user6, "\033[%i%d;%dR"},
+    {String::user7, "\033[6n"},
+    {String::user8, "\033[?%[;0123456789]c"},
+    {String::user9, "\033Z"},
+};
+
+constexpr Description vt100("vt100|vt100-am|DEC VT100 (w/advanced video)", vt100_booleans, vt100_numbers, vt100_strings);
+
+constexpr Boolean vt220_booleans[] = {
+    Boolean::auto_right_margin,
+    Boolean::backspaces_with_bs,
+    Boolean::eat_newline_glitch,
+    Boolean::move_insert_mode,
+    Boolean::move_standout_mode,
+    Boolean::prtr_silent,
+    Boolean::xon_xoff,
+};
+
+constexpr NumberValue vt220_numbers[] = {
+    {Number::columns, 80},
+    {Number::init_tabs, 8},
+    {Number::lines, 24},
+    {Number::virtual_terminal, 3},
+};
+
+constexpr StringValue vt220_strings[] = {
+    {String::acs_chars, "``aaffggjjkkllmmnnooppqqrrssttuuvvwwxxyyzz{{||}}~~"},
+    {String::bell, "\007"},
+    {String::carriage_return, "\015"},
+    {String::change_scroll_region, "\033[%i%p1%d;%p2%dr"},
+    {String::clear_all_tabs, "\033[3g"},
+    {String::clear_screen, "\033[H\033[J"},
+    {String::clr_bol, "\033[1K"},
+    {String::clr_eol, "\033[K"},
+    {String::clr_eos, "\033[J"},
+    {String::cursor_address, "\033[%i%p1%d;%p2%dH"},
+    {String::cursor_down, "\012"},
+    {String::cursor_home, "\033[H"},
+    {String::cursor_invisible, "\033[?25l"},
+    {String::cursor_left, "\010"},
+    {String::cursor_normal, "\033[?25h"},
+    {String::cursor_right, "\033[C"},
+    {String::cursor_up, "\033[A"},
+    {String::delete_character, "\033[P"},
+    {String::delete_line, "\033[M"},
+    {String::ena_acs, "\033)0"},
+    {String::enter_alt_charset_mode, "\033(0$<2>"},
+    {String::enter_am_mode, "\033[?7h"},
+    {String::enter_blink_mode, "\033[5m"},
+    {String::enter_bold_mode, "\033[1m"},
+    {String::enter_insert_mode, "\033[4h"},
+    {String::enter_reverse_mode, "\033[7m"},
+    {String::enter_standout_mode, "\033[7m"},
+    {String::enter_underline_mode, "\033[4m"},
+    {String::erase_chars, "\033[%p1%dX"},
+    {String::exit_alt_charset_mode, "\033(B$<4>"},
+    {String::exit_am_mode, "\033[?7l"},
+    {String::exit_attribute_mode, "\033[m\033(B"},
+    {String::exit_insert_mode, "\033[4l"},
+    {String::exit_standout_mode, "\033[27m"},
+    {String::exit_underline_mode, "\033[24m"},
+    {String::flash_screen, "\033[?5h$<200/>\033[?5l"},
+    {String::init_2string, "\033[?7h\033[>\033[?1l\033 F\033[?4l"},
+    {String::init_file, "/usr/share/tabset/vt100"},
+    {String::insert_line, "\033[L"},
+    {String::key_backspace, "\010"},
+    {String::key_dc, "\033[3~"},
+    {String::key_down, "\033[B"},
+    {String::key_f1, "\033OP"},
+    {String::key_f10, "\033[21~"},
+    {String::key_f11, "\033[23~"},
+    {String::key_f12, "\033[24~"},
+    {String::key_f13, "\033[25~"},
+    {String::key_f14, "\033[26~"},
+    {String::key_f17, "\033[31~"},
+    {String::key_f18, "\033[32~"},
+    {String::key_f19, "\033[33~"},
+    {String::key_f2, "\033OQ"},
+    {String::key_f20, "\033[34~"},
+    {String::key_f3, "\033OR"},
+    {String::key_f4, "\033OS"},
+    {String::key_f6, "\033[17~"},
+    {String::key_f7, "\033[18~"},
+    {String::key_f8, "\033[19~"},
+    {String::key_f9, "\033[20~"},
+    {String::key_find, "\033[1~"},
+    {String::key_help, "\033[28~"},
+    {String::key_ic, "\033[2~"},
+    {String::key_left, "\033[D"},
+    {String::key_npage, "\033[6~"},
+    {String::key_ppage, "\033[5~"},
+    {String::key_redo, "\033[29~"},
+    {String::key_right, "\033[C"},
+    {String::key_select, "\033[4~"},
+    {String::key_up, "\033[A"},
+    {String::lab_f1, "pf1"},
+    {String::lab_f2, "pf2"},
+    {String::lab_f3, "pf3"},
+    {String::lab_f4, "pf4"},
+    {String::newline, "\033E"},
+    {String::parm_dch, "\033[%p1%dP"},
+    {String::parm_delete_line, "\033[%p1%dM"},
+    {String::parm_down_cursor, "\033[%p1%dB"},
+    {String::parm_ich, "\033[%p1%d@"},
+    {String::parm_insert_line, "\033[%p1%dL"},
+    {String::parm_left_cursor, "\033[%p1%dD"},
+    {String::parm_right_cursor, "\033[%p1%dC"},
+    {String::parm_up_cursor, "\033[%p1%dA"},
+    {String::print_screen, "\033[i"},
+    {String::prtr_off, "\033[4i"},
+    {String::prtr_on, "\033[5i"},
+    {String::reset_1string, "\033[?3l"},
+    {String::restore_cursor, "\0338"},
+    {String::save_cursor, "\0337"},
+    {String::scroll_forward, "\033D"},
+    {String::scroll_reverse, "\033M"},
+    {String::set_attributes, "\033[0%?%p6%t;1%;%?%p2%t;4%;%?%p4%t;5%;%?%p1%p3%|%t;7%;m%?%p9%t\033(0%e\033(B%;$<2>"},
+    {String::set_tab, "\033H"},
+    {String::tab, "\011"},
+    {String::user6, "\033[%i%d;%dR"},
+    {String::user7, "\033[6n"},
+    {String::user8, "\033[?%[;0123456789]c"},
+    {String::user9, "\033[c"},
+};
+
+constexpr Description vt220("vt220|vt200|DEC VT220", vt220_booleans, vt220_numbers, vt220_strings);
+
+constexpr Boolean xterm_256color_booleans[] = {
+    Boolean::auto_right_margin,
+    Boolean::back_color_erase,
+    Boolean::backspaces_with_bs,
+    Boolean::can_change,
+    Boolean::eat_newline_glitch,
+    Boolean::has_meta_key,
+    Boolean::move_insert_mode,
+    Boolean::move_standout_mode,
+    Boolean::no_pad_char,
+    Boolean::prtr_silent,
+};
+
+constexpr NumberValue xterm_256color_numbers[] = {
+    {Number::columns, 80},
+    {Number::init_tabs, 8},
+    {Number::lines, 24},
+    {Number::max_colors, 256},
+    {Number::max_pairs, 65536},
+};
+
+constexpr StringValue xterm_256color_strings[] = {
+    {String::acs_chars, "``aaffggiijjkkllmmnnooppqqrrssttuuvvwwxxyyzz{{||}}~~"},
+    {String::back_tab, "\033[Z"},
+    {String::bell, "\007"},
+    {String::carriage_return, "\015"},
+    {String::change_scroll_region, "\033[%i%p1%d;%p2%dr"},
+    {String::clear_all_tabs, "\033[3g"},
+    {String::clear_margins, "\033[?69l"},
+    {String::clear_screen, "\033[H\033[2J"},
+    {String::clr_bol, "\033[1K"},
+    {String::clr_eol, "\033[K"},
+    {String::clr_eos, "\033[J"},
+    {String::column_address, "\033[%i%p1%dG"},
+    {String::cursor_address, "\033[%i%p1%d;%p2%dH"},
+    {String::cursor_down, "\012"},
+    {String::cursor_home, "\033[H"},
+    {String::cursor_invisible, "\033[?25l"},
+    {String::cursor_left, "\010"},
+    {String::cursor_normal, "\033[?12l\033[?25h"},
+    {String::cursor_right, "\033[C"},
+    {String::cursor_up, "\033[A"},
+    {String::cursor_visible, "\033[?12;25h"},
+    {String::delete_character, "\033[P"},
+    {String::delete_line, "\033[M"},
+    {String::enter_alt_charset_mode, "\033(0"},
+    {String::enter_am_mode, "\033[?7h"},
+    {String::enter_blink_mode, "\033[5m"},
+    {String::enter_bold_mode, "\033[1m"},
+    {String::enter_ca_mode, "\033[?1049h\033[22;0;0t"},
+    {String::enter_dim_mode, "\033[2m"},
+    {String::enter_insert_mode, "\033[4h"},
+    {String::enter_italics_mode, "\033[3m"},
+    {String::enter_reverse_mode, "\033[7m"},
+    {String::enter_secure_mode, "\033[8m"},
+    {String::enter_standout_mode, "\033[7m"},
+    {String::enter_underline_mode, "\033[4m"},
+    {String::erase_chars, "\033[%p1%dX"},
+    {String::exit_alt_charset_mode, "\033(B"},
+    {String::exit_am_mode, "\033[?7l"},
+    {String::exit_attribute_mode, "\033(B\033[m"},
+    {String::exit_ca_mode, "\033[?1049l\033[23;0;0t"},
+    {String::exit_insert_mode, "\033[4l"},
+    {String::exit_italics_mode, "\033[23m"},
+    {String::exit_standout_mode, "\033[27m"},
+    {String::exit_underline_mode, "\033[24m"},
+    {String::flash_screen, "\033[?5h$<100/>\033[?5l"},
+    {String::init_2string, "\033[!p\033[?3;4l\033[4l\033>"},
+    {String::initialize_color, "\033]4;%p1%d;rgb:%p2%{255}%*%{1000}%/%2.2X/%p3%{255}%*%{1000}%/%2.2X/%p4%{255}%*%{1000}%/%2.2X\033\134"},
+    {String::insert_line, "\033[L"},
+    {String::key_a1, "\033Ow"},
+    {String::key_a3, "\033Oy"},
+    {String::key_b2, "\033Ou"},
+    {String::key_backspace, "\177"},
+    {String::key_beg, "\033OE"},
+    {String::key_btab, "\033[Z"},
+    {String::key_c1, "\033Oq"},
+    {String::key_c3, "\033Os"},
+    {String::key_dc, "\033[3~"},
+    {String::key_down, "\033OB"},
+    {String::key_end, "\033OF"},
+    {String::key_enter, "\033OM"},
+    {String::key_f1, "\033OP"},
+    {String::key_f10, "\033[21~"},
+    {String::key_f11, "\033[23~"},
+    {String::key_f12, "\033[24~"},
+    {String::key_f13, "\033[1;2P"},
+    {String::key_f14, "\033[1;2Q"},
+    {String::key_f15, "\033[1;2R"},
+    {String::key_f16, "\033[1;2S"},
+    {String::key_f17, "\033[15;2~"},
+    {String::key_f18, "\033[17;2~"},
+    {String::key_f19, "\033[18;2~"},
+    {String::key_f2, "\033OQ"},
+    {String::key_f20, "\033[19;2~"},
+    {String::key_f21, "\033[20;2~"},
+    {String::key_f22, "\033[21;2~"},
+    {String::key_f23, "\033[23;2~"},
+    {String::key_f24, "\033[24;2~"},
+    {String::key_f25, "\033[1;5P"},
+    {String::key_f26, "\033[1;5Q"},
+    {String::key_f27, "\033[1;5R"},
+    {String::key_f28, "\033[1;5S"},
+    {String::key_f29, "\033[15;5~"},
+    {String::key_f3, "\033OR"},
+    {String::key_f30, "\033[17;5~"},
+    {String::key_f31, "\033[18;5~"},
+    {String::key_f32, "\033[19;5~"},
+    {String::key_f33, "\033[20;5~"},
+    {String::key_f34, "\033[21;5~"},
+    {String::key_f35, "\033[23;5~"},
+    {String::key_f36, "\033[24;5~"},
+    {String::key_f37, "\033[1;6P"},
+    {String::key_f38, "\033[1;6Q"},
+    {String::key_f39, "\033[1;6R"},
+    {String::key_f4, "\033OS"},
+    {String::key_f40, "\033[1;6S"},
+    {String::key_f41, "\033[15;6~"},
+    {String::key_f42, "\033[17;6~"},
+    {String::key_f43, "\033[18;6~"},
+    {String::key_f44, "\033[19;6~"},
+    {String::key_f45, "\033[20;6~"},
+    {String::key_f46, "\033[21;6~"},
+    {String::key_f47, "\033[23;6~"},
+    {String::key_f48, "\033[24;6~"},
+    {String::key_f49, "\033[1;3P"},
+    {String::key_f5, "\033[15~"},
+    {String::key_f50, "\033[1;3Q"},
+    {String::key_f51, "\033[1;3R"},
+    {String::key_f52, "\033[1;3S"},
+    {String::key_f53, "\033[15;3~"},
+    {String::key_f54, "\033[17;3~"},
+    {String::key_f55, "\033[18;3~"},
+    {String::key_f56, "\033[19;3~"},
+    {String::key_f57, "\033[20;3~"},
+    {String::key_f58, "\033[21;3~"},
+    {String::key_f59, "\033[23;3~"},
+    {String::key_f6, "\033[17~"},
+    {String::key_f60, "\033[24;3~"},
+    {String::key_f61, "\033[1;4P"},
+    {String::key_f62, "\033[1;4Q"},
+    {String::key_f63, "\033[1;4R"},
+    {String::key_f7, "\033[18~"},
+    {String::key_f8, "\033[19~"},
+    {String::key_f9, "\033[20~"},
+    {String::key_home, "\033OH"},
+    {String::key_ic, "\033[2~"},
+    {String::key_left, "\033OD"},
+    {String::key_mouse, "\033[<"},
+    {String::key_npage, "\033[6~"},
+    {String::key_ppage, "\033[5~"},
+    {String::key_right, "\033OC"},
+    {String::key_sdc, "\033[3;2~"},
+    {String::key_send, "\033[1;2F"},
+    {String::key_sf, "\033[1;2B"},
+    {String::key_shome, "\033[1;2H"},
+    {String::key_sic, "\033[2;2~"},
+    {String::key_sleft, "\033[1;2D"},
+    {String::key_snext, "\033[6;2~"},
+    {String::key_sprevious, "\033[5;2~"},
+    {String::key_sr, "\033[1;2A"},
+    {String::key_sright, "\033[1;2C"},
+    {String::key_up, "\033OA"},
+    {String::keypad_local, "\033[?1l\033>"},
+    {String::keypad_xmit, "\033[?1h\033="},
+    {String::memory_lock, "\033l"},
+    {String::memory_unlock, "\033m"},
+    {String::meta_off, "\033[?1034l"},
+    {String::meta_on, "\033[?1034h"},
+    {String::newline, "\033E"},
+    {String::orig_colors, "\033]104\007"},
+    {String::orig_pair, "\033[39;49m"},
+    {String::parm_dch, "\033[%p1%dP"},
+    {String::parm_delete_line, "\033[%p1%dM"},
+    {String::parm_down_cursor, "\033[%p1%dB"},
+    {String::parm_ich, "\033[%p1%d@"},
+    {String::parm_index, "\033[%p1%dS"},
+    {String::parm_insert_line, "\033[%p1%dL"},
+    {String::parm_left_cursor, "\033[%p1%dD"},
+    {String::parm_right_cursor, "\033[%p1%dC"},
+    {String::parm_rindex, "\033[%p1%dT"},
+    {String::parm_up_cursor, "\033[%p1%dA"},
+    {String::print_screen, "\033[i"},
+    {String::prtr_off, "\033[4i"},
+    {String::prtr_on, "\033[5i"},
+    {String::repeat_char, "%p1%c\033[%p2%{1}%-%db"},
+    {String::reset_1string, "\033c\033]104\007"},
+    {String::reset_2string, "\033[!p\033[?3;4l\033[4l\033>"},
+    {String::restore_cursor, "\0338"},
+    {String::row_address, "\033[%i%p1%dd"},
+    {String::save_cursor, "\0337"},
+    {String::scroll_forward, "\012"},
+    {String::scroll_reverse, "\033M"},
+    {String::set_a_background, "\033[%?%p1%{8}%<%t4%p1%d%e%p1%{16}%<%t10%p1%{8}%-%d%e48;5;%p1%d%;m"},
+    {String::set_a_foreground, "\033[%?%p1%{8}%<%t3%p1%d%e%p1%{16}%<%t9%p1%{8}%-%d%e38;5;%p1%d%;m"},
+    {String::set_attributes, "%?%p9%t\033(0%e\033(B%;\033[0%?%p6%t;1%;%?%p5%t;2%;%?%p2%t;4%;%?%p1%p3%|%t;7%;%?%p4%t;5%;%?%p7%t;8%;m"},
+    {String::set_left_margin_parm, "\033[?69h\033[%i%p1%ds"},
+    {String::set_lr_margin, "\033[?69h\033[%i%p1%d;%p2%ds"},
+    {String::set_right_margin_parm, "\033[?69h\033[%i;%p1%ds"},
+    {String::set_tab, "\033H"},
+    {String::tab, "\011"},
+    {String::user6, "\033[%i%d;%dR"},
+    {String::user7, "\033[6n"},
+    {String::user8, "\033[?%[;0123456789]c"},
+    {String::user9, "\033[c"},
+};
+
+constexpr Description xterm_256color("xterm-256color|xterm with 256 colors", xterm_256color_booleans, xterm_256color_numbers, xterm_256color_strings);
+
+constexpr Boolean linux_console_booleans[] = {
+    Boolean::auto_right_margin,
+    Boolean::back_color_erase,
+    Boolean::can_change,
+    Boolean::eat_newline_glitch,
+    Boolean::erase_overstrike,
+    Boolean::move_insert_mode,
+    Boolean::move_standout_mode,
+    Boolean::xon_xoff,
+};
+
+constexpr NumberValue linux_console_numbers[] = {
+    {Number::init_tabs, 8},
+    {Number::max_colors, 8},
+    {Number::max_pairs, 64},
+    {Number::no_color_video, 18},
+};
+
+constexpr StringValue linux_console_strings[] = {
+    {String::acs_chars, "++,,--..00``aaffgghhiijjkkllmmnnooppqqrrssttuuvvwwxxyyzz{{||}}~~"},
+    {String::bell, "\007"},
+    {String::carriage_return, "\015"},
+    {String::change_scroll_region, "\033[%i%p1%d;%p2%dr"},
+    {String::clear_all_tabs, "\033[3g"},
+    {String::clear_screen, "\033[H\033[J"},
+    {String::clr_bol, "\033[1K"},
+    {String::clr_eol, "\033[K"},
+    {String::clr_eos, "\033[J"},
+    {String::column_address, "\033[%i%p1%dG"},
+    {String::cursor_address, "\033[%i%p1%d;%p2%dH"},
+    {String::cursor_down, "\012"},
+    {String::cursor_home, "\033[H"},
+    {String::cursor_invisible, "\033[?25l\033[?1c"},
+    {String::cursor_left, "\010"},
+    {String::cursor_normal, "\033[?25h\033[?0c"},
+    {String::cursor_right, "\033[C"},
+    {String::cursor_up, "\033[A"},
+    {String::cursor_visible, "\033[?25h\033[?8c"},
+    {String::delete_character, "\033[P"},
+    {String::delete_line, "\033[M"},
+    {String::ena_acs, "\033)0"},
+    {String::enter_alt_charset_mode, "\016"},
+    {String::enter_am_mode, "\033[?7h"},
+    {String::enter_blink_mode, "\033[5m"},
+    {String::enter_bold_mode, "\033[1m"},
+    {String::enter_dim_mode, "\033[2m"},
+    {String::enter_insert_mode, "\033[4h"},
+    {String::enter_pc_charset_mode, "\033[11m"},
+    {String::enter_reverse_mode, "\033[7m"},
+    {String::enter_standout_mode, "\033[7m"},
+    {String::enter_underline_mode, "\033[4m"},
+    {String::erase_chars, "\033[%p1%dX"},
+    {String::exit_alt_charset_mode, "\017"},
+    {String::exit_am_mode, "\033[?7l"},
+    {String::exit_attribute_mode, "\033[m\017"},
+    {String::exit_insert_mode, "\033[4l"},
+    {String::exit_pc_charset_mode, "\033[10m"},
+    {String::exit_standout_mode, "\033[27m"},
+    {String::exit_underline_mode, "\033[24m"},
+    {String::flash_screen, "\033[?5h$<200/>\033[?5l"},
+    {String::initialize_color, "\033]P%p1%x%p2%{255}%*%{1000}%/%02x%p3%{255}%*%{1000}%/%02x%p4%{255}%*%{1000}%/%02x"},
+    {String::insert_character, "\033[@"},
+    {String::insert_line, "\033[L"},
+    {String::key_b2, "\033[G"},
+    {String::key_backspace, "\177"},
+    {String::key_btab, "\033\011"},
+    {String::key_dc, "\033[3~"},
+    {String::key_down, "\033[B"},
+    {String::key_end, "\033[4~"},
+    {String::key_f1, "\033[[A"},
+    {String::key_f10, "\033[21~"},
+    {String::key_f11, "\033[23~"},
+    {String::key_f12, "\033[24~"},
+    {String::key_f13, "\033[25~"},
+    {String::key_f14, "\033[26~"},
+    {String::key_f15, "\033[28~"},
+    {String::key_f16, "\033[29~"},
+    {String::key_f17, "\033[31~"},
+    {String::key_f18, "\033[32~"},
+    {String::key_f19, "\033[33~"},
+    {String::key_f2, "\033[[B"},
+    {String::key_f20, "\033[34~"},
+    {String::key_f3, "\033[[C"},
+    {String::key_f4, "\033[[D"},
+    {String::key_f5, "\033[[E"},
+    {String::key_f6, "\033[17~"},
+    {String::key_f7, "\033[18~"},
+    {String::key_f8, "\033[19~"},
+    {String::key_f9, "\033[20~"},
+    {String::key_home, "\033[1~"},
+    {String::key_ic, "\033[2~"},
+    {String::key_left, "\033[D"},
+    {String::key_mouse, "\033[M"},
+    {String::key_npage, "\033[6~"},
+    {String::key_ppage, "\033[5~"},
+    {String::key_right, "\033[C"},
+    {String::key_suspend, "\032"},
+    {String::key_up, "\033[A"},
+    {String::newline, "\015\012"},
+    {String::orig_colors, "\033]R"},
+    {String::orig_pair, "\033[39;49m"},
+    {String::parm_dch, "\033[%p1%dP"},
+    {String::parm_delete_line, "\033[%p1%dM"},
+    {String::parm_down_cursor, "\033[%p1%dB"},
+    {String::parm_ich, "\033[%p1%d@"},
+    {String::parm_insert_line, "\033[%p1%dL"},
+    {String::parm_left_cursor, "\033[%p1%dD"},
+    {String::parm_right_cursor, "\033[%p1%dC"},
+    {String::parm_up_cursor, "\033[%p1%dA"},
+    {String::reset_1string, "\033c\033]R"},
+    {String::restore_cursor, "\0338"},
+    {String::row_address, "\033[%i%p1%dd"},
+    {String::save_cursor, "\0337"},
+    {String::scroll_forward, "\012"},
+    {String::scroll_reverse, "\033M"},
+    {String::set_a_background, "\033[4%p1%dm"},
+    {String::set_a_foreground, "\033[3%p1%dm"},
+    {String::set_attributes, "\033[0;10%?%p1%t;7%;%?%p2%t;4%;%?%p3%t;7%;%?%p4%t;5%;%?%p5%t;2%;%?%p6%t;1%;m%?%p9%t\016%e\017%;"},
+    {String::set_tab, "\033H"},
+    {String::tab, "\011"},
+    {String::user6, "\033[%i%d;%dR"},
+    {String::user7, "\033[6n"},
+    {String::user8, "\033[?6c"},
+    {String::user9, "\033[c"},
+};
+
+constexpr Description linux_console("linux|Linux console", linux_console_booleans, linux_console_numbers, linux_console_strings);
+
+constexpr Boolean screen_booleans[] = {
+    Boolean::auto_right_margin,
+    Boolean::backspaces_with_bs,
+    Boolean::eat_newline_glitch,
+    Boolean::has_hardware_tabs,
+    Boolean::has_meta_key,
+    Boolean::move_insert_mode,
+    Boolean::move_standout_mode,
+};
+
+constexpr NumberValue screen_numbers[] = {
+    {Number::columns, 80},
+    {Number::init_tabs, 8},
+    {Number::lines, 24},
+    {Number::max_colors, 8},
+    {Number::max_pairs, 64},
+};
+
+constexpr StringValue screen_strings[] = {
+    {String::acs_chars, "++,,--..00``aaffgghhiijjkkllmmnnooppqqrrssttuuvvwwxxyyzz{{||}}~~"},
+    {String::back_tab, "\033[Z"},
+    {String::bell, "\007"},
+    {String::carriage_return, "\015"},
+    {String::change_scroll_region, "\033[%i%p1%d;%p2%dr"},
+    {String::clear_all_tabs, "\033[3g"},
+    {String::clear_screen, "\033[H\033[J"},
+    {String::clr_bol, "\033[1K"},
+    {String::clr_eol, "\033[K"},
+    {String::clr_eos, "\033[J"},
+    {String::column_address, "\033[%i%p1%dG"},
+    {String::cursor_address, "\033[%i%p1%d;%p2%dH"},
+    {String::cursor_down, "\012"},
+    {String::cursor_home, "\033[H"},
+    {String::cursor_invisible, "\033[?25l"},
+    {String::cursor_left, "\010"},
+    {String::cursor_normal, "\033[34h\033[?25h"},
+    {String::cursor_right, "\033[C"},
+    {String::cursor_up, "\033M"},
+    {String::cursor_visible, "\033[34l"},
+    {String::delete_character, "\033[P"},
+    {String::delete_line, "\033[M"},
+    {String::ena_acs, "\033(B\033)0"},
+    {String::enter_alt_charset_mode, "\016"},
+    {String::enter_blink_mode, "\033[5m"},
+    {String::enter_bold_mode, "\033[1m"},
+    {String::enter_ca_mode, "\033[?1049h"},
+    {String::enter_dim_mode, "\033[2m"},
+    {String::enter_insert_mode, "\033[4h"},
+    {String::enter_reverse_mode, "\033[7m"},
+    {String::enter_standout_mode, "\033[3m"},
+    {String::enter_underline_mode, "\033[4m"},
+    {String::exit_alt_charset_mode, "\017"},
+    {String::exit_attribute_mode, "\033[m\017"},
+    {String::exit_ca_mode, "\033[?1049l"},
+    {String::exit_insert_mode, "\033[4l"},
+    {String::exit_standout_mode, "\033[23m"},
+    {String::exit_underline_mode, "\033[24m"},
+    {String::flash_screen, "\033g"},
+    {String::init_2string, "\033)0"},
+    {String::insert_line, "\033[L"},
+    {String::key_backspace, "\177"},
+    {String::key_btab, "\033[Z"},
+    {String::key_dc, "\033[3~"},
+    {String::key_down, "\033OB"},
+    {String::key_end, "\033[4~"},
+    {String::key_f1, "\033OP"},
+    {String::key_f10, "\033[21~"},
+    {String::key_f11, "\033[23~"},
+    {String::key_f12, "\033[24~"},
+    {String::key_f2, "\033OQ"},
+    {String::key_f3, "\033OR"},
+    {String::key_f4, "\033OS"},
+    {String::key_f5, "\033[15~"},
+    {String::key_f6, "\033[17~"},
+    {String::key_f7, "\033[18~"},
+    {String::key_f8, "\033[19~"},
+    {String::key_f9, "\033[20~"},
+    {String::key_home, "\033[1~"},
+    {String::key_ic, "\033[2~"},
+    {String::key_left, "\033OD"},
+    {String::key_mouse, "\033[M"},
+    {String::key_npage, "\033[6~"},
+    {String::key_ppage, "\033[5~"},
+    {String::key_right, "\033OC"},
+    {String::key_up, "\033OA"},
+    {String::keypad_local, "\033[?1l\033>"},
+    {String::keypad_xmit, "\033[?1h\033="},
+    {String::newline, "\033E"},
+    {String::orig_pair, "\033[39;49m"},
+    {String::parm_dch, "\033[%p1%dP"},
+    {String::parm_delete_line, "\033[%p1%dM"},
+    {String::parm_down_cursor, "\033[%p1%dB"},
+    {String::parm_ich, "\033[%p1%d@"},
+    {String::parm_index, "\033[%p1%dS"},
+    {String::parm_insert_line, "\033[%p1%dL"},
+    {String::parm_left_cursor, "\033[%p1%dD"},
+    {String::parm_right_cursor, "\033[%p1%dC"},
+    {String::parm_rindex, "\033[%p1%dT"},
+    {String::parm_up_cursor, "\033[%p1%dA"},
+    {String::reset_2string, "\033c\033[?1000l\033[?25h"},
+    {String::restore_cursor, "\0338"},
+    {String::row_address, "\033[%i%p1%dd"},
+    {String::save_cursor, "\0337"},
+    {String::scroll_forward, "\012"},
+    {String::scroll_reverse, "\033M"},
+    {String::set_a_background, "\033[4%p1%dm"},
+    {String::set_a_foreground, "\033[3%p1%dm"},
+    {String::set_attributes, "\033[0%?%p6%t;1%;%?%p1%t;3%;%?%p2%t;4%;%?%p3%t;7%;%?%p4%t;5%;%?%p5%t;2%;m%?%p9%t\016%e\017%;"},
+    {String::set_tab, "\033H"},
+    {String::tab, "\011"},
+    {String::user6, "\033[%i%d;%dR"},
+    {String::user7, "\033[6n"},
+    {String::user8, "\033[?1;2c"},
+    {String::user9, "\033[c"},
+};
+
+constexpr Description screen("screen|VT 100/ANSI X3.64 virtual terminal", screen_booleans, screen_numbers, screen_strings);
+
+constexpr const Description* all[] = {
+    &vt100,
+    &vt220,
+    &xterm_256color,
+    &linux_console,
+    &screen,
+};
+
+} // namespace msos::curses::terminals
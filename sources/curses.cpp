@@ -14,10 +14,21 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
 #include <cstddef>
 #include <unistd.h>
 #include <stdarg.h>
+#include <cstdlib>
 #include <cstring>
+#include <cstdio>
+#include <iterator>
+#include <new>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
 
 #include "curses.h"
 
@@ -27,11 +38,43 @@
 
 #include "msos/usart_printer.hpp"
 
+#include "color.hpp"
+#include "input.hpp"
+#include "line_speed.hpp"
+#include "palette.hpp"
+#include "parameterized_string.hpp"
+#include "probe.hpp"
+#include "recorder.hpp"
+#include "reflow.hpp"
+#include "renderer.hpp"
+#include "ring_buffer.hpp"
+#include "screen.hpp"
+#include "sgr_cache.hpp"
+#include "stats.hpp"
+#include "terminfo.hpp"
+#include "unicode.hpp"
+
+// Wait for probe replies when use_terminal_probe is given negative timeout
+#ifndef PROBE_TIMEOUT
+    #define PROBE_TIMEOUT 100
+#endif // PROBE_TIMEOUT
+
+int ESCDELAY = 100;
+// Termcap globals, set by setupterm for current terminal
+char PC = 0;
+char* UP = nullptr;
+char* BC = nullptr;
+short ospeed = 0;
+
 namespace
 {
-WINDOW window;
 static UsartWriter writer;
 
+SCREEN screens[MAX_SCREENS];
+bool screen_used[MAX_SCREENS];
+// Used by all functions without SCREEN argument
+SCREEN* screen = &screens[0];
+
 constexpr const char* bold = "\033[1m";
 constexpr const char* underline = "\033[4m";
 constexpr const char* reverse = "\033[7m";
@@ -54,318 +97,2499 @@ constexpr const char* bgcolor_reset = "\033[0m";
     // Background Cyan: \u001b[46m
     // Background White: \u001b[47m
 
-struct Color
-{
-    short fg;
-    short bg;
-};
-
-Color colors[COLOR_PAIRS];
+msos::curses::ParameterizedStringCache parameterized_strings;
+bool probe_enabled = false;
+int probe_timeout = PROBE_TIMEOUT;
 
-chtype buffer[24*80]; // TODO: malloc considered
 
+void write_output(const char* data, std::size_t size)
+{
+    screen->stats.syscalls(screen->sink.system_writes() ? 1 : 0);
+    if (screen->sink.write(data, size) != size)
+    {
+        screen->repaint = true;
+    }
 }
 
-int waddch(WINDOW* win, const chtype ch)
+void emit(const char* data, std::size_t size)
 {
-    if (win == nullptr)
+    screen->stats.output(size);
+    screen->recorder.record(msos::curses::Recorder::Event::output, data, size);
+    if (screen->evloop_mode)
     {
-        return ERR;
+        if (screen->output.push(data, size) != size)
+        {
+            screen->repaint = true;
+        }
+        return;
     }
+    write_output(data, size);
+}
 
-    int last_char = win->max_x * win->max_y - 1;
-    int requested_char = win->cursor_x + win->max_x * win->cursor_y;
-    // TODO: support for line scrolling
-    if (requested_char > last_char)
+void emit(const char* str)
+{
+    emit(str, std::strlen(str));
+}
+
+void flush_output()
+{
+    if (!screen->evloop_mode)
     {
-        return ERR;
+        screen->stats.syscalls(screen->sink.system_flushes() ? 1 : 0);
+        screen->sink.flush();
     }
-    if (win->cursor_x < win->max_x - 1)
+}
+
+bool wait_for_input(int timeout_ms)
+{
+    struct pollfd fd = {
+        .fd = screen->input_fd,
+        .events = POLLIN,
+        .revents = 0
+    };
+    screen->stats.syscalls(1);
+    return poll(&fd, 1, timeout_ms) > 0;
+}
+
+void set_mouse_tracking(mmask_t old_mask, mmask_t new_mask)
+{
+    const bool was_tracking_motion = old_mask & REPORT_MOUSE_POSITION;
+    const bool tracks_motion = new_mask & REPORT_MOUSE_POSITION;
+    if (old_mask && (!new_mask || was_tracking_motion != tracks_motion))
     {
-        ++win->cursor_x;
+        emit(was_tracking_motion ? "\033[?1003l\033[?1006l" : "\033[?1000l\033[?1006l");
     }
-    else
+    if (new_mask && (!old_mask || was_tracking_motion != tracks_motion))
     {
-        ++win->cursor_y;
-        win->cursor_x = 0;
+        emit(tracks_motion ? "\033[?1003h\033[?1006h" : "\033[?1000h\033[?1006h");
     }
-    win->screen_buffer[requested_char] = ch;
-
-    return OK;
 }
 
-int mvwaddch(WINDOW* win, int y, int x, const chtype ch)
+void emit_padding(std::size_t count)
 {
-    return wmove(win, y, x) == OK? waddch(win, ch) : ERR;
+    char pads[16];
+    std::memset(pads, screen->line_speed.pad, sizeof(pads));
+    for (std::size_t sent = 0; sent < count; sent += sizeof(pads))
+    {
+        emit(pads, std::min(sizeof(pads), count - sent));
+    }
 }
 
-int waddchstr(WINDOW *win, const chtype *chstr)
+// Returns number of bytes emitted, pad characters included
+std::size_t emit_capability(const char* str)
 {
-    if (win == nullptr)
-    {
-        return ERR;
-    }
-    int size_to_copy = win->max_x - win->cursor_x;
-    int buffer_position = win->cursor_x + win->max_x * win->cursor_y;
-    for (int i = 0; i < size_to_copy; ++i)
+    std::size_t emitted = 0;
+    if (str == nullptr)
     {
-        if ((chstr[i] & A_CHARTEXT) == 0)
-        {
-            return OK;
-        }
-        win->screen_buffer[buffer_position + i] = chstr[i];
+        return emitted;
     }
-    return OK;
+    const auto output = [&emitted](const char* data, std::size_t size) {
+        emit(data, size);
+        emitted += size;
+    };
+    msos::curses::split_padding(str, 1, output, [&emitted](int tenths, bool mandatory) {
+        const std::size_t count = screen->line_speed.padding_count(tenths, mandatory);
+        emit_padding(count);
+        emitted += count;
+    });
+    return emitted;
 }
 
-// int mvwaddchstr(WINDOW *win, int y, int x, const chtype *chstr)
-// {
+// Speed of line from termios of output, padding rules from terminal
+void read_line_speed(int fd)
+{
+    using msos::curses::Boolean;
+    struct termios line = {};
+    const bool reported = tcgetattr(fd, &line) == 0;
+    const int rate = reported ? msos::curses::baudrate_of(cfgetospeed(&line)) : 0;
+    ospeed = static_cast<short>(rate != 0 ? cfgetospeed(&line) : 0);
 
-// }
+    msos::curses::LineSpeed& speed = screen->line_speed;
+    speed = msos::curses::LineSpeed();
+    speed.known = rate != 0;
+    speed.baudrate = speed.known ? rate : CURSES_BAUDRATE;
+    const int padding_rate = screen->terminfo.number(msos::curses::Number::padding_baud_rate);
+    speed.padding = speed.known && (padding_rate <= 0 || speed.baudrate >= padding_rate);
+    speed.flow_control = screen->terminfo.flag(Boolean::xon_xoff);
+    speed.pad_character = !screen->terminfo.flag(Boolean::no_pad_char);
+    const char* pad = screen->terminfo.string(msos::curses::String::pad_char);
+    speed.pad = pad != nullptr ? pad[0] : 0;
 
+    PC = speed.pad;
+    UP = const_cast<char*>(screen->terminfo.string(msos::curses::String::cursor_up));
+    BC = const_cast<char*>(screen->terminfo.string(msos::curses::String::cursor_left));
+}
 
-WINDOW* stdscr = nullptr;
+// Sequence of curs_set visibility, nullptr when terminal has none
+const char* visibility_sequence(int visibility)
+{
+    using msos::curses::String;
+    constexpr String sequences[] = {String::cursor_invisible, String::cursor_normal, String::cursor_visible};
+    return screen->terminfo.string(sequences[visibility]);
+}
 
-int wmove(WINDOW *win, int y, int x)
+// Passes strings of loaded terminal to output, missing ones keep defaults
+void apply_terminfo()
 {
-    if (y >= win->max_y || x >= win->max_x)
+    using msos::curses::String;
+    screen->clear_screen = screen->terminfo.string(String::clear_screen);
+    if (screen->clear_screen == nullptr)
     {
-        return ERR;
+        screen->clear_screen = "\033[H\033[J";
     }
 
-    win->cursor_x = static_cast<short>(x);
-    win->cursor_y = static_cast<short>(y);
+    screen->renderer.set_line_speed(screen->line_speed);
+    msos::curses::Renderer::Sequences sequences;
+    sequences.carriage_return = screen->terminfo.string(String::carriage_return);
+    sequences.cursor_left = screen->terminfo.string(String::cursor_left);
+    sequences.cursor_down = screen->terminfo.string(String::cursor_down);
+    sequences.clr_eol = screen->terminfo.string(String::clr_eol);
+    sequences.clr_eos = screen->terminfo.string(String::clr_eos);
+    sequences.enter_alt_charset_mode = screen->terminfo.string(String::enter_alt_charset_mode);
+    sequences.exit_alt_charset_mode = screen->terminfo.string(String::exit_alt_charset_mode);
+    sequences.cursor_address = screen->terminfo.string(String::cursor_address);
+    sequences.cursor_invisible = screen->terminfo.string(String::cursor_invisible);
+    sequences.cursor_normal = screen->terminfo.string(String::cursor_normal);
+    screen->renderer.set_sequences(sequences);
+    parameterized_strings.clear();
 
-    return OK;
+    // Optimized encodings are used only in forms known to renderer
+    const auto same = [](const char* value, const char* expected) {
+        return value != nullptr && std::strcmp(value, expected) == 0;
+    };
+    bool known = false;
+    screen->features = msos::curses::TerminalFeatures();
+    screen->features.repeat_character = same(screen->terminfo.string(String::repeat_char), "%p1%c\033[%p2%{1}%-%db");
+    screen->features.erase_characters = same(screen->terminfo.string(String::erase_chars), "\033[%p1%dX");
+    screen->features.scroll_region = same(screen->terminfo.string(String::change_scroll_region), "\033[%i%p1%d;%p2%dr");
+    screen->features.synchronized_output = screen->terminfo.string("Sync", &known) != nullptr;
+    screen->renderer.set_repeat_character(screen->features.repeat_character);
+    screen->renderer.set_erase_characters(screen->features.erase_characters);
+    screen->renderer.set_synchronized_output(screen->features.synchronized_output);
 }
 
-int move(int y, int x)
+int elapsed_ms(const struct timespec& start)
 {
-    return wmove(stdscr, y, x);
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int>((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
 }
 
-int clear()
+// Sends queries and reads replies until primary Device Attributes arrive
+// or timeout passes. Features terminal confirms are added to terminfo ones;
+// when it answered every query, its answers for encodings renderer uses win.
+void probe_terminal(int timeout_ms)
 {
-    printf("\033[H\033[J");
-    return 0;
+    struct termios saved;
+    tcgetattr(screen->input_fd, &saved);
+    struct termios replies = saved;
+    replies.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+    replies.c_cc[VMIN] = 0;
+    replies.c_cc[VTIME] = 0;
+    tcsetattr(screen->input_fd, TCSANOW, &replies);
+
+    emit(msos::curses::TerminalProbe::query());
+    flush_output();
+
+    // Keys typed meanwhile are kept for wgetch
+    const msos::curses::TerminalProbe::Forward forward = [](const char* data, std::size_t size) {
+        static_cast<void>(screen->input.push(data, size));
+    };
+    msos::curses::TerminalProbe probe;
+    struct timespec start = {};
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int remaining = timeout_ms;
+    while (!probe.complete() && remaining > 0 && wait_for_input(remaining))
+    {
+        char data[64];
+        const ssize_t size = read(screen->input_fd, data, sizeof(data));
+        screen->stats.syscalls(1);
+        if (size <= 0)
+        {
+            break;
+        }
+        screen->stats.input(static_cast<std::size_t>(size));
+        screen->recorder.record(msos::curses::Recorder::Event::input, data, static_cast<std::size_t>(size));
+        probe.push(data, static_cast<std::size_t>(size), forward);
+        remaining = timeout_ms - elapsed_ms(start);
+    }
+    probe.finish(forward);
+    tcsetattr(screen->input_fd, TCSANOW, &saved);
+
+    const msos::curses::TerminalFeatures& found = probe.features();
+    const bool answered = probe.complete();
+    msos::curses::TerminalFeatures& features = screen->features;
+    features.repeat_character = found.repeat_character || (!answered && features.repeat_character);
+    features.erase_characters = found.erase_characters || (!answered && features.erase_characters);
+    features.scroll_region = features.scroll_region || found.scroll_region;
+    features.direct_color = features.direct_color || found.direct_color;
+    features.synchronized_output = found.synchronized_output || (!answered && features.synchronized_output);
+    screen->renderer.set_repeat_character(screen->features.repeat_character);
+    screen->renderer.set_erase_characters(screen->features.erase_characters);
+    screen->renderer.set_synchronized_output(screen->features.synchronized_output);
+    screen->renderer.invalidate();
 }
 
-WINDOW* initscr()
+msos::curses::ColorMode terminal_color_mode()
 {
-    std::memset(&window, 0, sizeof(window));
-    window.screen_buffer = buffer;
-    stdscr = &window;
-    clear();
-    move(0, 0);
-    std::memset(&colors, -1, sizeof(colors));
-    fflush(stdout);
-    struct winsize w;
-    ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
-    window.max_x = w.ws_col;
-    window.max_y = w.ws_row;
+    using msos::curses::ColorMode;
+    const char* colorterm = std::getenv("COLORTERM");
+    if (screen->features.direct_color)
+    {
+        return ColorMode::direct;
+    }
+    if (!screen->terminfo.loaded())
+    {
+        return msos::curses::detect_color_mode(screen->terminal_name, colorterm);
+    }
 
-    return &window;
+    const int max_colors = screen->terminfo.number(msos::curses::Number::max_colors);
+    if (screen->terminfo.flag("RGB") > 0 || max_colors >= 0x1000000
+        || msos::curses::detect_color_mode(nullptr, colorterm) == ColorMode::direct)
+    {
+        return ColorMode::direct;
+    }
+    if (max_colors >= 256)
+    {
+        return ColorMode::indexed;
+    }
+    return max_colors >= 16 ? ColorMode::bright : ColorMode::basic;
 }
 
-int endwin()
+bool terminal_background_erase()
 {
-    echo();
-    printf(nobold);
-    attroff(COLOR_PAIR(1));
-    fflush(stdout);
-    return OK;
+    return screen->terminfo.loaded() ? screen->terminfo.flag(msos::curses::Boolean::back_color_erase)
+                                     : msos::curses::detect_background_erase(screen->terminal_name);
 }
 
-int getmaxx(WINDOW* window)
-{
-    return window->max_x;
 }
 
-int getmaxy(WINDOW* window)
+namespace
 {
-    return window->max_y;
-}
 
-// PRINTERS //
+constexpr unsigned color_bits = 0xf000;
+constexpr unsigned rendition_bits = 0x0f00;
 
-int printw(const char *str, ...)
+// Merges window attributes and background into character. Color from
+// character wins over window one, which wins over background one.
+chtype render_char(const WINDOW* win, chtype ch)
 {
-    va_list arg;
-    va_start (arg, str);
-    int done = __vfprintf_(writer, 1, str, arg, 0);
-    va_end (arg);
-    return done;
+    const unsigned background = static_cast<unsigned short>(win->background);
+    unsigned attributes = static_cast<unsigned>(static_cast<unsigned char>(win->attributes)) << A_ATTRIBUTES_OFFSET;
+    unsigned cell = static_cast<unsigned short>(ch);
+    if ((cell & A_CHARTEXT) == ' ' && (background & A_CHARTEXT) != 0)
+    {
+        cell = (cell & ~static_cast<unsigned>(A_CHARTEXT)) | (background & A_CHARTEXT);
+    }
+    if (cell & color_bits)
+    {
+        attributes &= ~color_bits;
+    }
+    if ((cell | attributes) & color_bits)
+    {
+        attributes |= background & rendition_bits;
+    }
+    else
+    {
+        attributes |= background & (rendition_bits | color_bits);
+    }
+    return static_cast<chtype>(cell | attributes);
 }
 
-int mvprintw(int row, int column, const char *str, ...)
+std::uint32_t cell_text(const WINDOW* win, int index)
 {
-    move(column, row);
-    va_list arg;
-    va_start (arg, str);
-    int done = __vfprintf_(writer, 1, str, arg, 0);
-    va_end (arg);
-    return done;
+    return win->wide_buffer != nullptr ? static_cast<std::uint32_t>(win->wide_buffer[index]) : 0;
 }
 
-int refresh(void)
+void blank_cell(WINDOW* win, int index)
 {
-    fflush(stdout);
-    return 0;
+    const unsigned attributes = static_cast<unsigned short>(win->screen_buffer[index]) & 0xff00u;
+    win->screen_buffer[index] = static_cast<chtype>(attributes | ' ');
+    win->wide_buffer[index] = 0;
 }
 
-int noecho(void)
+// Overwriting any half of double width character blanks the other one
+void put_cell(WINDOW* win, int index, chtype cell, std::uint32_t text)
 {
-    struct termios tattr;
+    if (win->wide_buffer != nullptr)
+    {
+        const int column = index % win->max_x;
+        if (column > 0 && cell_text(win, index) == msos::curses::cell_continuation)
+        {
+            blank_cell(win, index - 1);
+        }
+        if (column + 1 < win->max_x && cell_text(win, index + 1) == msos::curses::cell_continuation)
+        {
+            blank_cell(win, index + 1);
+        }
+        win->wide_buffer[index] = static_cast<wchar_t>(text);
+    }
+    win->screen_buffer[index] = cell;
+}
 
-    tcgetattr (STDIN_FILENO, &tattr);
-    tattr.c_lflag &= ~(ICANON | ECHO);
-    tattr.c_cc[VMIN] = 1;
-    tattr.c_cc[VTIME] = 0;
-    tcsetattr (STDIN_FILENO, TCSANOW, &tattr);
-    return 0;
+void advance_cursor(WINDOW* win)
+{
+    if (win->cursor_x < win->max_x - 1)
+    {
+        ++win->cursor_x;
+    }
+    else
+    {
+        ++win->cursor_y;
+        win->cursor_x = 0;
+    }
 }
 
-int echo(void)
+// Attaches combining mark to character before cursor
+int combine(WINDOW* win, char32_t mark)
 {
-    struct termios tattr;
+    int index = win->cursor_x + win->max_x * win->cursor_y - 1;
+    if (index >= 0 && cell_text(win, index) == msos::curses::cell_continuation)
+    {
+        --index;
+    }
+    if (index < 0 || win->wide_buffer == nullptr
+        || mark < msos::curses::combining_first || mark > msos::curses::combining_last)
+    {
+        // Only diacritical marks block fits into cell, others are dropped
+        return OK;
+    }
 
-    tcgetattr (STDIN_FILENO, &tattr);
-    tattr.c_lflag |= ECHO;
-    tcsetattr (STDIN_FILENO, TCSANOW, &tattr);
-    return 0;
+    std::uint32_t text = cell_text(win, index);
+    if (text == 0)
+    {
+        text = static_cast<unsigned short>(win->screen_buffer[index]) & A_CHARTEXT;
+        text = text != 0 ? text : ' ';
+    }
+    if ((text >> msos::curses::cell_combining_offset) == 0)
+    {
+        text |= (mark - msos::curses::combining_first + 1) << msos::curses::cell_combining_offset;
+        win->wide_buffer[index] = static_cast<wchar_t>(text);
+    }
+    return OK;
 }
 
-// INPUT
-int getch(void)
+int add_character(WINDOW* win, char32_t c, chtype attributes)
 {
-    char buffer;
-    while (!read(STDIN_FILENO, &buffer, 1));
-    return buffer;
-}
+    if (c < 0x80)
+    {
+        return waddch(win, static_cast<chtype>(static_cast<unsigned short>(attributes) | c));
+    }
 
-//-------------------------------------------//
-//------         ATTRIBUTES           -------//
-//-------------------------------------------//
+    const int width = msos::curses::character_width(c);
+    if (width == 0)
+    {
+        return combine(win, c);
+    }
+    if (width < 0)
+    {
+        return ERR;
+    }
+    if (win->wide_buffer == nullptr)
+    {
+        return waddch(win, static_cast<chtype>(static_cast<unsigned short>(attributes) | '?'));
+    }
+    if (width == 2 && win->cursor_x == win->max_x - 1)
+    {
+        // Does not fit in the line, continue in next one like terminal does
+        if (waddch(win, static_cast<chtype>(static_cast<unsigned short>(attributes) | ' ')) == ERR)
+        {
+            return ERR;
+        }
+    }
 
-int wattroff(WINDOW* win, int attrs)
-{
-    if (win == nullptr)
+    const int index = win->cursor_x + win->max_x * win->cursor_y;
+    if (index + width > win->max_x * win->max_y)
     {
         return ERR;
     }
-    win->attributes &= static_cast<char>(~attrs);
+
+    const chtype cell = render_char(win, static_cast<chtype>(static_cast<unsigned short>(attributes) & 0xff00u));
+    put_cell(win, index, cell, c);
+    advance_cursor(win);
+    if (width == 2)
+    {
+        put_cell(win, index + 1, cell, msos::curses::cell_continuation);
+        advance_cursor(win);
+    }
     return OK;
 }
 
-int wattron(WINDOW* win, int attrs)
+}
+
+int waddch(WINDOW* win, const chtype ch)
 {
     if (win == nullptr)
     {
         return ERR;
     }
 
-    if (attrs & A_COLOR_MASK)
+    int last_char = win->max_x * win->max_y - 1;
+    int requested_char = win->cursor_x + win->max_x * win->cursor_y;
+    // TODO: support for line scrolling
+    if (requested_char > last_char)
     {
-        win->attributes &= static_cast<char>(~A_COLOR_MASK);
+        return ERR;
     }
-    win->attributes |= static_cast<char>(attrs);
+    advance_cursor(win);
+    put_cell(win, requested_char, render_char(win, ch), 0);
+
     return OK;
 }
 
-int wattrset(WINDOW* win, int attrs)
+int mvwaddch(WINDOW* win, int y, int x, const chtype ch)
+{
+    return wmove(win, y, x) == OK? waddch(win, ch) : ERR;
+}
+
+int waddchstr(WINDOW *win, const chtype *chstr)
 {
     if (win == nullptr)
     {
         return ERR;
     }
-
-    win->attributes = static_cast<char>(attrs);
+    int size_to_copy = win->max_x - win->cursor_x;
+    int buffer_position = win->cursor_x + win->max_x * win->cursor_y;
+    for (int i = 0; i < size_to_copy; ++i)
+    {
+        if ((chstr[i] & A_CHARTEXT) == 0)
+        {
+            return OK;
+        }
+        put_cell(win, buffer_position + i, chstr[i], 0);
+    }
     return OK;
 }
 
-int wcolor_set(WINDOW* win, short color_pair_number, void* opts)
+int waddnstr(WINDOW* win, const char* str, int n)
 {
-    static_cast<void>(opts);
-    if (win == nullptr)
+    if (win == nullptr || str == nullptr)
     {
         return ERR;
     }
 
-    if (color_pair_number < 1 || color_pair_number > COLOR_PAIRS - 1)
+    const std::size_t size = n < 0 ? std::strlen(str) : strnlen(str, static_cast<std::size_t>(n));
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(str);
+    std::size_t i = 0;
+    while (i < size)
     {
-        return ERR;
-    }
+        std::size_t length = msos::curses::utf8_length(data[i]);
+        char32_t c = msos::curses::replacement_character;
+        if (length == 0 || i + length > size)
+        {
+            length = 1;
+        }
+        else
+        {
+            c = msos::curses::utf8_decode(data + i, length);
+        }
 
-    win->attributes &= static_cast<char>(~A_COLOR_MASK);
-    win->attributes |= static_cast<char>((color_pair_number << A_COLOR_OFFSET));
+        if (add_character(win, c, 0) == ERR)
+        {
+            return ERR;
+        }
+        i += length;
+    }
     return OK;
 }
 
-int raw()
+int waddstr(WINDOW* win, const char* str)
 {
-    return 0;
+    return waddnstr(win, str, -1);
 }
 
-int noraw()
+int addstr(const char* str)
 {
-    return 0;
+    return waddnstr(stdscr, str, -1);
 }
 
-int keypad(WINDOW* window, bool bf)
+int addnstr(const char* str, int n)
 {
-    window->key_translation = bf;
-    return 0;
+    return waddnstr(stdscr, str, n);
 }
 
-int getstr_(char* str, int size)
+int mvwaddnstr(WINDOW* win, int y, int x, const char* str, int n)
 {
-    return fgets(str, size, stdin) == nullptr ? ERR : OK;
+    return wmove(win, y, x) == OK ? waddnstr(win, str, n) : ERR;
 }
 
-//-------------------------------------------//
-//------           COLORS             -------//
-//-------------------------------------------//
+int mvwaddstr(WINDOW* win, int y, int x, const char* str)
+{
+    return mvwaddnstr(win, y, x, str, -1);
+}
 
-int start_color(void)
+int mvaddstr(int y, int x, const char* str)
 {
-    // TODO: initialize default
-    return 0;
+    return mvwaddnstr(stdscr, y, x, str, -1);
 }
 
-int init_pair(short id, short fg, short bg)
+int mvaddnstr(int y, int x, const char* str, int n)
+{
+    return mvwaddnstr(stdscr, y, x, str, n);
+}
+
+int wadd_wch(WINDOW* win, const cchar_t* wch)
 {
-    if (id < 1 || id > COLOR_PAIRS - 1)
+    if (win == nullptr || wch == nullptr)
     {
         return ERR;
     }
 
-    colors[id] = {
+    if (add_character(win, static_cast<char32_t>(wch->chars[0]), wch->attr) == ERR)
+    {
+        return ERR;
+    }
+    for (int i = 1; i < CCHARW_MAX && wch->chars[i] != 0; ++i)
+    {
+        combine(win, static_cast<char32_t>(wch->chars[i]));
+    }
+    return OK;
+}
+
+int mvwadd_wch(WINDOW* win, int y, int x, const cchar_t* wch)
+{
+    return wmove(win, y, x) == OK ? wadd_wch(win, wch) : ERR;
+}
+
+int waddnwstr(WINDOW* win, const wchar_t* wstr, int n)
+{
+    if (win == nullptr || wstr == nullptr)
+    {
+        return ERR;
+    }
+
+    for (int i = 0; (n < 0 || i < n) && wstr[i] != 0; ++i)
+    {
+        if (add_character(win, static_cast<char32_t>(wstr[i]), 0) == ERR)
+        {
+            return ERR;
+        }
+    }
+    return OK;
+}
+
+int waddwstr(WINDOW* win, const wchar_t* wstr)
+{
+    return waddnwstr(win, wstr, -1);
+}
+
+int mvwaddwstr(WINDOW* win, int y, int x, const wchar_t* wstr)
+{
+    return wmove(win, y, x) == OK ? waddnwstr(win, wstr, -1) : ERR;
+}
+
+int setcchar(cchar_t* wcval, const wchar_t* wch, attr_t attrs, short pair, const void* opts)
+{
+    static_cast<void>(opts);
+    if (wcval == nullptr || wch == nullptr || pair < 0 || pair > COLOR_PAIRS - 1)
+    {
+        return ERR;
+    }
+
+    std::memset(wcval, 0, sizeof(cchar_t));
+    for (int i = 0; i < CCHARW_MAX && wch[i] != 0; ++i)
+    {
+        wcval->chars[i] = wch[i];
+    }
+    const unsigned color = static_cast<unsigned>(pair) << (A_COLOR_OFFSET + A_ATTRIBUTES_OFFSET);
+    wcval->attr = static_cast<attr_t>((static_cast<unsigned short>(attrs) & 0x0f00u) | color);
+    return OK;
+}
+
+int getcchar(const cchar_t* wcval, wchar_t* wch, attr_t* attrs, short* pair, void* opts)
+{
+    static_cast<void>(opts);
+    if (wcval == nullptr || wch == nullptr || attrs == nullptr || pair == nullptr)
+    {
+        return ERR;
+    }
+
+    int i = 0;
+    for (; i < CCHARW_MAX && wcval->chars[i] != 0; ++i)
+    {
+        wch[i] = wcval->chars[i];
+    }
+    if (i < CCHARW_MAX)
+    {
+        wch[i] = 0;
+    }
+    const unsigned attributes = static_cast<unsigned short>(wcval->attr);
+    *attrs = static_cast<attr_t>(attributes & 0x0f00u);
+    *pair = static_cast<short>(attributes >> (A_COLOR_OFFSET + A_ATTRIBUTES_OFFSET));
+    return OK;
+}
+
+//-------------------------------------------//
+//------          BORDERS             -------//
+//-------------------------------------------//
+
+int whline_set(WINDOW* win, const cchar_t* wch, int n)
+{
+    if (win == nullptr || wch == nullptr)
+    {
+        return ERR;
+    }
+
+    // Lines do not move cursor nor wrap
+    const short x = win->cursor_x;
+    const short y = win->cursor_y;
+    for (int i = 0; i < n && win->cursor_y == y; ++i)
+    {
+        wadd_wch(win, wch);
+    }
+    win->cursor_x = x;
+    win->cursor_y = y;
+    return OK;
+}
+
+int wvline_set(WINDOW* win, const cchar_t* wch, int n)
+{
+    if (win == nullptr || wch == nullptr)
+    {
+        return ERR;
+    }
+
+    const short x = win->cursor_x;
+    const short y = win->cursor_y;
+    for (int i = 0; i < n && y + i < win->max_y; ++i)
+    {
+        win->cursor_x = x;
+        win->cursor_y = static_cast<short>(y + i);
+        wadd_wch(win, wch);
+    }
+    win->cursor_x = x;
+    win->cursor_y = y;
+    return OK;
+}
+
+int mvwhline_set(WINDOW* win, int y, int x, const cchar_t* wch, int n)
+{
+    return wmove(win, y, x) == OK ? whline_set(win, wch, n) : ERR;
+}
+
+int mvwvline_set(WINDOW* win, int y, int x, const cchar_t* wch, int n)
+{
+    return wmove(win, y, x) == OK ? wvline_set(win, wch, n) : ERR;
+}
+
+const cchar_t wacs_lines[6] = {
+    {0, {0x2500}},
+    {0, {0x2502}},
+    {0, {0x250c}},
+    {0, {0x2510}},
+    {0, {0x2514}},
+    {0, {0x2518}},
+};
+
+int wborder_set(WINDOW* win, const cchar_t* ls, const cchar_t* rs, const cchar_t* ts, const cchar_t* bs,
+                const cchar_t* tl, const cchar_t* tr, const cchar_t* bl, const cchar_t* br)
+{
+    if (win == nullptr)
+    {
+        return ERR;
+    }
+
+    // NULL characters are replaced with line drawing defaults
+    ls = ls != nullptr ? ls : WACS_VLINE;
+    rs = rs != nullptr ? rs : WACS_VLINE;
+    ts = ts != nullptr ? ts : WACS_HLINE;
+    bs = bs != nullptr ? bs : WACS_HLINE;
+    tl = tl != nullptr ? tl : WACS_ULCORNER;
+    tr = tr != nullptr ? tr : WACS_URCORNER;
+    bl = bl != nullptr ? bl : WACS_LLCORNER;
+    br = br != nullptr ? br : WACS_LRCORNER;
+
+    const short x = win->cursor_x;
+    const short y = win->cursor_y;
+    const int right = win->max_x - 1;
+    const int bottom = win->max_y - 1;
+    mvwhline_set(win, 0, 1, ts, right - 1);
+    mvwhline_set(win, bottom, 1, bs, right - 1);
+    mvwvline_set(win, 1, 0, ls, bottom - 1);
+    mvwvline_set(win, 1, right, rs, bottom - 1);
+    mvwadd_wch(win, 0, 0, tl);
+    mvwadd_wch(win, 0, right, tr);
+    mvwadd_wch(win, bottom, 0, bl);
+    // Bottom right corner must not advance cursor past end of screen
+    win->cursor_x = static_cast<short>(right);
+    win->cursor_y = static_cast<short>(bottom);
+    wadd_wch(win, br);
+    win->cursor_x = x;
+    win->cursor_y = y;
+    return OK;
+}
+
+int border_set(const cchar_t* ls, const cchar_t* rs, const cchar_t* ts, const cchar_t* bs,
+               const cchar_t* tl, const cchar_t* tr, const cchar_t* bl, const cchar_t* br)
+{
+    return wborder_set(stdscr, ls, rs, ts, bs, tl, tr, bl, br);
+}
+
+int box_set(WINDOW* win, const cchar_t* verch, const cchar_t* horch)
+{
+    // Corners are always line drawing ones, sides default like in wborder_set
+    return wborder_set(win, verch, verch, horch, horch, nullptr, nullptr, nullptr, nullptr);
+}
+
+// int mvwaddchstr(WINDOW *win, int y, int x, const chtype *chstr)
+// {
+
+// }
+
+
+WINDOW* stdscr = nullptr;
+
+int wmove(WINDOW *win, int y, int x)
+{
+    if (win == nullptr || y < 0 || x < 0 || y >= win->max_y || x >= win->max_x)
+    {
+        return ERR;
+    }
+
+    win->cursor_x = static_cast<short>(x);
+    win->cursor_y = static_cast<short>(y);
+
+    return OK;
+}
+
+int move(int y, int x)
+{
+    return wmove(stdscr, y, x);
+}
+
+int clear()
+{
+    // Terminals with background color erase fill screen with current color
+    const msos::curses::SgrCache::Sequence& reset = screen->sgr.get(0);
+    emit(reset.data, reset.size);
+    screen->stats.classify(msos::curses::OutputKind::attributes, reset.size);
+    screen->stats.classify(msos::curses::OutputKind::erase, emit_capability(screen->clear_screen));
+    screen->renderer.clear();
+    if (stdscr != nullptr)
+    {
+        const std::size_t cells = static_cast<std::size_t>(stdscr->max_x * stdscr->max_y);
+        std::fill(stdscr->screen_buffer, stdscr->screen_buffer + cells, stdscr->background);
+        if (stdscr->wide_buffer != nullptr)
+        {
+            std::memset(stdscr->wide_buffer, 0, cells * sizeof(wchar_t));
+        }
+        stdscr->cursor_x = 0;
+        stdscr->cursor_y = 0;
+    }
+    return 0;
+}
+
+namespace
+{
+
+// Screen larger than buffer uses only part that fits
+void fit_size(int& lines, int& columns)
+{
+    columns = std::min(columns, SCREEN_BUFFER_SIZE);
+    lines = std::min(lines, SCREEN_BUFFER_SIZE / std::max(columns, 1));
+}
+
+// Size of terminal on fd, 24x80 when it is not reported
+void terminal_size(int fd, int& lines, int& columns)
+{
+    struct winsize w = {};
+    const bool reported = ioctl(fd, TIOCGWINSZ, &w) == 0 && w.ws_col != 0 && w.ws_row != 0;
+    lines = reported ? w.ws_row : 24;
+    columns = reported ? w.ws_col : 80;
+    fit_size(lines, columns);
+}
+
+volatile std::sig_atomic_t window_size_changed = 0;
+// Handler writes to pipe, so wgetch waiting in poll wakes up on resize
+int resize_pipe[2] = {-1, -1};
+
+// Handler of application, if it has one, is kept. Then it calls resizeterm.
+void watch_window_size()
+{
+#ifdef SIGWINCH
+    struct sigaction current = {};
+    if (sigaction(SIGWINCH, nullptr, &current) != 0 || current.sa_handler != SIG_DFL)
+    {
+        return;
+    }
+    if (pipe(resize_pipe) == 0)
+    {
+        for (const int fd : resize_pipe)
+        {
+            fcntl(fd, F_SETFL, O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    }
+    else
+    {
+        resize_pipe[0] = -1;
+        resize_pipe[1] = -1;
+    }
+    struct sigaction action = {};
+    // SA_RESTART keeps blocking calls of application running through resize
+    action.sa_handler = [](int) {
+        const int saved = errno;
+        window_size_changed = 1;
+        if (resize_pipe[1] >= 0)
+        {
+            static_cast<void>(write(resize_pipe[1], "", 1));
+        }
+        errno = saved;
+    };
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGWINCH, &action, nullptr);
+#endif // SIGWINCH
+}
+
+// Prepares current screen for terminal of type, nullptr means TERM
+WINDOW* start_screen(const char* type)
+{
+    std::memset(&screen->window, 0, sizeof(screen->window));
+    screen->window.screen_buffer = screen->buffer;
+    screen->window.wide_buffer = CURSES_WIDECHAR ? screen->wide_buffer : nullptr;
+    stdscr = &screen->window;
+    for (SCREEN& other : screens)
+    {
+        if (other.source == screen)
+        {
+            detach_screen(&other);
+        }
+    }
+    detach_screen(screen);
+    screen->repaint = false;
+    setupterm(type, screen->output_fd, nullptr);
+    if (probe_enabled && !screen->evloop_mode)
+    {
+        probe_terminal(probe_timeout);
+    }
+    std::memset(&screen->colors, -1, sizeof(screen->colors));
+    screen->default_colors = false;
+    screen->palette.reset();
+    screen->sgr.build(screen->colors, screen->palette);
+    screen->renderer.set_background_erase(false);
+    // Terminals with ^N/^O alternate set need it designated first
+    emit_capability(screen->terminfo.string(msos::curses::String::ena_acs));
+    clear();
+    move(0, 0);
+    flush_output();
+    int lines = 0;
+    int columns = 0;
+    terminal_size(screen->output_fd, lines, columns);
+    screen->window.max_x = static_cast<short>(columns);
+    screen->window.max_y = static_cast<short>(lines);
+    screen->renderer.resize(lines, columns);
+    watch_window_size();
+
+    return &screen->window;
+}
+
+} // namespace
+
+WINDOW* initscr()
+{
+    screen_used[0] = true;
+    set_term(&screens[0]);
+    return start_screen(nullptr);
+}
+
+SCREEN* newterm(const char* type, FILE* outfd, FILE* infd)
+{
+    if (outfd == nullptr || infd == nullptr)
+    {
+        return nullptr;
+    }
+
+    SCREEN* created = std::find(std::begin(screen_used), std::end(screen_used), false) - screen_used + screens;
+    if (created == screens + MAX_SCREENS)
+    {
+        return nullptr;
+    }
+
+    created->~SCREEN();
+    new (created) SCREEN();
+    // Standard output goes through printf, which is console of MSOS
+    if (outfd != stdout)
+    {
+        created->sink = msos::curses::OutputSink(msos::curses::FileSink{outfd});
+    }
+    created->output_fd = fileno(outfd);
+    created->input_fd = fileno(infd);
+    screen_used[created - screens] = true;
+    set_term(created);
+    start_screen(type);
+    return created;
+}
+
+SCREEN* set_term(SCREEN* new_screen)
+{
+    SCREEN* old = screen;
+    if (new_screen != nullptr)
+    {
+        screen = new_screen;
+        stdscr = screen->window.screen_buffer != nullptr ? &screen->window : nullptr;
+    }
+    return old;
+}
+
+void delscreen(SCREEN* sp)
+{
+    if (sp < screens || sp >= screens + MAX_SCREENS || !screen_used[sp - screens])
+    {
+        return;
+    }
+
+    detach_screen(sp);
+    for (SCREEN& other : screens)
+    {
+        if (other.source == sp)
+        {
+            detach_screen(&other);
+        }
+    }
+    // Mapped terminal description is released by destructor
+    sp->~SCREEN();
+    new (sp) SCREEN();
+    screen_used[sp - screens] = false;
+    if (sp == screen)
+    {
+        stdscr = nullptr;
+    }
+}
+
+namespace
+{
+
+bool valid_screen(const SCREEN* sp)
+{
+    return sp >= screens && sp < screens + MAX_SCREENS && screen_used[sp - screens];
+}
+
+// Screens receiving output of renderer currently drawing
+SCREEN* group[MAX_SCREENS];
+std::size_t group_size = 0;
+
+void emit_to_group(const char* data, std::size_t size)
+{
+    SCREEN* const current = screen;
+    for (std::size_t i = 0; i < group_size; ++i)
+    {
+        screen = group[i];
+        emit(data, size);
+    }
+    screen = current;
+}
+
+// Source first, so it leads viewers of its own terminal type
+template <typename Function>
+void for_each_target(SCREEN* source, const Function& function)
+{
+    function(source);
+    for (SCREEN& target : screens)
+    {
+        if (screen_used[&target - screens] && target.source == source)
+        {
+            function(&target);
+        }
+    }
+}
+
+// Renderer of leader is handed over to its first follower
+void leave_group(SCREEN* target)
+{
+    SCREEN* successor = nullptr;
+    for (SCREEN& other : screens)
+    {
+        if (other.leader != target)
+        {
+            continue;
+        }
+        if (successor == nullptr)
+        {
+            successor = &other;
+            successor->renderer = target->renderer;
+            successor->leader = nullptr;
+        }
+        else
+        {
+            other.leader = successor;
+        }
+    }
+    target->leader = nullptr;
+}
+
+// Marks next lines of round robin resync of member, renderer draws them
+void advance_resync(SCREEN* member, msos::curses::Renderer& renderer, int lines)
+{
+    if (member->resync_lines <= 0 || lines <= 0)
+    {
+        return;
+    }
+    const int count = std::min(member->resync_lines, lines);
+    const int next = member->resync_next % lines;
+    renderer.invalidate_lines(next, count);
+    renderer.invalidate_lines(0, next + count - lines);
+    member->resync_next = (next + count) % lines;
+}
+
+// Viewers use color pairs of source with sequences of their terminals
+void follow_colors(SCREEN* target, const SCREEN* source)
+{
+    if (std::memcmp(target->colors, source->colors, sizeof(target->colors)) != 0)
+    {
+        std::memcpy(target->colors, source->colors, sizeof(target->colors));
+        target->sgr.build(target->colors, target->palette);
+        target->renderer.invalidate_attributes();
+    }
+}
+
+void render_targets(SCREEN* source)
+{
+    SCREEN* const current = screen;
+    for_each_target(source, [](SCREEN* target) {
+        if (!target->repaint)
+        {
+            return;
+        }
+        leave_group(target);
+        screen = target;
+        // Cancels escape sequence cut in the middle
+        emit("\030");
+        // Blank screen is not shown before it is drawn again
+        target->stats.classify(msos::curses::OutputKind::motion, target->renderer.begin_frame(&emit));
+        const msos::curses::SgrCache::Sequence& reset = target->sgr.get(0);
+        emit(reset.data, reset.size);
+        target->stats.classify(msos::curses::OutputKind::attributes, reset.size);
+        target->stats.classify(msos::curses::OutputKind::erase, emit_capability(target->clear_screen));
+        target->renderer.clear();
+        target->repaint = false;
+    });
+
+    for_each_target(source, [source](SCREEN* target) {
+        if (target->leader != nullptr)
+        {
+            return;
+        }
+        group_size = 0;
+        group[group_size++] = target;
+        for (SCREEN& other : screens)
+        {
+            if (&other != target && other.leader == target && group_size < MAX_SCREENS)
+            {
+                group[group_size++] = &other;
+            }
+        }
+
+        follow_colors(target, source);
+        for (std::size_t i = 0; i < group_size; ++i)
+        {
+            advance_resync(group[i], target->renderer, source->window.max_y);
+        }
+        // Queued output keeps only what fits, rest is drawn after drain
+        std::size_t room = SIZE_MAX;
+        for (std::size_t i = 0; i < group_size; ++i)
+        {
+            room = group[i]->evloop_mode ? std::min(room, group[i]->output.free_space()) : room;
+        }
+        target->renderer.limit_output(room);
+        screen = target;
+        target->renderer.update(source->window, target->sgr,
+            group_size > 1 ? &emit_to_group : static_cast<msos::curses::Renderer::Writer>(&emit));
+        for (std::size_t i = 0; i < group_size; ++i)
+        {
+            screen = group[i];
+            screen->stats.render(target->renderer.counters(), true);
+            flush_output();
+        }
+    });
+
+    // Terminals showing same cells are drawn once from now on
+    for_each_target(source, [source](SCREEN* target) {
+        const auto leading = [target](const SCREEN& other) {
+            return other.leader == target;
+        };
+        if (target == source || target->leader != nullptr || target->repaint
+            || std::any_of(std::begin(screens), std::end(screens), leading))
+        {
+            return;
+        }
+        for_each_target(source, [target](SCREEN* leader) {
+            if (target->leader != nullptr || leader == target || leader->leader != nullptr || leader->repaint
+                || std::strcmp(leader->terminal_name, target->terminal_name) != 0)
+            {
+                return;
+            }
+            screen = target;
+            if (target->renderer.follow(leader->renderer, target->sgr, &emit))
+            {
+                target->stats.render(target->renderer.counters(), false);
+                target->leader = leader;
+                flush_output();
+            }
+        });
+    });
+    screen = current;
+}
+
+} // namespace
+
+int attach_screen(SCREEN* source, SCREEN* viewer)
+{
+    if (!valid_screen(source) || !valid_screen(viewer) || source == viewer || source->source != nullptr)
+    {
+        return ERR;
+    }
+    for (const SCREEN& other : screens)
+    {
+        if (other.source == viewer)
+        {
+            return ERR;
+        }
+    }
+
+    detach_screen(viewer);
+    viewer->source = source;
+    viewer->renderer.resize(source->window.max_y, source->window.max_x);
+    viewer->repaint = true;
+    return OK;
+}
+
+int detach_screen(SCREEN* viewer)
+{
+    if (!valid_screen(viewer) || viewer->source == nullptr)
+    {
+        return ERR;
+    }
+
+    leave_group(viewer);
+    viewer->source = nullptr;
+    viewer->renderer.resize(viewer->window.max_y, viewer->window.max_x);
+    viewer->repaint = true;
+    return OK;
+}
+
+//-------------------------------------------//
+//------           RESIZE             -------//
+//-------------------------------------------//
+
+namespace
+{
+
+// Cells of stdscr that still fit keep their place, exposed ones are blank.
+// Terminals showing it keep what they display where possible.
+void resize_screen(int lines, int columns)
+{
+    WINDOW& window = screen->window;
+    msos::curses::reflow(window.screen_buffer, window.max_y, window.max_x, lines, columns, window.background);
+    if (window.wide_buffer != nullptr)
+    {
+        msos::curses::reflow(window.wide_buffer, window.max_y, window.max_x, lines, columns, wchar_t(0));
+        for (int y = 0; y < lines && columns < window.max_x; ++y)
+        {
+            // Wide character lost its right half
+            const int last = (y + 1) * columns - 1;
+            const auto text = static_cast<std::uint32_t>(window.wide_buffer[last]);
+            if (text != 0 && msos::curses::character_width(text & msos::curses::cell_codepoint_mask) == 2)
+            {
+                window.screen_buffer[last] = window.background;
+                window.wide_buffer[last] = 0;
+            }
+        }
+    }
+    window.max_y = static_cast<short>(lines);
+    window.max_x = static_cast<short>(columns);
+    window.cursor_y = static_cast<short>(std::min<int>(window.cursor_y, lines - 1));
+    window.cursor_x = static_cast<short>(std::min<int>(window.cursor_x, columns - 1));
+
+    if (screen->source == nullptr)
+    {
+        screen->renderer.reshape(lines, columns);
+    }
+    // Viewer terminals did not change size, area they show did
+    for (SCREEN& other : screens)
+    {
+        if (other.source == screen)
+        {
+            leave_group(&other);
+            other.renderer.resize(lines, columns);
+            other.repaint = true;
+        }
+    }
+}
+
+// Asks terminals for size after SIGWINCH, changed ones get KEY_RESIZE
+void check_window_size()
+{
+    if (!window_size_changed)
+    {
+        return;
+    }
+    window_size_changed = 0;
+    // Signal coming after this point sets flag again
+    char wakeups[16];
+    while (resize_pipe[0] >= 0 && read(resize_pipe[0], wakeups, sizeof(wakeups)) > 0)
+    {
+    }
+    SCREEN* const current = screen;
+    for (std::size_t i = 0; i < MAX_SCREENS; ++i)
+    {
+        if (screen_used[i] && screens[i].window.screen_buffer != nullptr)
+        {
+            int lines = 0;
+            int columns = 0;
+            terminal_size(screens[i].output_fd, lines, columns);
+            screen = &screens[i];
+            resizeterm(lines, columns);
+        }
+    }
+    screen = current;
+}
+
+} // namespace
+
+bool is_term_resized(int lines, int columns)
+{
+    fit_size(lines, columns);
+    return lines > 0 && columns > 0 && (lines != screen->window.max_y || columns != screen->window.max_x);
+}
+
+int resize_term(int lines, int columns)
+{
+    if (lines <= 0 || columns <= 0 || screen->window.screen_buffer == nullptr)
+    {
+        return ERR;
+    }
+    if (is_term_resized(lines, columns))
+    {
+        fit_size(lines, columns);
+        resize_screen(lines, columns);
+    }
+    return OK;
+}
+
+int resizeterm(int lines, int columns)
+{
+    if (!is_term_resized(lines, columns))
+    {
+        return resize_term(lines, columns);
+    }
+    resize_term(lines, columns);
+    return screen->input.unget(KEY_RESIZE);
+}
+
+int set_output_fd(SCREEN* sp, int fd)
+{
+    if (!valid_screen(sp) || fd < 0)
+    {
+        return ERR;
+    }
+    sp->sink = msos::curses::OutputSink(msos::curses::FdSink{fd});
+    sp->output_fd = fd;
+    return OK;
+}
+
+int set_output_buffer(SCREEN* sp, char* buffer, int size)
+{
+    if (!valid_screen(sp) || buffer == nullptr || size < 0)
+    {
+        return ERR;
+    }
+    sp->sink = msos::curses::OutputSink(msos::curses::MemorySink{buffer, static_cast<std::size_t>(size), 0});
+    return OK;
+}
+
+int output_buffer_size(SCREEN* sp)
+{
+    if (!valid_screen(sp) || sp->sink.kind() != msos::curses::OutputSink::Kind::memory)
+    {
+        return ERR;
+    }
+    return static_cast<int>(sp->sink.stored());
+}
+
+int set_output_callback(SCREEN* sp, output_callback callback, void* context)
+{
+    if (!valid_screen(sp) || callback == nullptr)
+    {
+        return ERR;
+    }
+    sp->sink = msos::curses::OutputSink(msos::curses::CallbackSink{callback, context});
+    return OK;
+}
+
+#if CURSES_DRAW_QUEUE
+
+namespace
+{
+
+// Splits text on UTF-8 boundaries, so each command decodes by itself
+std::size_t text_chunk(const char* str, std::size_t size, std::size_t offset)
+{
+    std::size_t length = std::min<std::size_t>(DRAW_TEXT_SIZE, size - offset);
+    if (offset + length < size)
+    {
+        std::size_t boundary = length;
+        while (boundary > 0 && (static_cast<unsigned char>(str[offset + boundary]) & 0xc0) == 0x80)
+        {
+            --boundary;
+        }
+        length = boundary > 0 ? boundary : length;
+    }
+    return length;
+}
+
+// Runs on render thread only, queue has single consumer
+void apply_draw_queue()
+{
+    const char attributes = stdscr->attributes;
+    msos::curses::DrawCommand command;
+    bool placed = false;
+    while (screen->draw_queue.pop(command))
+    {
+        switch (command.kind)
+        {
+            case msos::curses::DrawCommand::Kind::move:
+                wmove(stdscr, command.y, command.x);
+                break;
+            case msos::curses::DrawCommand::Kind::text:
+                wattrset(stdscr, command.attributes);
+                placed = wmove(stdscr, command.y, command.x) == OK;
+                [[fallthrough]];
+            case msos::curses::DrawCommand::Kind::more_text:
+                if (placed)
+                {
+                    waddnstr(stdscr, command.text, command.size);
+                }
+                break;
+        }
+    }
+    stdscr->attributes = attributes;
+}
+
+// Screen may be resized before command is applied, wmove checks again then
+bool inside_screen(const SCREEN* sp, int y, int x)
+{
+    return y >= 0 && x >= 0 && y < sp->window.max_y && x < sp->window.max_x;
+}
+
+} // namespace
+
+int queue_mvaddnstr(SCREEN* sp, int y, int x, int attrs, const char* str, int n)
+{
+    if (!valid_screen(sp) || str == nullptr || !inside_screen(sp, y, x))
+    {
+        return ERR;
+    }
+
+    const std::size_t size = n < 0 ? std::strlen(str) : strnlen(str, static_cast<std::size_t>(n));
+    std::size_t count = 0;
+    for (std::size_t offset = 0; offset < size; ++count)
+    {
+        offset += text_chunk(str, size, offset);
+    }
+
+    std::size_t offset = 0;
+    const bool queued = sp->draw_queue.push(std::max<std::size_t>(count, 1),
+        [&](std::size_t i, msos::curses::DrawCommand& command) {
+            const std::size_t length = offset < size ? text_chunk(str, size, offset) : 0;
+            command.kind = i == 0 ? msos::curses::DrawCommand::Kind::text : msos::curses::DrawCommand::Kind::more_text;
+            command.size = static_cast<std::uint8_t>(length);
+            command.y = static_cast<short>(y);
+            command.x = static_cast<short>(x);
+            command.attributes = attrs;
+            std::memcpy(command.text, str + offset, length);
+            offset += length;
+        });
+    return queued ? OK : ERR;
+}
+
+int queue_move(SCREEN* sp, int y, int x)
+{
+    if (!valid_screen(sp) || !inside_screen(sp, y, x))
+    {
+        return ERR;
+    }
+
+    const bool queued = sp->draw_queue.push(1, [&](std::size_t, msos::curses::DrawCommand& command) {
+        command.kind = msos::curses::DrawCommand::Kind::move;
+        command.size = 0;
+        command.y = static_cast<short>(y);
+        command.x = static_cast<short>(x);
+        command.attributes = 0;
+    });
+    return queued ? OK : ERR;
+}
+
+#else
+
+int queue_mvaddnstr(SCREEN*, int, int, int, const char*, int)
+{
+    return ERR;
+}
+
+int queue_move(SCREEN*, int, int)
+{
+    return ERR;
+}
+
+#endif // CURSES_DRAW_QUEUE
+
+int endwin()
+{
+    echo();
+    set_mouse_tracking(screen->input.mouse().mask(), 0);
+    if (screen->paste_enabled)
+    {
+        emit("\033[?2004l");
+    }
+    emit(nobold);
+    attroff(COLOR_PAIR(1));
+    if (screen->cursor_visibility != 1 && !screen->cursor_shown)
+    {
+        emit_capability(visibility_sequence(1));
+        screen->cursor_shown = true;
+    }
+    screen->renderer.invalidate();
+    flush_output();
+    return OK;
+}
+
+int getmaxx(WINDOW* window)
+{
+    return window->max_x;
+}
+
+int getmaxy(WINDOW* window)
+{
+    return window->max_y;
+}
+
+// PRINTERS //
+
+namespace
+{
+
+int vprintw(const char* str, va_list arg)
+{
+    // Console formats straight into its UART writer
+    if (screen->evloop_mode || screen->sink.kind() != msos::curses::OutputSink::Kind::console)
+    {
+        char line[256];
+        const int size = vsnprintf(line, sizeof(line), str, arg);
+        if (size < 0)
+        {
+            return ERR;
+        }
+        emit(line, std::strlen(line));
+        screen->renderer.invalidate();
+        return size;
+    }
+    screen->renderer.invalidate();
+    return __vfprintf_(writer, 1, str, arg, 0);
+}
+
+}
+
+int printw(const char *str, ...)
+{
+    va_list arg;
+    va_start (arg, str);
+    int done = vprintw(str, arg);
+    va_end (arg);
+    return done;
+}
+
+int mvprintw(int row, int column, const char *str, ...)
+{
+    move(column, row);
+    va_list arg;
+    va_start (arg, str);
+    int done = vprintw(str, arg);
+    va_end (arg);
+    return done;
+}
+
+int wnoutrefresh(WINDOW* win)
+{
+    // Virtual screen is stdscr itself until other windows are supported
+    return win == stdscr && win != nullptr ? OK : ERR;
+}
+
+int redrawwin(WINDOW* win)
+{
+    return win != nullptr ? wredrawln(win, 0, win->max_y) : ERR;
+}
+
+int wredrawln(WINDOW* win, int beg_line, int num_lines)
+{
+    if (win != stdscr || win == nullptr || beg_line < 0 || num_lines < 0)
+    {
+        return ERR;
+    }
+    // Every terminal showing window may be the one that lost output
+    for_each_target(screen->source != nullptr ? screen->source : screen, [beg_line, num_lines](SCREEN* target) {
+        target->renderer.invalidate_lines(beg_line, num_lines);
+    });
+    return OK;
+}
+
+int doupdate(void)
+{
+    if (stdscr == nullptr)
+    {
+        return ERR;
+    }
+    const msos::curses::Statistics::Timestamp start = screen->stats.refresh_started();
+#if CURSES_DRAW_QUEUE
+    apply_draw_queue();
+#endif // CURSES_DRAW_QUEUE
+    if (screen->cursor_shown)
+    {
+        screen->stats.classify(msos::curses::OutputKind::motion,
+            emit_capability(visibility_sequence(screen->cursor_visibility)));
+        screen->cursor_shown = false;
+    }
+    // Viewer terminal is drawn by doupdate of its source
+    if (screen->source == nullptr)
+    {
+        render_targets(screen);
+    }
+    screen->stats.refresh_finished(start);
+    return OK;
+}
+
+int wrefresh(WINDOW* win)
+{
+    return wnoutrefresh(win) == OK ? doupdate() : ERR;
+}
+
+int refresh(void)
+{
+    return wrefresh(stdscr);
+}
+
+int noecho(void)
+{
+    struct termios tattr;
+
+    tcgetattr (screen->input_fd, &tattr);
+    tattr.c_lflag &= ~(ICANON | ECHO);
+    tattr.c_cc[VMIN] = 1;
+    tattr.c_cc[VTIME] = 0;
+    tcsetattr (screen->input_fd, TCSANOW, &tattr);
+    screen->echo_enabled = false;
+    return 0;
+}
+
+int echo(void)
+{
+    struct termios tattr;
+
+    tcgetattr (screen->input_fd, &tattr);
+    tattr.c_lflag |= ECHO;
+    tcsetattr (screen->input_fd, TCSANOW, &tattr);
+    screen->echo_enabled = true;
+    return 0;
+}
+
+// INPUT
+namespace
+{
+
+// Blocks until input is readable, false when resize came first
+bool wait_for_key()
+{
+    if (window_size_changed)
+    {
+        return false;
+    }
+    // Negative descriptor of missing pipe is skipped by poll
+    struct pollfd fds[2] = {
+        {.fd = screen->input_fd, .events = POLLIN, .revents = 0},
+        {.fd = resize_pipe[0], .events = POLLIN, .revents = 0}
+    };
+    screen->stats.syscalls(1);
+    const int ready = poll(fds, 2, -1);
+    if (ready < 0)
+    {
+        // Other failures are reported by read
+        return errno != EINTR;
+    }
+    return fds[0].revents != 0;
+}
+
+// Blocks until pop gives a key, unless event loop drives input
+template <typename Pop>
+int read_key(const Pop& pop)
+{
+    check_window_size();
+    int key = pop();
+    while (key == ERR && !screen->evloop_mode)
+    {
+        if (screen->input.incomplete() && !wait_for_input(ESCDELAY))
+        {
+            screen->input.expire();
+        }
+        else if (wait_for_key())
+        {
+            // Only what fits is read, rest waits in terminal driver
+            char data[64];
+            const std::size_t room = std::min(sizeof(data), screen->input.free_space());
+            if (room == 0)
+            {
+                return ERR;
+            }
+            const ssize_t size = read(screen->input_fd, data, room);
+            screen->stats.syscalls(1);
+            if (size == 0 || (size < 0 && errno != EINTR))
+            {
+                // End of input or hang up, waiting again would never end
+                return ERR;
+            }
+            if (size > 0)
+            {
+                screen->stats.input(static_cast<std::size_t>(size));
+                screen->recorder.record(msos::curses::Recorder::Event::input, data, static_cast<std::size_t>(size));
+                screen->input.push(data, static_cast<std::size_t>(size));
+            }
+        }
+        // Resize while waiting returns with KEY_RESIZE
+        check_window_size();
+        key = pop();
+    }
+    screen->stats.keys(key != ERR ? 1 : 0);
+    return key;
+}
+
+}
+
+int wgetch(WINDOW* win)
+{
+    if (win == nullptr)
+    {
+        return ERR;
+    }
+    return read_key([win] { return screen->input.pop(win->key_translation); });
+}
+
+int wget_wch(WINDOW* win, wint_t* wch)
+{
+    if (win == nullptr || wch == nullptr)
+    {
+        return ERR;
+    }
+
+    char32_t c = 0;
+    const int result = read_key([win, &c] { return screen->input.pop_wide(win->key_translation, &c); });
+    if (result != ERR)
+    {
+        *wch = static_cast<wint_t>(c);
+    }
+    return result;
+}
+
+int getch(void)
+{
+    return wgetch(stdscr);
+}
+
+int mvwgetch(WINDOW* win, int y, int x)
+{
+    return wmove(win, y, x) == OK ? wgetch(win) : ERR;
+}
+
+int mvgetch(int y, int x)
+{
+    return mvwgetch(stdscr, y, x);
+}
+
+int ungetch(int ch)
+{
+    return screen->input.unget(ch);
+}
+
+//-------------------------------------------//
+//------           MOUSE              -------//
+//-------------------------------------------//
+
+mmask_t mousemask(mmask_t newmask, mmask_t* oldmask)
+{
+    const mmask_t old_mask = screen->input.mouse().mask();
+    if (oldmask != nullptr)
+    {
+        *oldmask = old_mask;
+    }
+
+    newmask &= ALL_MOUSE_EVENTS | REPORT_MOUSE_POSITION;
+    set_mouse_tracking(old_mask, newmask);
+    screen->input.mouse().set_mask(newmask);
+    flush_output();
+    return newmask;
+}
+
+int getmouse(MEVENT* event)
+{
+    return screen->input.mouse().get(event);
+}
+
+int ungetmouse(MEVENT* event)
+{
+    if (screen->input.mouse().unget(event) == ERR)
+    {
+        return ERR;
+    }
+    if (screen->input.unget(KEY_MOUSE) == ERR)
+    {
+        // Event without its KEY_MOUSE would be returned for other one
+        MEVENT removed;
+        screen->input.mouse().get(&removed);
+        return ERR;
+    }
+    return OK;
+}
+
+bool has_mouse(void)
+{
+    return screen->input.mouse().mask() != 0;
+}
+
+//-------------------------------------------//
+//------       BRACKETED PASTE        -------//
+//-------------------------------------------//
+
+int bracketed_paste(bool bf)
+{
+    if (bf != screen->paste_enabled)
+    {
+        emit(bf ? "\033[?2004h" : "\033[?2004l");
+        flush_output();
+    }
+    screen->paste_enabled = bf;
+    screen->input.set_bracketed_paste(bf);
+    return OK;
+}
+
+const char* getpaste(int* size)
+{
+    std::size_t length;
+    const char* data = screen->input.paste(&length);
+    if (size != nullptr)
+    {
+        *size = static_cast<int>(length);
+    }
+    return data;
+}
+
+//-------------------------------------------//
+//------         EVENT LOOP           -------//
+//-------------------------------------------//
+
+int evloop_enable(bool bf)
+{
+    if (!bf && screen->evloop_mode)
+    {
+        char data[64];
+        std::size_t size;
+        while ((size = screen->output.pop(data, sizeof(data))) != 0)
+        {
+            write_output(data, size);
+        }
+        screen->sink.flush();
+    }
+    screen->evloop_mode = bf;
+    return OK;
+}
+
+int evloop_input_fd(void)
+{
+    return screen->input_fd;
+}
+
+int evloop_input_timeout(void)
+{
+    return screen->input.incomplete() ? ESCDELAY : -1;
+}
+
+bool evloop_output_pending(void)
+{
+    return !screen->output.empty();
+}
+
+int evloop_feed(const char* data, int size, int* keys, int max_keys, int* consumed)
+{
+    if (keys == nullptr || size < 0 || max_keys < 0)
+    {
+        return ERR;
+    }
+
+    check_window_size();
+    const bool keypad = stdscr != nullptr && stdscr->key_translation;
+    const char* const begin = data;
+    std::size_t left = data != nullptr ? static_cast<std::size_t>(size) : 0;
+    int decoded = 0;
+    for (;;)
+    {
+        const std::size_t pushed = screen->input.push(data, left);
+        screen->stats.input(pushed);
+        data += pushed;
+        left -= pushed;
+        if (decoded == max_keys)
+        {
+            break;
+        }
+
+        int key = screen->input.pop(keypad);
+        if (key == ERR && data == nullptr && screen->input.incomplete())
+        {
+            screen->input.expire();
+            key = screen->input.pop(keypad);
+        }
+        if (key == ERR && left != 0 && screen->input.free_space() != 0)
+        {
+            // Paste payload drained the ring, rest of it is still in data
+            continue;
+        }
+        if (key == ERR)
+        {
+            break;
+        }
+        keys[decoded++] = key;
+        if (key == KEY_PASTE)
+        {
+            // payload is valid only until next key is decoded
+            break;
+        }
+    }
+
+    const std::size_t taken = begin != nullptr ? static_cast<std::size_t>(data - begin) : 0;
+    screen->recorder.record(msos::curses::Recorder::Event::input, begin, taken);
+    if (consumed != nullptr)
+    {
+        *consumed = static_cast<int>(taken);
+    }
+    screen->stats.keys(decoded);
+    return decoded;
+}
+
+int evloop_drain(char* buffer, int size)
+{
+    if (buffer == nullptr || size < 0)
+    {
+        return ERR;
+    }
+    const int drained = static_cast<int>(screen->output.pop(buffer, static_cast<std::size_t>(size)));
+    // Frame cut at full queue continues in freed space
+    const SCREEN* drawing = screen->leader != nullptr ? screen->leader : screen;
+    if (drained > 0 && !drawing->renderer.complete())
+    {
+        render_targets(screen->source != nullptr ? screen->source : screen);
+    }
+    return drained;
+}
+
+//-------------------------------------------//
+//------         STATISTICS           -------//
+//-------------------------------------------//
+
+#if CURSES_STATS
+
+int screen_stats(SCREEN* sp, SCREEN_STATS* stats)
+{
+    sp = sp != nullptr ? sp : screen;
+    if (!valid_screen(sp) || stats == nullptr)
+    {
+        return ERR;
+    }
+    sp->stats.export_to(*stats);
+    return OK;
+}
+
+int reset_screen_stats(SCREEN* sp)
+{
+    sp = sp != nullptr ? sp : screen;
+    if (!valid_screen(sp))
+    {
+        return ERR;
+    }
+    sp->stats = msos::curses::Statistics();
+    return OK;
+}
+
+#else
+
+int screen_stats(SCREEN*, SCREEN_STATS*)
+{
+    return ERR;
+}
+
+int reset_screen_stats(SCREEN*)
+{
+    return ERR;
+}
+
+#endif // CURSES_STATS
+
+//-------------------------------------------//
+//------          RECORDING           -------//
+//-------------------------------------------//
+
+int start_recording(SCREEN* sp, char* buffer, int size)
+{
+    sp = sp != nullptr ? sp : screen;
+    if (!valid_screen(sp) || buffer == nullptr || size < 0)
+    {
+        return ERR;
+    }
+    sp->recorder.start(buffer, static_cast<std::size_t>(size));
+    return OK;
+}
+
+int stop_recording(SCREEN* sp)
+{
+    sp = sp != nullptr ? sp : screen;
+    if (!valid_screen(sp))
+    {
+        return ERR;
+    }
+    return static_cast<int>(sp->recorder.stop());
+}
+
+int export_asciicast(SCREEN* sp, output_callback callback, void* context)
+{
+    sp = sp != nullptr ? sp : screen;
+    if (!valid_screen(sp) || callback == nullptr || sp->recorder.data() == nullptr)
+    {
+        return ERR;
+    }
+    const char* term = sp->terminal_name[0] != 0 ? sp->terminal_name : "unknown";
+    const bool written = msos::curses::write_asciicast(sp->recorder.data(), sp->recorder.size(),
+        sp->window.max_y, sp->window.max_x, term, callback, context);
+    return written ? OK : ERR;
+}
+
+//-------------------------------------------//
+//------            RESYNC            -------//
+//-------------------------------------------//
+
+int resync_lines(SCREEN* sp, int lines_per_frame)
+{
+    sp = sp != nullptr ? sp : screen;
+    if (!valid_screen(sp) || lines_per_frame < 0)
+    {
+        return ERR;
+    }
+    sp->resync_lines = lines_per_frame;
+    return OK;
+}
+
+//-------------------------------------------//
+//------        TERMINAL PROBE        -------//
+//-------------------------------------------//
+
+int use_terminal_probe(bool bf, int timeout_ms)
+{
+    probe_enabled = bf;
+    probe_timeout = timeout_ms < 0 ? PROBE_TIMEOUT : timeout_ms;
+    return OK;
+}
+
+int terminal_features(void)
+{
+    return (screen->features.repeat_character ? TERMINAL_REPEAT : 0)
+        | (screen->features.erase_characters ? TERMINAL_ERASE_CHARACTERS : 0)
+        | (screen->features.scroll_region ? TERMINAL_SCROLL_REGION : 0)
+        | (screen->features.direct_color ? TERMINAL_DIRECT_COLOR : 0)
+        | (screen->features.synchronized_output ? TERMINAL_SYNCHRONIZED_OUTPUT : 0);
+}
+
+//-------------------------------------------//
+//------         ATTRIBUTES           -------//
+//-------------------------------------------//
+
+int wattroff(WINDOW* win, int attrs)
+{
+    if (win == nullptr)
+    {
+        return ERR;
+    }
+    win->attributes &= static_cast<char>(~attrs);
+    return OK;
+}
+
+int wattron(WINDOW* win, int attrs)
+{
+    if (win == nullptr)
+    {
+        return ERR;
+    }
+
+    if (attrs & A_COLOR_MASK)
+    {
+        win->attributes &= static_cast<char>(~A_COLOR_MASK);
+    }
+    win->attributes |= static_cast<char>(attrs);
+    return OK;
+}
+
+int wattrset(WINDOW* win, int attrs)
+{
+    if (win == nullptr)
+    {
+        return ERR;
+    }
+
+    win->attributes = static_cast<char>(attrs);
+    return OK;
+}
+
+int wcolor_set(WINDOW* win, short color_pair_number, void* opts)
+{
+    static_cast<void>(opts);
+    if (win == nullptr)
+    {
+        return ERR;
+    }
+
+    if (color_pair_number < 1 || color_pair_number > COLOR_PAIRS - 1)
+    {
+        return ERR;
+    }
+
+    win->attributes &= static_cast<char>(~A_COLOR_MASK);
+    win->attributes |= static_cast<char>((color_pair_number << A_COLOR_OFFSET));
+    return OK;
+}
+
+void wbkgdset(WINDOW* win, chtype ch)
+{
+    if (win != nullptr)
+    {
+        win->background = ch;
+    }
+}
+
+int wbkgd(WINDOW* win, chtype ch)
+{
+    if (win == nullptr)
+    {
+        return ERR;
+    }
+
+    // Replaces old background in every cell, own attributes of cells stay
+    const unsigned old_background = static_cast<unsigned short>(win->background);
+    const unsigned background = static_cast<unsigned short>(ch);
+    const unsigned old_character = old_background & A_CHARTEXT;
+    const int cells = win->max_x * win->max_y;
+    for (int i = 0; i < cells; ++i)
+    {
+        unsigned cell = static_cast<unsigned short>(win->screen_buffer[i]);
+        const unsigned character = cell & A_CHARTEXT;
+        cell &= ~(old_background & rendition_bits);
+        if ((cell & color_bits) == (old_background & color_bits))
+        {
+            cell &= ~color_bits;
+        }
+        const bool blank = character == 0 || character == ' ';
+        if ((character == old_character || (old_character == 0 && blank)) && cell_text(win, i) == 0)
+        {
+            const unsigned replacement = background & A_CHARTEXT;
+            cell = (cell & ~static_cast<unsigned>(A_CHARTEXT)) | (replacement != 0 ? replacement : ' ');
+        }
+        cell |= background & rendition_bits;
+        if ((cell & color_bits) == 0)
+        {
+            cell |= background & color_bits;
+        }
+        win->screen_buffer[i] = static_cast<chtype>(cell);
+    }
+    win->background = ch;
+    return OK;
+}
+
+chtype getbkgd(WINDOW* win)
+{
+    return win != nullptr ? win->background : static_cast<chtype>(ERR);
+}
+
+int raw()
+{
+    return 0;
+}
+
+int noraw()
+{
+    return 0;
+}
+
+int keypad(WINDOW* window, bool bf)
+{
+    window->key_translation = bf;
+    return 0;
+}
+
+int leaveok(WINDOW* win, bool bf)
+{
+    if (win == nullptr)
+    {
+        return ERR;
+    }
+    win->leave_cursor = bf;
+    return OK;
+}
+
+int curs_set(int visibility)
+{
+    if (visibility < 0 || visibility > 2 || visibility_sequence(visibility) == nullptr)
+    {
+        return ERR;
+    }
+    const int previous = screen->cursor_visibility;
+    if (visibility != previous || screen->cursor_shown)
+    {
+        screen->stats.classify(msos::curses::OutputKind::motion, emit_capability(visibility_sequence(visibility)));
+        flush_output();
+    }
+    screen->cursor_visibility = visibility;
+    screen->cursor_shown = false;
+    screen->renderer.set_cursor_visible(visibility != 0);
+    return previous;
+}
+
+char erasechar(void)
+{
+    struct termios tattr;
+    tcgetattr(screen->input_fd, &tattr);
+    return static_cast<char>(tattr.c_cc[VERASE]);
+}
+
+char killchar(void)
+{
+    struct termios tattr;
+    tcgetattr(screen->input_fd, &tattr);
+    return static_cast<char>(tattr.c_cc[VKILL]);
+}
+
+namespace
+{
+
+// Character of line at byte position, line holds only valid UTF-8
+char32_t character_at(const char* str, int position)
+{
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(str + position);
+    return msos::curses::utf8_decode(data, msos::curses::utf8_length(data[0]));
+}
+
+// Columns taken by character, window without wide cells shows others as '?'
+int cell_width(const WINDOW* win, char32_t c)
+{
+    const int width = msos::curses::character_width(c);
+    return win->wide_buffer == nullptr && width > 1 ? 1 : width;
+}
+
+// Columns taken by first size bytes of line
+int line_width(const WINDOW* win, const char* str, int size)
+{
+    int width = 0;
+    for (int i = 0; i < size; i += static_cast<int>(msos::curses::utf8_length(static_cast<unsigned char>(str[i]))))
+    {
+        width += cell_width(win, character_at(str, i));
+    }
+    return width;
+}
+
+// Byte position of next character, its combining marks are skipped with it
+int next_character(const char* str, int length, int position)
+{
+    do
+    {
+        position += static_cast<int>(msos::curses::utf8_length(static_cast<unsigned char>(str[position])));
+    } while (position < length && msos::curses::character_width(character_at(str, position)) == 0);
+    return position;
+}
+
+int previous_character(const char* str, int position)
+{
+    do
+    {
+        --position;
+        while (position > 0 && (static_cast<unsigned char>(str[position]) & 0xc0) == 0x80)
+        {
+            --position;
+        }
+    } while (position > 0 && msos::curses::character_width(character_at(str, position)) == 0);
+    return position;
+}
+
+// Echoes line from byte from on into window cells, cells left behind
+// when line became narrower than old_width are blanked
+void echo_line(WINDOW* win, int y, int x, const char* str, int from, int length, int old_width)
+{
+    win->cursor_y = static_cast<short>(y);
+    win->cursor_x = static_cast<short>(x + line_width(win, str, from));
+    for (int i = from; i < length; i += static_cast<int>(msos::curses::utf8_length(static_cast<unsigned char>(str[i]))))
+    {
+        add_character(win, character_at(str, i), 0);
+    }
+    const int line = y * win->max_x + x;
+    for (int i = line_width(win, str, length); i < old_width; ++i)
+    {
+        put_cell(win, line + i, render_char(win, ' '), 0);
+    }
+}
+
+}
+
+int wgetnstr(WINDOW* win, char* str, int n)
+{
+    if (win == nullptr || str == nullptr)
+    {
+        return ERR;
+    }
+
+    // Line is edited in place, limited to the rest of cursor row. Without
+    // n buffer is assumed to hold as many bytes as there are columns.
+    const int y = win->cursor_y;
+    const int x = win->cursor_x;
+    const int columns = win->max_x - x;
+    const int limit = n >= 0 && n < columns ? n : columns;
+
+    // Terminal must not echo nor buffer lines, editor does it on its own
+    struct termios saved;
+    tcgetattr(screen->input_fd, &saved);
+    struct termios editing = saved;
+    editing.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+    tcsetattr(screen->input_fd, TCSANOW, &editing);
+    const int erase = static_cast<unsigned char>(saved.c_cc[VERASE]);
+    const int kill = static_cast<unsigned char>(saved.c_cc[VKILL]);
+
+    // Positions are in bytes of UTF-8 text and always at character start
+    int length = 0;
+    int position = 0;
+    int result = OK;
+    for (;;)
+    {
+        wint_t wch = 0;
+        const int status = wget_wch(win, &wch);
+        if (status == ERR)
+        {
+            result = ERR;
+            break;
+        }
+        const bool function = status == KEY_CODE_YES;
+        const int key = static_cast<int>(wch);
+        if ((!function && (key == '\n' || key == '\r')) || (function && key == KEY_ENTER))
+        {
+            break;
+        }
+
+        const int old_width = line_width(win, str, length);
+        int from = length;
+        if ((function && key == KEY_BACKSPACE) || (!function && key == erase))
+        {
+            if (position > 0)
+            {
+                const int start = previous_character(str, position);
+                std::memmove(str + start, str + position, static_cast<std::size_t>(length - position));
+                length -= position - start;
+                position = start;
+                from = position;
+            }
+        }
+        else if (function && key == KEY_DC)
+        {
+            if (position < length)
+            {
+                const int end = next_character(str, length, position);
+                std::memmove(str + position, str + end, static_cast<std::size_t>(length - end));
+                length -= end - position;
+                from = position;
+            }
+        }
+        else if (!function && key == kill)
+        {
+            length = 0;
+            position = 0;
+            from = 0;
+        }
+        else if (function && key == KEY_LEFT && position > 0)
+        {
+            position = previous_character(str, position);
+        }
+        else if (function && key == KEY_RIGHT && position < length)
+        {
+            position = next_character(str, length, position);
+        }
+        else if (function && key == KEY_HOME)
+        {
+            position = 0;
+        }
+        else if (function && key == KEY_END)
+        {
+            position = length;
+        }
+        else if (!function && key >= ' ' && key != 0x7f && (key < 0x80 || key >= 0xa0)
+            && msos::curses::character_width(static_cast<char32_t>(key)) >= 0)
+        {
+            char encoded[4];
+            const int size = static_cast<int>(msos::curses::utf8_encode(static_cast<char32_t>(key), encoded));
+            const int width = cell_width(win, static_cast<char32_t>(key));
+            // Combining mark goes with character before it
+            const bool fits = length + size <= limit && old_width + width <= columns && (width > 0 || position > 0);
+            if (fits)
+            {
+                std::memmove(str + position + size, str + position, static_cast<std::size_t>(length - position));
+                std::memcpy(str + position, encoded, static_cast<std::size_t>(size));
+                from = width > 0 ? position : previous_character(str, position);
+                position += size;
+                length += size;
+            }
+        }
+
+        if (screen->echo_enabled)
+        {
+            echo_line(win, y, x, str, from, length, old_width);
+            const int cursor = x + line_width(win, str, position);
+            win->cursor_y = static_cast<short>(y);
+            win->cursor_x = static_cast<short>(cursor < win->max_x ? cursor : win->max_x - 1);
+            wrefresh(win);
+        }
+    }
+
+    str[length] = 0;
+    tcsetattr(screen->input_fd, TCSANOW, &saved);
+    return result;
+}
+
+int wgetstr(WINDOW* win, char* str)
+{
+    return wgetnstr(win, str, -1);
+}
+
+int getstr(char* str)
+{
+    return wgetnstr(stdscr, str, -1);
+}
+
+int getnstr(char* str, int n)
+{
+    return wgetnstr(stdscr, str, n);
+}
+
+int mvwgetnstr(WINDOW* win, int y, int x, char* str, int n)
+{
+    return wmove(win, y, x) == OK ? wgetnstr(win, str, n) : ERR;
+}
+
+int mvwgetstr(WINDOW* win, int y, int x, char* str)
+{
+    return mvwgetnstr(win, y, x, str, -1);
+}
+
+int mvgetnstr(int y, int x, char* str, int n)
+{
+    return mvwgetnstr(stdscr, y, x, str, n);
+}
+
+int mvgetstr(int y, int x, char* str)
+{
+    return mvwgetnstr(stdscr, y, x, str, -1);
+}
+
+int getstr_(char* str, int size)
+{
+    return wgetnstr(stdscr, str, size - 1);
+}
+
+//-------------------------------------------//
+//------           COLORS             -------//
+//-------------------------------------------//
+
+int start_color(void)
+{
+    screen->palette.set_mode(terminal_color_mode());
+    screen->renderer.set_background_erase(terminal_background_erase());
+    screen->sgr.build(screen->colors, screen->palette);
+    screen->renderer.invalidate_attributes();
+    return OK;
+}
+
+int init_pair(short id, short fg, short bg)
+{
+    if (id < 1 || id > COLOR_PAIRS - 1 || fg > COLORS || bg > COLORS)
+    {
+        return ERR;
+    }
+    const short lowest = screen->default_colors ? -1 : COLOR_BLACK;
+    if (fg < lowest || bg < lowest)
+    {
+        return ERR;
+    }
+
+    screen->colors[id] = {
         .fg = fg,
         .bg = bg
     };
+    screen->sgr.build(id, screen->colors[id], screen->palette);
+    screen->renderer.invalidate_attributes();
     return OK;
 }
 
 bool has_colors()
 {
-    // TODO: terminal type detector
-    return TRUE;
+    // Without terminal description ANSI colors are assumed
+    return !screen->terminfo.loaded() || screen->terminfo.number(msos::curses::Number::max_colors) > 0
+        || screen->features.direct_color;
 }
 
 int init_color(short color, short r, short g, short b)
 {
-    static_cast<void>(color);
-    static_cast<void>(r);
-    static_cast<void>(g);
-    static_cast<void>(b);
-    // TODO: color manipulation implementation
-    return ERR;
+    if (screen->palette.set(color, r, g, b) != OK)
+    {
+        return ERR;
+    }
+
+    for (short pair = 1; pair < COLOR_PAIRS; ++pair)
+    {
+        if (screen->colors[pair].fg == color || screen->colors[pair].bg == color)
+        {
+            screen->sgr.build(pair, screen->colors[pair], screen->palette);
+        }
+    }
+    screen->renderer.invalidate_attributes();
+    return OK;
 }
 
 bool can_change_color(void)
 {
-    // TODO: terminal type detector, color support
-    return FALSE;
+    // Without direct colors init_color is approximated with nearest color
+    return screen->palette.mode() == msos::curses::ColorMode::direct;
+}
+
+int color_content(short color, short* r, short* g, short* b)
+{
+    return screen->palette.get(color, r, g, b);
+}
+
+int use_default_colors(void)
+{
+    return assume_default_colors(-1, -1);
+}
+
+int assume_default_colors(int fg, int bg)
+{
+    if (fg < -1 || bg < -1 || fg > COLORS || bg > COLORS)
+    {
+        return ERR;
+    }
+
+    screen->default_colors = true;
+    screen->colors[0] = {
+        .fg = static_cast<short>(fg),
+        .bg = static_cast<short>(bg)
+    };
+    screen->sgr.build(0, screen->colors[0], screen->palette);
+    screen->renderer.invalidate_attributes();
+    return OK;
 }
 
 int pair_content(short pair, short* foreground, short* background)
@@ -375,7 +2599,273 @@ int pair_content(short pair, short* foreground, short* background)
         return ERR;
     }
 
-    *foreground = colors[pair].fg;
-    *background = colors[pair].bg;
+    *foreground = screen->colors[pair].fg;
+    *background = screen->colors[pair].bg;
+    return OK;
+}
+
+//-------------------------------------------//
+//------         TERMINFO             -------//
+//-------------------------------------------//
+
+int setupterm(const char* term, int filedes, int* errret)
+{
+    if (term == nullptr)
+    {
+        term = std::getenv("TERM");
+    }
+    if (term != screen->terminal_name)
+    {
+        std::snprintf(screen->terminal_name, sizeof(screen->terminal_name), "%s", term != nullptr ? term : "");
+    }
+
+    const bool loaded = screen->terminfo.load(screen->terminal_name);
+    read_line_speed(filedes);
+    apply_terminfo();
+    if (errret != nullptr)
+    {
+        *errret = loaded ? 1 : 0;
+    }
+    return loaded ? OK : ERR;
+}
+
+int setterm(const char* term)
+{
+    return setupterm(term, STDOUT_FILENO, nullptr);
+}
+
+int tigetflag(const char* capname)
+{
+    return screen->terminfo.flag(capname);
+}
+
+int tigetnum(const char* capname)
+{
+    return screen->terminfo.number(capname);
+}
+
+char* tigetstr(const char* capname)
+{
+    bool known = false;
+    const char* value = screen->terminfo.string(capname, &known);
+    if (!known)
+    {
+        return reinterpret_cast<char*>(-1);
+    }
+    // Entry is mapped read only, callers must not modify strings
+    return const_cast<char*>(value);
+}
+
+int tputs(const char* str, int affcnt, int (*putc)(int))
+{
+    if (str == nullptr || putc == nullptr)
+    {
+        return ERR;
+    }
+
+    const auto output = [putc](const char* data, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            putc(static_cast<unsigned char>(data[i]));
+        }
+    };
+    msos::curses::split_padding(str, std::max(affcnt, 1), output, [putc](int tenths, bool mandatory) {
+        const msos::curses::LineSpeed& speed = screen->line_speed;
+        if (!speed.pad_character && speed.padding && (mandatory || !speed.flow_control))
+        {
+            // Caller owns output, delay is waited for instead of sent
+            napms(tenths / 10);
+            return;
+        }
+        for (std::size_t i = speed.padding_count(tenths, mandatory); i > 0; --i)
+        {
+            putc(static_cast<unsigned char>(speed.pad));
+        }
+    });
+    return OK;
+}
+
+namespace
+{
+
+// Only arguments used by str are read, with type program expects
+template <typename Integer>
+char* expand_parameterized(const char* str, va_list arguments)
+{
+    const msos::curses::ParameterizedString* program = parameterized_strings.program(str);
+    if (program == nullptr)
+    {
+        return nullptr;
+    }
+
+    msos::curses::Parameter parameters[msos::curses::parameter_count] = {};
+    for (int i = 0; i < program->parameters(); ++i)
+    {
+        if (program->string_parameter(i))
+        {
+            parameters[i].string = va_arg(arguments, const char*);
+        }
+        else
+        {
+            parameters[i].number = va_arg(arguments, Integer);
+        }
+    }
+    // Result is kept for repeated calls, callers must not modify it
+    return const_cast<char*>(parameterized_strings.expand(parameters));
+}
+
+} // namespace
+
+char* tparm(const char* str, ...)
+{
+    va_list arguments;
+    va_start(arguments, str);
+    char* result = expand_parameterized<long>(str, arguments);
+    va_end(arguments);
+    return result;
+}
+
+char* tiparm(const char* str, ...)
+{
+    va_list arguments;
+    va_start(arguments, str);
+    char* result = expand_parameterized<int>(str, arguments);
+    va_end(arguments);
+    return result;
+}
+
+int putp(const char* str)
+{
+    if (str == nullptr)
+    {
+        return ERR;
+    }
+    emit_capability(str);
+    return OK;
+}
+
+char* tgoto(const char* cap, int col, int row)
+{
+    if (parameterized_strings.program(cap) == nullptr)
+    {
+        return nullptr;
+    }
+    const msos::curses::Parameter parameters[msos::curses::parameter_count] = {{row, nullptr}, {col, nullptr}};
+    return const_cast<char*>(parameterized_strings.expand(parameters));
+}
+
+int tgetent(char* bp, const char* name)
+{
+    static_cast<void>(bp);
+    return setupterm(name, STDOUT_FILENO, nullptr) == OK ? 1 : 0;
+}
+
+int tgetflag(const char* id)
+{
+    return screen->terminfo.flag(id, msos::curses::Naming::termcap) > 0 ? 1 : 0;
+}
+
+int tgetnum(const char* id)
+{
+    const int value = screen->terminfo.number(id, msos::curses::Naming::termcap);
+    return value < 0 ? -1 : value;
+}
+
+char* tgetstr(const char* id, char** area)
+{
+    bool known = false;
+    const char* value = screen->terminfo.string(id, &known, msos::curses::Naming::termcap);
+    if (value == nullptr)
+    {
+        return nullptr;
+    }
+    if (area == nullptr || *area == nullptr)
+    {
+        return const_cast<char*>(value);
+    }
+
+    // Termcap interface copies strings into area given by caller
+    char* copy = *area;
+    std::strcpy(copy, value);
+    *area += std::strlen(value) + 1;
+    return copy;
+}
+
+int baudrate(void)
+{
+    return screen->line_speed.baudrate;
+}
+
+int delay_output(int ms)
+{
+    if (ms < 0)
+    {
+        return ERR;
+    }
+    if (screen->line_speed.pad_character)
+    {
+        emit_padding(screen->line_speed.pad_count(ms * 10));
+        return OK;
+    }
+    flush_output();
+    return napms(ms);
+}
+
+int napms(int ms)
+{
+    struct timespec delay = {
+        .tv_sec = ms / 1000,
+        .tv_nsec = (ms % 1000) * 1000000L
+    };
+    // Remaining time is written back when sleep is interrupted by signal
+    while (ms > 0 && nanosleep(&delay, &delay) != 0 && errno == EINTR)
+    {
+    }
     return OK;
 }
+
+char* termname(void)
+{
+    return screen->terminal_name;
+}
+
+char* longname(void)
+{
+    static char description[128];
+    const char* names = screen->terminfo.names();
+    const char* last = names != nullptr ? std::strrchr(names, '|') : nullptr;
+    std::snprintf(description, sizeof(description), "%s", last != nullptr ? last + 1 : (names != nullptr ? names : ""));
+    return description;
+}
+
+bool has_ic(void)
+{
+    using msos::curses::String;
+    return screen->terminfo.string(String::insert_character) != nullptr
+        || screen->terminfo.string(String::parm_ich) != nullptr
+        || screen->terminfo.string(String::enter_insert_mode) != nullptr;
+}
+
+bool has_il(void)
+{
+    using msos::curses::String;
+    return screen->terminfo.string(String::insert_line) != nullptr
+        || screen->terminfo.string(String::parm_insert_line) != nullptr
+        || screen->terminfo.string(String::change_scroll_region) != nullptr;
+}
+
+chtype termattrs(void)
+{
+    using msos::curses::String;
+    if (!screen->terminfo.loaded())
+    {
+        return static_cast<chtype>(A_BOLD | A_UNDERLINE | A_REVERSE | A_ALTCHARSET);
+    }
+
+    unsigned attributes = 0;
+    attributes |= screen->terminfo.string(String::enter_bold_mode) != nullptr ? A_BOLD : 0;
+    attributes |= screen->terminfo.string(String::enter_underline_mode) != nullptr ? A_UNDERLINE : 0;
+    attributes |= screen->terminfo.string(String::enter_reverse_mode) != nullptr ? A_REVERSE : 0;
+    attributes |= screen->terminfo.string(String::enter_alt_charset_mode) != nullptr ? A_ALTCHARSET : 0;
+    return static_cast<chtype>(attributes);
+}
@@ -0,0 +1,142 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "terminfo_names.hpp"
+
+namespace msos::curses
+{
+
+struct NumberValue
+{
+    Number capability;
+    int value;
+};
+
+struct StringValue
+{
+    String capability;
+    const char* value;
+};
+
+// Terminal capabilities known at compile time. Lookups with constant
+// arguments fold into constants, no entry is parsed at run time.
+class Description
+{
+public:
+    template <std::size_t B, std::size_t N, std::size_t S>
+    constexpr Description(const char* names, const Boolean (&booleans)[B], const NumberValue (&numbers)[N],
+        const StringValue (&strings)[S])
+        : names_(names)
+        , booleans_(booleans)
+        , numbers_(numbers)
+        , strings_(strings)
+        , boolean_count_(B)
+        , number_count_(N)
+        , string_count_(S)
+    {
+    }
+
+    // Names separated with '|', last one describes terminal
+    constexpr const char* names() const
+    {
+        return names_;
+    }
+
+    constexpr bool flag(Boolean capability) const
+    {
+        for (std::size_t i = 0; i < boolean_count_; ++i)
+        {
+            if (booleans_[i] == capability)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // -1 when absent
+    constexpr int number(Number capability) const
+    {
+        for (std::size_t i = 0; i < number_count_; ++i)
+        {
+            if (numbers_[i].capability == capability)
+            {
+                return numbers_[i].value;
+            }
+        }
+        return -1;
+    }
+
+    // nullptr when absent
+    constexpr const char* string(String capability) const
+    {
+        for (std::size_t i = 0; i < string_count_; ++i)
+        {
+            if (strings_[i].capability == capability)
+            {
+                return strings_[i].value;
+            }
+        }
+        return nullptr;
+    }
+
+    // True when term is one of names, description is not matched
+    constexpr bool matches(const char* term) const
+    {
+        const char* name = names_;
+        while (true)
+        {
+            const char* end = name;
+            while (*end != 0 && *end != '|')
+            {
+                ++end;
+            }
+            if (*end == 0)
+            {
+                return false;
+            }
+
+            const char* value = term;
+            const char* current = name;
+            while (current != end && *value != 0 && *current == *value)
+            {
+                ++current;
+                ++value;
+            }
+            if (current == end && *value == 0)
+            {
+                return true;
+            }
+            name = end + 1;
+        }
+    }
+
+private:
+    const char* names_;
+    const Boolean* booleans_;
+    const NumberValue* numbers_;
+    const StringValue* strings_;
+    std::size_t boolean_count_;
+    std::size_t number_count_;
+    std::size_t string_count_;
+};
+
+} // namespace msos::curses
@@ -0,0 +1,152 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Commands queued for one screen, must be power of 2
+#ifndef DRAW_QUEUE_SIZE
+    #define DRAW_QUEUE_SIZE 64
+#endif // DRAW_QUEUE_SIZE
+
+// Bytes of text in one command, longer text takes consecutive commands
+#ifndef DRAW_TEXT_SIZE
+    #define DRAW_TEXT_SIZE 24
+#endif // DRAW_TEXT_SIZE
+
+namespace msos::curses
+{
+
+struct DrawCommand
+{
+    enum class Kind : std::uint8_t
+    {
+        text,
+        // Text continued from previous command
+        more_text,
+        move
+    };
+
+    Kind kind;
+    std::uint8_t size;
+    short y;
+    short x;
+    int attributes;
+    char text[DRAW_TEXT_SIZE];
+};
+
+// Bounded queue with many producers and one consumer. Producers claim
+// slots with single compare and swap on position, never lock and never
+// wait for each other. Slots carry sequence numbers telling whether they
+// are free or published, see D. Vyukov bounded MPMC queue.
+class DrawQueue
+{
+public:
+    DrawQueue()
+    {
+        for (std::size_t i = 0; i < DRAW_QUEUE_SIZE; ++i)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    DrawQueue(const DrawQueue&) = delete;
+    DrawQueue& operator=(const DrawQueue&) = delete;
+
+    // Claims count consecutive slots, so commands of one call are not
+    // interleaved with other producers. Fill is called with each slot.
+    // False when queue has no room.
+    template <typename Fill>
+    bool push(std::size_t count, Fill&& fill)
+    {
+        if (count == 0 || count > DRAW_QUEUE_SIZE)
+        {
+            return false;
+        }
+
+        std::size_t position = enqueue_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            bool retry = false;
+            for (std::size_t i = 0; i < count && !retry; ++i)
+            {
+                const std::size_t sequence = slots_[(position + i) & mask].sequence.load(std::memory_order_acquire);
+                const std::intptr_t difference = static_cast<std::intptr_t>(sequence - (position + i));
+                if (difference < 0)
+                {
+                    return false;
+                }
+                retry = difference > 0;
+            }
+
+            if (retry)
+            {
+                position = enqueue_.load(std::memory_order_relaxed);
+            }
+            else if (enqueue_.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            fill(i, slots_[(position + i) & mask].command);
+        }
+        // Head is published last, consumer stops at it until whole group is ready
+        for (std::size_t i = count; i-- > 0;)
+        {
+            slots_[(position + i) & mask].sequence.store(position + i + 1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    // Only one thread may pop. Stops at first slot not published yet, so
+    // commands are taken in order of claiming.
+    bool pop(DrawCommand& command)
+    {
+        Slot& slot = slots_[dequeue_ & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_ + 1)
+        {
+            return false;
+        }
+        command = slot.command;
+        slot.sequence.store(dequeue_ + DRAW_QUEUE_SIZE, std::memory_order_release);
+        ++dequeue_;
+        return true;
+    }
+
+private:
+    static_assert((DRAW_QUEUE_SIZE & (DRAW_QUEUE_SIZE - 1)) == 0, "DRAW_QUEUE_SIZE must be power of 2");
+    static constexpr std::size_t mask = DRAW_QUEUE_SIZE - 1;
+
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        DrawCommand command;
+    };
+
+    Slot slots_[DRAW_QUEUE_SIZE];
+    // Producers and consumer write different lines
+    alignas(64) std::atomic<std::size_t> enqueue_{0};
+    alignas(64) std::size_t dequeue_ = 0;
+};
+
+} // namespace msos::curses
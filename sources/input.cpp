@@ -0,0 +1,529 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "input.hpp"
+
+#include <algorithm>
+
+#include "curses.h"
+
+#include "unicode.hpp"
+
+namespace msos::curses
+{
+
+namespace
+{
+
+constexpr char escape = '\033';
+constexpr char delete_char = 0x7f;
+constexpr char backspace_char = 0x08;
+
+constexpr char paste_start[] = "\033[200~";
+constexpr char paste_end[] = "\033[201~";
+constexpr std::size_t paste_marker_length = sizeof(paste_start) - 1;
+
+bool is_csi_parameter(char c)
+{
+    return c >= 0x30 && c <= 0x3f;
+}
+
+bool is_csi_intermediate(char c)
+{
+    return c >= 0x20 && c <= 0x2f;
+}
+
+bool is_csi_final(char c)
+{
+    return c >= 0x40 && c <= 0x7e;
+}
+
+int function_key(int number)
+{
+    switch (number)
+    {
+        case 11: return KEY_F(1);
+        case 12: return KEY_F(2);
+        case 13: return KEY_F(3);
+        case 14: return KEY_F(4);
+        case 15: return KEY_F(5);
+        case 17: return KEY_F(6);
+        case 18: return KEY_F(7);
+        case 19: return KEY_F(8);
+        case 20: return KEY_F(9);
+        case 21: return KEY_F(10);
+        case 23: return KEY_F(11);
+        case 24: return KEY_F(12);
+    }
+    return ERR;
+}
+
+} // namespace
+
+std::size_t InputDecoder::push(const char* data, std::size_t size)
+{
+    return buffer_.push(data, size);
+}
+
+int InputDecoder::pop(bool keypad)
+{
+    incomplete_ = false;
+    if (paste_ready_)
+    {
+        paste_ready_ = false;
+        paste_size_ = 0;
+    }
+
+    if (pushback_size_)
+    {
+        return pushback_[--pushback_size_];
+    }
+
+    int key = no_key;
+    while (key == no_key)
+    {
+        key = decode(keypad);
+    }
+    return key;
+}
+
+int InputDecoder::pop_wide(bool keypad, char32_t* c)
+{
+    if (paste_ready_)
+    {
+        paste_ready_ = false;
+        paste_size_ = 0;
+    }
+
+    if (pushback_size_ == 0 && !in_paste_ && !buffer_.empty())
+    {
+        const unsigned char lead = static_cast<unsigned char>(buffer_.peek(0));
+        const std::size_t length = utf8_length(lead);
+        if (length != 1)
+        {
+            incomplete_ = false;
+            if (length != 0 && buffer_.size() < length && !expired_)
+            {
+                incomplete_ = true;
+                return ERR;
+            }
+
+            expired_ = false;
+            if (length == 0 || buffer_.size() < length)
+            {
+                buffer_.consume(1);
+                *c = replacement_character;
+                return OK;
+            }
+
+            unsigned char sequence[4];
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                sequence[i] = static_cast<unsigned char>(buffer_.peek(i));
+            }
+            *c = utf8_decode(sequence, length);
+            buffer_.consume(*c == replacement_character ? 1 : length);
+            return OK;
+        }
+    }
+
+    const int key = pop(keypad);
+    if (key == ERR)
+    {
+        return ERR;
+    }
+    *c = static_cast<char32_t>(key);
+    return key >= KEY_CODE_YES ? KEY_CODE_YES : OK;
+}
+
+int InputDecoder::decode(bool keypad)
+{
+    if (buffer_.empty())
+    {
+        return ERR;
+    }
+
+    if (in_paste_)
+    {
+        return decode_paste();
+    }
+
+    const char c = buffer_.peek(0);
+    if (c == escape && expired_)
+    {
+        expired_ = false;
+        return pop_byte();
+    }
+
+    if (c == escape && paste_enabled_)
+    {
+        switch (match(paste_start, paste_marker_length))
+        {
+            case Parse::complete:
+            {
+                buffer_.consume(paste_marker_length);
+                in_paste_ = true;
+                return no_key;
+            }
+            case Parse::incomplete:
+            {
+                incomplete_ = true;
+                return ERR;
+            }
+            case Parse::invalid:
+            {
+                break;
+            }
+        }
+    }
+
+    if (!keypad)
+    {
+        return pop_byte();
+    }
+
+    if (c == delete_char || c == backspace_char)
+    {
+        buffer_.consume(1);
+        return KEY_BACKSPACE;
+    }
+
+    if (c != escape)
+    {
+        return pop_byte();
+    }
+    return decode_escape();
+}
+
+int InputDecoder::decode_escape()
+{
+    if (buffer_.size() < 2)
+    {
+        incomplete_ = true;
+        return ERR;
+    }
+
+    const char introducer = buffer_.peek(1);
+    if (introducer == 'O')
+    {
+        if (buffer_.size() < 3)
+        {
+            incomplete_ = true;
+            return ERR;
+        }
+        const int key = decode_ss3(buffer_.peek(2));
+        if (key == ERR)
+        {
+            return pop_byte();
+        }
+        buffer_.consume(3);
+        return key;
+    }
+
+    if (introducer != '[')
+    {
+        return pop_byte();
+    }
+
+    Csi csi;
+    switch (parse_csi(csi))
+    {
+        case Parse::incomplete:
+        {
+            incomplete_ = true;
+            return ERR;
+        }
+        case Parse::invalid:
+        {
+            return pop_byte();
+        }
+        case Parse::complete:
+        {
+            if (csi.final == 'M' && csi.prefix == 0 && csi.params[0] < 0)
+            {
+                return decode_x10_mouse(csi);
+            }
+            if ((csi.final == 'M' || csi.final == 'm') && csi.prefix == '<')
+            {
+                return decode_sgr_mouse(csi);
+            }
+
+            const int key = decode_csi(csi);
+            if (key == ERR)
+            {
+                return pop_byte();
+            }
+            buffer_.consume(csi.length);
+            return key;
+        }
+    }
+    return ERR;
+}
+
+void InputDecoder::expire()
+{
+    if (incomplete_)
+    {
+        expired_ = true;
+        incomplete_ = false;
+    }
+}
+
+MouseEvents& InputDecoder::mouse()
+{
+    return mouse_;
+}
+
+void InputDecoder::set_bracketed_paste(bool enabled)
+{
+    paste_enabled_ = enabled;
+}
+
+const char* InputDecoder::paste(std::size_t* size) const
+{
+    *size = paste_ready_ ? paste_size_ : 0;
+    return paste_ready_ ? paste_ : nullptr;
+}
+
+int InputDecoder::unget(int key)
+{
+    if (pushback_size_ == INPUT_PUSHBACK_SIZE)
+    {
+        return ERR;
+    }
+    pushback_[pushback_size_++] = key;
+    return OK;
+}
+
+bool InputDecoder::incomplete() const
+{
+    return incomplete_;
+}
+
+bool InputDecoder::empty() const
+{
+    return buffer_.empty() && pushback_size_ == 0;
+}
+
+std::size_t InputDecoder::free_space() const
+{
+    return buffer_.free_space();
+}
+
+void InputDecoder::clear()
+{
+    buffer_.clear();
+    mouse_.clear();
+    pushback_size_ = 0;
+    incomplete_ = false;
+    expired_ = false;
+    paste_size_ = 0;
+    paste_ready_ = false;
+    in_paste_ = false;
+}
+
+int InputDecoder::decode_paste()
+{
+    // Payload is copied in bulk, only ESC needs a closer look
+    while (!buffer_.empty())
+    {
+        if (paste_size_ == PASTE_BUFFER_SIZE)
+        {
+            paste_ready_ = true;
+            return KEY_PASTE;
+        }
+
+        const char c = buffer_.peek(0);
+        if (c == escape && !expired_)
+        {
+            const Parse end = match(paste_end, paste_marker_length);
+            if (end == Parse::complete)
+            {
+                buffer_.consume(paste_marker_length);
+                in_paste_ = false;
+                paste_ready_ = true;
+                return KEY_PASTE;
+            }
+            if (end == Parse::incomplete)
+            {
+                incomplete_ = true;
+                return ERR;
+            }
+        }
+        expired_ = false;
+        paste_[paste_size_++] = c;
+        buffer_.consume(1);
+    }
+    return ERR;
+}
+
+InputDecoder::Parse InputDecoder::match(const char* pattern, std::size_t length) const
+{
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        if (i == buffer_.size())
+        {
+            return Parse::incomplete;
+        }
+        if (buffer_.peek(i) != pattern[i])
+        {
+            return Parse::invalid;
+        }
+    }
+    return Parse::complete;
+}
+
+int InputDecoder::pop_byte()
+{
+    const char c = buffer_.peek(0);
+    buffer_.consume(1);
+    return static_cast<unsigned char>(c);
+}
+
+InputDecoder::Parse InputDecoder::parse_csi(Csi& csi) const
+{
+    csi.prefix = 0;
+    csi.params_count = 0;
+    csi.final = 0;
+
+    std::size_t position = 2;
+    if (position < buffer_.size())
+    {
+        const char c = buffer_.peek(position);
+        if (c == '<' || c == '=' || c == '>' || c == '?')
+        {
+            csi.prefix = c;
+            ++position;
+        }
+    }
+
+    int value = -1;
+    for (; position < buffer_.size(); ++position)
+    {
+        if (position >= max_csi_length)
+        {
+            return Parse::invalid;
+        }
+
+        const char c = buffer_.peek(position);
+        if (c >= '0' && c <= '9')
+        {
+            value = std::min((value < 0 ? 0 : value * 10) + (c - '0'), max_csi_value);
+        }
+        else if (c == ';' || is_csi_final(c))
+        {
+            if (csi.params_count < max_csi_params)
+            {
+                csi.params[csi.params_count++] = value;
+            }
+            value = -1;
+            if (c != ';')
+            {
+                csi.final = c;
+                csi.length = position + 1;
+                return Parse::complete;
+            }
+        }
+        else if (!is_csi_parameter(c) && !is_csi_intermediate(c))
+        {
+            return Parse::invalid;
+        }
+    }
+    return Parse::incomplete;
+}
+
+int InputDecoder::decode_csi(const Csi& csi) const
+{
+    if (csi.prefix != 0)
+    {
+        return ERR;
+    }
+
+    switch (csi.final)
+    {
+        case 'A': return KEY_UP;
+        case 'B': return KEY_DOWN;
+        case 'C': return KEY_RIGHT;
+        case 'D': return KEY_LEFT;
+        case 'H': return KEY_HOME;
+        case 'F': return KEY_END;
+        case 'Z': return KEY_BTAB;
+        case '~': break;
+        default: return ERR;
+    }
+
+    switch (csi.params[0])
+    {
+        case 1:
+        case 7: return KEY_HOME;
+        case 2: return KEY_IC;
+        case 3: return KEY_DC;
+        case 4:
+        case 8: return KEY_END;
+        case 5: return KEY_PPAGE;
+        case 6: return KEY_NPAGE;
+    }
+    return function_key(csi.params[0]);
+}
+
+int InputDecoder::decode_x10_mouse(const Csi& csi)
+{
+    // ESC [ M followed by button, column and row, each offset by 32
+    if (buffer_.size() < csi.length + 3)
+    {
+        incomplete_ = true;
+        return ERR;
+    }
+
+    const int code = static_cast<unsigned char>(buffer_.peek(csi.length)) - 32;
+    const int x = static_cast<unsigned char>(buffer_.peek(csi.length + 1)) - 33;
+    const int y = static_cast<unsigned char>(buffer_.peek(csi.length + 2)) - 33;
+    buffer_.consume(csi.length + 3);
+    return mouse_.report(code, x, y, false) ? KEY_MOUSE : no_key;
+}
+
+int InputDecoder::decode_sgr_mouse(const Csi& csi)
+{
+    // ESC [ < button ; column ; row M, lowercase m for release
+    buffer_.consume(csi.length);
+    if (csi.params_count != 3 || csi.params[0] < 0 || csi.params[1] < 1 || csi.params[2] < 1)
+    {
+        return no_key;
+    }
+    const bool released = csi.final == 'm';
+    return mouse_.report(csi.params[0], csi.params[1] - 1, csi.params[2] - 1, released) ? KEY_MOUSE : no_key;
+}
+
+int InputDecoder::decode_ss3(char c) const
+{
+    switch (c)
+    {
+        case 'A': return KEY_UP;
+        case 'B': return KEY_DOWN;
+        case 'C': return KEY_RIGHT;
+        case 'D': return KEY_LEFT;
+        case 'H': return KEY_HOME;
+        case 'F': return KEY_END;
+        case 'M': return KEY_ENTER;
+        case 'P': return KEY_F(1);
+        case 'Q': return KEY_F(2);
+        case 'R': return KEY_F(3);
+        case 'S': return KEY_F(4);
+    }
+    return ERR;
+}
+
+} // namespace msos::curses
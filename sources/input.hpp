@@ -0,0 +1,122 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+
+#include "mouse.hpp"
+#include "ring_buffer.hpp"
+
+#ifndef INPUT_BUFFER_SIZE
+    #define INPUT_BUFFER_SIZE 128
+#endif // INPUT_BUFFER_SIZE
+
+#ifndef PASTE_BUFFER_SIZE
+    #define PASTE_BUFFER_SIZE 1024
+#endif // PASTE_BUFFER_SIZE
+
+#ifndef INPUT_PUSHBACK_SIZE
+    #define INPUT_PUSHBACK_SIZE 4
+#endif // INPUT_PUSHBACK_SIZE
+
+namespace msos::curses
+{
+
+// Incremental decoder from raw terminal bytes to curses key codes.
+// Input may be delivered in arbitrary chunks, bytes of unfinished escape
+// sequences are kept until the rest arrives or the caller gives up waiting.
+class InputDecoder
+{
+public:
+    std::size_t push(const char* data, std::size_t size);
+
+    // Next key or ERR when nothing complete is buffered
+    int pop(bool keypad);
+
+    // Like pop, but UTF-8 sequences are assembled into single character.
+    // Returns OK for characters, KEY_CODE_YES for keys or ERR.
+    int pop_wide(bool keypad, char32_t* c);
+
+    // Gives up waiting for rest of escape sequence, used when ESCDELAY expires.
+    // Buffered prefix is decoded as plain characters.
+    void expire();
+
+    int unget(int key);
+
+    MouseEvents& mouse();
+
+    void set_bracketed_paste(bool enabled);
+    // Payload of last KEY_PASTE, valid until next key is popped
+    const char* paste(std::size_t* size) const;
+
+    // True when buffered bytes are a prefix of an escape sequence
+    bool incomplete() const;
+    bool empty() const;
+    std::size_t free_space() const;
+    void clear();
+
+private:
+    constexpr static std::size_t max_csi_length = 32;
+    constexpr static std::size_t max_csi_params = 4;
+    // Larger parameters are clamped, no key or report uses them
+    constexpr static int max_csi_value = 9999;
+
+    struct Csi
+    {
+        char prefix;
+        int params[max_csi_params];
+        std::size_t params_count;
+        char final;
+        std::size_t length;
+    };
+
+    enum class Parse
+    {
+        complete,
+        incomplete,
+        invalid
+    };
+
+    // Returned by decode when bytes were consumed without producing a key
+    constexpr static int no_key = -2;
+
+    int decode(bool keypad);
+    int decode_escape();
+    Parse parse_csi(Csi& csi) const;
+    int decode_csi(const Csi& csi) const;
+    int decode_ss3(char c) const;
+    int decode_x10_mouse(const Csi& csi);
+    int decode_sgr_mouse(const Csi& csi);
+    int decode_paste();
+    Parse match(const char* pattern, std::size_t length) const;
+    int pop_byte();
+
+    RingBuffer<INPUT_BUFFER_SIZE> buffer_;
+    MouseEvents mouse_;
+    int pushback_[INPUT_PUSHBACK_SIZE];
+    std::size_t pushback_size_ = 0;
+    bool incomplete_ = false;
+    bool expired_ = false;
+
+    char paste_[PASTE_BUFFER_SIZE];
+    std::size_t paste_size_ = 0;
+    bool paste_enabled_ = false;
+    bool paste_ready_ = false;
+    bool in_paste_ = false;
+};
+
+} // namespace msos::curses
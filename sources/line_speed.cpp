@@ -0,0 +1,91 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "line_speed.hpp"
+
+#include <iterator>
+
+namespace msos::curses
+{
+
+namespace
+{
+
+struct Speed
+{
+    speed_t code;
+    int baudrate;
+};
+
+// Codes are not numeric on every system, faster ones are optional
+constexpr Speed speeds[] = {
+    {B50, 50},
+    {B75, 75},
+    {B110, 110},
+    {B134, 134},
+    {B150, 150},
+    {B200, 200},
+    {B300, 300},
+    {B600, 600},
+    {B1200, 1200},
+    {B1800, 1800},
+    {B2400, 2400},
+    {B4800, 4800},
+    {B9600, 9600},
+    {B19200, 19200},
+    {B38400, 38400},
+#ifdef B57600
+    {B57600, 57600},
+#endif // B57600
+#ifdef B115200
+    {B115200, 115200},
+#endif // B115200
+#ifdef B230400
+    {B230400, 230400},
+#endif // B230400
+#ifdef B460800
+    {B460800, 460800},
+#endif // B460800
+#ifdef B921600
+    {B921600, 921600},
+#endif // B921600
+#ifdef B1000000
+    {B1000000, 1000000},
+#endif // B1000000
+#ifdef B2000000
+    {B2000000, 2000000},
+#endif // B2000000
+#ifdef B4000000
+    {B4000000, 4000000},
+#endif // B4000000
+};
+
+} // namespace
+
+int baudrate_of(speed_t speed)
+{
+    for (const Speed& known : speeds)
+    {
+        if (known.code == speed)
+        {
+            return known.baudrate;
+        }
+    }
+    return 0;
+}
+
+} // namespace msos::curses
@@ -0,0 +1,63 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+
+#include <termios.h>
+
+// Speed assumed when output line does not report one
+#ifndef CURSES_BAUDRATE
+    #define CURSES_BAUDRATE 115200
+#endif // CURSES_BAUDRATE
+
+namespace msos::curses
+{
+
+// Bits per second of speed code, 0 when code is unknown or hang up
+int baudrate_of(speed_t speed);
+
+// Output line speed and padding rules of terminal. Padding is sent only
+// when line reports its speed, delays are turned into pad characters.
+struct LineSpeed
+{
+    int baudrate = CURSES_BAUDRATE;
+    bool known = false;
+    // Line is at least as fast as padding_baud_rate
+    bool padding = false;
+    // Terminal with xon_xoff needs only mandatory padding
+    bool flow_control = false;
+    // Without pad character delays are waited for instead
+    bool pad_character = true;
+    char pad = 0;
+
+    // Characters line carries in delay, ten bits each
+    std::size_t pad_count(int delay_tenths_ms) const
+    {
+        const long bytes = (static_cast<long>(delay_tenths_ms) * baudrate + 99999) / 100000;
+        return bytes > 0 ? static_cast<std::size_t>(bytes) : 0;
+    }
+
+    // Pad characters for $<> padding of capability
+    std::size_t padding_count(int delay_tenths_ms, bool mandatory) const
+    {
+        return padding && pad_character && (mandatory || !flow_control) ? pad_count(delay_tenths_ms) : 0;
+    }
+};
+
+} // namespace msos::curses
@@ -0,0 +1,156 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "mouse.hpp"
+
+namespace msos::curses
+{
+
+namespace
+{
+
+constexpr int button_mask = 0x03;
+constexpr int shift_flag = 0x04;
+constexpr int alt_flag = 0x08;
+constexpr int ctrl_flag = 0x10;
+constexpr int motion_flag = 0x20;
+constexpr int wheel_flag = 0x40;
+constexpr int x10_release = 3;
+
+mmask_t button_state(int button, mmask_t state)
+{
+    return state << ((button - 1) * 5);
+}
+
+} // namespace
+
+void MouseEvents::set_mask(mmask_t mask)
+{
+    mask_ = mask;
+}
+
+mmask_t MouseEvents::mask() const
+{
+    return mask_;
+}
+
+bool MouseEvents::report(int code, int x, int y, bool released)
+{
+    MEVENT event = {
+        .id = 0,
+        .x = x,
+        .y = y,
+        .z = 0,
+        .bstate = 0
+    };
+
+    if (code & shift_flag)
+    {
+        event.bstate |= BUTTON_SHIFT;
+    }
+    if (code & alt_flag)
+    {
+        event.bstate |= BUTTON_ALT;
+    }
+    if (code & ctrl_flag)
+    {
+        event.bstate |= BUTTON_CTRL;
+    }
+
+    const int button = code & button_mask;
+    if (code & motion_flag)
+    {
+        event.bstate |= REPORT_MOUSE_POSITION;
+    }
+    else if (code & wheel_flag)
+    {
+        event.bstate |= button_state(button + 4, NCURSES_BUTTON_PRESSED);
+    }
+    else if (released || button == x10_release)
+    {
+        const int released_button = button == x10_release ? pressed_button_ : button + 1;
+        event.bstate |= button_state(released_button, NCURSES_BUTTON_RELEASED);
+    }
+    else
+    {
+        pressed_button_ = button + 1;
+        event.bstate |= button_state(pressed_button_, NCURSES_BUTTON_PRESSED);
+    }
+
+    const mmask_t modifiers = BUTTON_SHIFT | BUTTON_ALT | BUTTON_CTRL;
+    if ((event.bstate & ~modifiers & mask_) == 0)
+    {
+        return false;
+    }
+
+    if ((event.bstate & REPORT_MOUSE_POSITION) && size_ != 0)
+    {
+        MEVENT& last = events_[(head_ + size_ - 1) % MOUSE_EVENTS_SIZE];
+        if (last.bstate == event.bstate)
+        {
+            last.x = x;
+            last.y = y;
+            return false;
+        }
+    }
+
+    return push(event);
+}
+
+int MouseEvents::get(MEVENT* event)
+{
+    if (event == nullptr || size_ == 0)
+    {
+        return ERR;
+    }
+    *event = events_[head_];
+    head_ = (head_ + 1) % MOUSE_EVENTS_SIZE;
+    --size_;
+    return OK;
+}
+
+int MouseEvents::unget(const MEVENT* event)
+{
+    // Returned by next getmouse, like KEY_MOUSE pushed back with it
+    if (event == nullptr || size_ == MOUSE_EVENTS_SIZE)
+    {
+        return ERR;
+    }
+    head_ = (head_ + MOUSE_EVENTS_SIZE - 1) % MOUSE_EVENTS_SIZE;
+    events_[head_] = *event;
+    ++size_;
+    return OK;
+}
+
+void MouseEvents::clear()
+{
+    head_ = 0;
+    size_ = 0;
+}
+
+bool MouseEvents::push(const MEVENT& event)
+{
+    // Queued events were reported with KEY_MOUSE already, new one is dropped
+    if (size_ == MOUSE_EVENTS_SIZE)
+    {
+        return false;
+    }
+    events_[(head_ + size_) % MOUSE_EVENTS_SIZE] = event;
+    ++size_;
+    return true;
+}
+
+} // namespace msos::curses
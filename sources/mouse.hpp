@@ -0,0 +1,58 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+
+#include "curses.h"
+
+#ifndef MOUSE_EVENTS_SIZE
+    #define MOUSE_EVENTS_SIZE 8
+#endif // MOUSE_EVENTS_SIZE
+
+namespace msos::curses
+{
+
+// Queue of decoded mouse events waiting for getmouse
+class MouseEvents
+{
+public:
+    void set_mask(mmask_t mask);
+    mmask_t mask() const;
+
+    // Takes button code in xterm encoding with 0-based coordinates.
+    // Returns true when new event was queued and KEY_MOUSE must be reported,
+    // false when event was filtered out, merged with previous motion or
+    // queue is full.
+    bool report(int code, int x, int y, bool released);
+
+    int get(MEVENT* event);
+    // Event goes before queued ones, ERR when queue is full
+    int unget(const MEVENT* event);
+    void clear();
+
+private:
+    bool push(const MEVENT& event);
+
+    MEVENT events_[MOUSE_EVENTS_SIZE];
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    mmask_t mask_ = 0;
+    int pressed_button_ = 1;
+};
+
+} // namespace msos::curses
@@ -0,0 +1,267 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include <unistd.h>
+
+#include "msos/libc/printf.hpp"
+
+#include "curses.h"
+
+namespace msos::curses
+{
+
+// Sinks take bytes of screen output. write returns number of bytes
+// taken, less than size means sink is full and output was lost.
+// system_writes and system_flushes tell whether those reach the system.
+
+// Console of MSOS, printf goes to its UART driver
+struct ConsoleSink
+{
+    constexpr static bool system_writes = true;
+    constexpr static bool system_flushes = false;
+
+    std::size_t write(const char* data, std::size_t size)
+    {
+        printf("%.*s", static_cast<int>(size), data);
+        return size;
+    }
+
+    void flush()
+    {
+        fflush(stdout);
+    }
+};
+
+struct FileSink
+{
+    constexpr static bool system_writes = false;
+    constexpr static bool system_flushes = true;
+
+    std::FILE* file;
+
+    std::size_t write(const char* data, std::size_t size)
+    {
+        const std::size_t written = std::fwrite(data, 1, size, file);
+        if (written != size)
+        {
+            std::clearerr(file);
+        }
+        return written;
+    }
+
+    void flush()
+    {
+        fflush(file);
+    }
+};
+
+// Serial line or pty, non-blocking descriptors report backpressure
+struct FdSink
+{
+    constexpr static bool system_writes = true;
+    constexpr static bool system_flushes = false;
+
+    int fd;
+
+    std::size_t write(const char* data, std::size_t size)
+    {
+        std::size_t written = 0;
+        while (written < size)
+        {
+            const ssize_t result = ::write(fd, data + written, size - written);
+            if (result < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (result <= 0)
+            {
+                break;
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        return written;
+    }
+
+    void flush()
+    {
+    }
+};
+
+struct MemorySink
+{
+    constexpr static bool system_writes = false;
+    constexpr static bool system_flushes = false;
+
+    char* data;
+    std::size_t capacity;
+    std::size_t size;
+
+    std::size_t write(const char* bytes, std::size_t count)
+    {
+        const std::size_t taken = count < capacity - size ? count : capacity - size;
+        std::memcpy(data + size, bytes, taken);
+        size += taken;
+        return taken;
+    }
+
+    void flush()
+    {
+    }
+};
+
+struct CallbackSink
+{
+    constexpr static bool system_writes = false;
+    constexpr static bool system_flushes = false;
+
+    output_callback callback;
+    void* context;
+
+    std::size_t write(const char* data, std::size_t size)
+    {
+        const int taken = callback(context, data, static_cast<int>(size));
+        return taken > 0 ? static_cast<std::size_t>(taken) : 0;
+    }
+
+    void flush()
+    {
+    }
+};
+
+// One of sinks above, chosen per screen. visit switches over kind and
+// calls function instantiated for that sink type, so writing makes no
+// indirect calls and each sink is inlined into its branch.
+class OutputSink
+{
+public:
+    enum class Kind
+    {
+        console,
+        file,
+        fd,
+        memory,
+        callback
+    };
+
+    OutputSink()
+        : kind_(Kind::console)
+        , console_()
+    {
+    }
+
+    explicit OutputSink(const FileSink& sink)
+        : kind_(Kind::file)
+        , file_(sink)
+    {
+    }
+
+    explicit OutputSink(const FdSink& sink)
+        : kind_(Kind::fd)
+        , fd_(sink)
+    {
+    }
+
+    explicit OutputSink(const MemorySink& sink)
+        : kind_(Kind::memory)
+        , memory_(sink)
+    {
+    }
+
+    explicit OutputSink(const CallbackSink& sink)
+        : kind_(Kind::callback)
+        , callback_(sink)
+    {
+    }
+
+    Kind kind() const
+    {
+        return kind_;
+    }
+
+    // Bytes held by memory sink, other sinks keep nothing
+    std::size_t stored() const
+    {
+        return kind_ == Kind::memory ? memory_.size : 0;
+    }
+
+    template <typename Function>
+    decltype(auto) visit(Function&& function)
+    {
+        switch (kind_)
+        {
+            case Kind::file:
+                return function(file_);
+            case Kind::fd:
+                return function(fd_);
+            case Kind::memory:
+                return function(memory_);
+            case Kind::callback:
+                return function(callback_);
+            case Kind::console:
+                break;
+        }
+        return function(console_);
+    }
+
+    std::size_t write(const char* data, std::size_t size)
+    {
+        return visit([data, size](auto& sink) {
+            return sink.write(data, size);
+        });
+    }
+
+    void flush()
+    {
+        visit([](auto& sink) {
+            sink.flush();
+        });
+    }
+
+    bool system_writes()
+    {
+        return visit([](const auto& sink) {
+            return sink.system_writes;
+        });
+    }
+
+    bool system_flushes()
+    {
+        return visit([](const auto& sink) {
+            return sink.system_flushes;
+        });
+    }
+
+private:
+    Kind kind_;
+    union
+    {
+        ConsoleSink console_;
+        FileSink file_;
+        FdSink fd_;
+        MemorySink memory_;
+        CallbackSink callback_;
+    };
+};
+
+} // namespace msos::curses
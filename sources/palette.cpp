@@ -0,0 +1,233 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "palette.hpp"
+
+#include <cstring>
+
+namespace msos::curses
+{
+
+namespace
+{
+
+constexpr std::uint32_t cache_valid = 0x80000000;
+
+constexpr std::uint8_t basic_levels[][3] = {
+    {0x00, 0x00, 0x00}, {0xcd, 0x00, 0x00}, {0x00, 0xcd, 0x00}, {0xcd, 0xcd, 0x00},
+    {0x00, 0x00, 0xee}, {0xcd, 0x00, 0xcd}, {0x00, 0xcd, 0xcd}, {0xe5, 0xe5, 0xe5},
+    {0x7f, 0x7f, 0x7f}, {0xff, 0x00, 0x00}, {0x00, 0xff, 0x00}, {0xff, 0xff, 0x00},
+    {0x5c, 0x5c, 0xff}, {0xff, 0x00, 0xff}, {0x00, 0xff, 0xff}, {0xff, 0xff, 0xff}
+};
+
+constexpr std::uint8_t cube_levels[] = {0x00, 0x5f, 0x87, 0xaf, 0xd7, 0xff};
+
+// xterm default for 256 color palette: 16 basic colors, 6x6x6 cube and gray ramp
+constexpr std::uint32_t default_rgb(std::size_t index)
+{
+    if (index < 16)
+    {
+        return static_cast<std::uint32_t>(basic_levels[index][0] << 16 | basic_levels[index][1] << 8 | basic_levels[index][2]);
+    }
+    if (index < 232)
+    {
+        const std::size_t cube = index - 16;
+        return static_cast<std::uint32_t>(cube_levels[cube / 36] << 16 | cube_levels[cube / 6 % 6] << 8 | cube_levels[cube % 6]);
+    }
+    const std::uint32_t level = static_cast<std::uint32_t>(8 + (index - 232) * 10);
+    return level << 16 | level << 8 | level;
+}
+
+static_assert(COLORS <= 256, "palette supports up to 256 colors");
+static_assert(default_rgb(196) == 0xff0000);
+static_assert(default_rgb(255) == 0xeeeeee);
+
+short to_curses(std::uint32_t component)
+{
+    return static_cast<short>((component * 1000 + 127) / 255);
+}
+
+std::uint32_t to_terminal(short component)
+{
+    return static_cast<std::uint32_t>((component * 255 + 500) / 1000);
+}
+
+int distance(std::uint32_t a, std::uint32_t b)
+{
+    int sum = 0;
+    for (int shift = 0; shift < 24; shift += 8)
+    {
+        const int difference = static_cast<int>((a >> shift) & 0xff) - static_cast<int>((b >> shift) & 0xff);
+        sum += difference * difference;
+    }
+    return sum;
+}
+
+std::size_t native_colors(ColorMode mode)
+{
+    switch (mode)
+    {
+        case ColorMode::basic:
+            return 8;
+        case ColorMode::bright:
+            return 16;
+        default:
+            return 256;
+    }
+}
+
+bool contains(const char* str, const char* part)
+{
+    return str != nullptr && std::strstr(str, part) != nullptr;
+}
+
+} // namespace
+
+ColorMode detect_color_mode(const char* term, const char* colorterm)
+{
+    if (contains(colorterm, "truecolor") || contains(colorterm, "24bit") || contains(term, "direct"))
+    {
+        return ColorMode::direct;
+    }
+    if (contains(term, "256color"))
+    {
+        return ColorMode::indexed;
+    }
+    if (contains(term, "16color"))
+    {
+        return ColorMode::bright;
+    }
+    return ColorMode::basic;
+}
+
+bool detect_background_erase(const char* term)
+{
+    if (term == nullptr)
+    {
+        return false;
+    }
+    return std::strncmp(term, "xterm", 5) == 0 || std::strncmp(term, "linux", 5) == 0
+        || std::strncmp(term, "rxvt", 4) == 0 || contains(term, "-bce");
+}
+
+void Palette::reset()
+{
+    for (std::size_t i = 0; i < COLORS; ++i)
+    {
+        const std::uint32_t rgb = default_rgb(i);
+        colors_[i] = {to_curses(rgb >> 16), to_curses((rgb >> 8) & 0xff), to_curses(rgb & 0xff)};
+        redefined_[i] = false;
+    }
+    set_mode(ColorMode::basic);
+}
+
+void Palette::set_mode(ColorMode mode)
+{
+    mode_ = mode;
+    std::memset(cache_, 0, sizeof(cache_));
+}
+
+ColorMode Palette::mode() const
+{
+    return mode_;
+}
+
+int Palette::set(short color, short r, short g, short b)
+{
+    const int index = color - COLOR_BLACK;
+    if (index < 0 || index >= COLORS)
+    {
+        return ERR;
+    }
+    if (r < 0 || r > 1000 || g < 0 || g > 1000 || b < 0 || b > 1000)
+    {
+        return ERR;
+    }
+
+    colors_[index] = {r, g, b};
+    redefined_[index] = true;
+    return OK;
+}
+
+int Palette::get(short color, short* r, short* g, short* b) const
+{
+    const int index = color - COLOR_BLACK;
+    if (index < 0 || index >= COLORS)
+    {
+        return ERR;
+    }
+
+    *r = colors_[index].r;
+    *g = colors_[index].g;
+    *b = colors_[index].b;
+    return OK;
+}
+
+ColorCode Palette::code(short color) const
+{
+    const std::size_t index = static_cast<std::size_t>(color - COLOR_BLACK);
+    const Rgb& value = colors_[index];
+    const std::uint32_t rgb = to_terminal(value.r) << 16 | to_terminal(value.g) << 8 | to_terminal(value.b);
+    if (mode_ == ColorMode::direct && redefined_[index])
+    {
+        return {ColorMode::direct, 0, static_cast<std::uint8_t>(rgb >> 16),
+            static_cast<std::uint8_t>(rgb >> 8), static_cast<std::uint8_t>(rgb)};
+    }
+
+    const bool native = !redefined_[index] && index < native_colors(mode_);
+    const std::uint8_t code = native ? static_cast<std::uint8_t>(index) : nearest(rgb);
+    ColorMode code_mode = ColorMode::indexed;
+    if (code < 8)
+    {
+        code_mode = ColorMode::basic;
+    }
+    else if (code < 16)
+    {
+        code_mode = ColorMode::bright;
+    }
+    return {code_mode, code, 0, 0, 0};
+}
+
+std::uint8_t Palette::nearest(std::uint32_t rgb) const
+{
+    // Gradients repeat the same few colors, so search results are memoized
+    CacheEntry& entry = cache_[(rgb * 2654435761u >> 16) % NEAREST_COLOR_CACHE_SIZE];
+    if (entry.key == (rgb | cache_valid))
+    {
+        return entry.index;
+    }
+
+    // Basic colors depend on terminal theme, 256 color palette does not
+    const std::size_t first = mode_ == ColorMode::basic || mode_ == ColorMode::bright ? 0 : 16;
+    const std::size_t candidates = native_colors(mode_);
+    std::size_t best = first;
+    int best_distance = distance(rgb, default_rgb(first));
+    for (std::size_t i = first + 1; i < candidates && best_distance != 0; ++i)
+    {
+        const int current = distance(rgb, default_rgb(i));
+        if (current < best_distance)
+        {
+            best = i;
+            best_distance = current;
+        }
+    }
+
+    entry.key = rgb | cache_valid;
+    entry.index = static_cast<std::uint8_t>(best);
+    return entry.index;
+}
+
+} // namespace msos::curses
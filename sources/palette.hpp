@@ -0,0 +1,93 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "curses.h"
+
+#ifndef NEAREST_COLOR_CACHE_SIZE
+    #define NEAREST_COLOR_CACHE_SIZE 16
+#endif // NEAREST_COLOR_CACHE_SIZE
+
+namespace msos::curses
+{
+
+// Colors terminal is able to show
+enum class ColorMode
+{
+    basic,   // 8 colors, SGR 30-37
+    bright,  // 16 colors, SGR 90-97 for bright ones
+    indexed, // 256 colors, SGR 38;5
+    direct   // 24-bit colors, SGR 38;2
+};
+
+ColorMode detect_color_mode(const char* term, const char* colorterm);
+
+// Whether erasing fills cells with current background color (bce)
+bool detect_background_erase(const char* term);
+
+// How color is selected in SGR sequence
+struct ColorCode
+{
+    ColorMode mode;
+    std::uint8_t index;
+    std::uint8_t r;
+    std::uint8_t g;
+    std::uint8_t b;
+};
+
+// Contents of COLORS colors, starting with xterm defaults. Colors changed
+// with init_color, or not available in terminal, are replaced with nearest
+// one that terminal can show.
+class Palette
+{
+public:
+    void reset();
+    void set_mode(ColorMode mode);
+    ColorMode mode() const;
+
+    // Components are in range 0-1000, color is COLOR_BLACK based
+    int set(short color, short r, short g, short b);
+    int get(short color, short* r, short* g, short* b) const;
+
+    ColorCode code(short color) const;
+
+private:
+    struct Rgb
+    {
+        short r;
+        short g;
+        short b;
+    };
+
+    struct CacheEntry
+    {
+        std::uint32_t key;
+        std::uint8_t index;
+    };
+
+    std::uint8_t nearest(std::uint32_t rgb) const;
+
+    Rgb colors_[COLORS];
+    bool redefined_[COLORS];
+    ColorMode mode_ = ColorMode::basic;
+    mutable CacheEntry cache_[NEAREST_COLOR_CACHE_SIZE];
+};
+
+} // namespace msos::curses
@@ -0,0 +1,733 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "parameterized_string.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+namespace msos::curses
+{
+
+namespace
+{
+
+enum Operation : std::uint8_t
+{
+    text,              // length, characters
+    push_parameter,    // index
+    push_constant,     // 4 bytes, little endian
+    set_dynamic,       // index
+    set_static,        // index
+    get_dynamic,       // index
+    get_static,        // index
+    print_decimal,
+    print_formatted,   // conversion, flags, width, precision
+    print_character,
+    string_length,
+    increment,
+    add,
+    subtract,
+    multiply,
+    divide,
+    modulo,
+    bit_and,
+    bit_or,
+    bit_xor,
+    equal,
+    greater,
+    less,
+    logical_and,
+    logical_or,
+    logical_not,
+    complement,
+    jump_if_false,     // 2 bytes target
+    jump               // 2 bytes target
+};
+
+constexpr std::uint8_t flag_left = 1;
+constexpr std::uint8_t flag_sign = 2;
+constexpr std::uint8_t flag_alternate = 4;
+constexpr std::uint8_t flag_space = 8;
+constexpr std::uint8_t flag_zero = 16;
+constexpr std::uint8_t no_precision = 0xff;
+
+constexpr int stack_size = 16;
+constexpr int nesting_depth = 4;
+constexpr int else_count = 8;
+
+struct Condition
+{
+    std::size_t false_jump;
+    bool false_pending;
+    std::size_t end_jumps[else_count];
+    int end_jump_count;
+};
+
+Operation binary_operation(char c)
+{
+    switch (c)
+    {
+        case '+': return add;
+        case '-': return subtract;
+        case '*': return multiply;
+        case '/': return divide;
+        case 'm': return modulo;
+        case '&': return bit_and;
+        case '|': return bit_or;
+        case '^': return bit_xor;
+        case '=': return equal;
+        case '>': return greater;
+        case '<': return less;
+        case 'A': return logical_and;
+        case 'O': return logical_or;
+        case '!': return logical_not;
+        case '~': return complement;
+        default: return text;
+    }
+}
+
+// Too long numbers saturate at INT_MAX
+int read_decimal(const char*& str)
+{
+    int value = 0;
+    while (*str >= '0' && *str <= '9')
+    {
+        const int digit = *str - '0';
+        value = value > (INT_MAX - digit) / 10 ? INT_MAX : value * 10 + digit;
+        ++str;
+    }
+    return value;
+}
+
+// Arithmetic wraps around instead of overflowing
+long wrapped(unsigned long value)
+{
+    return static_cast<long>(value);
+}
+
+class Stack
+{
+public:
+    void push(long number, const char* string = nullptr)
+    {
+        if (size_ < stack_size)
+        {
+            values_[size_++] = {number, string};
+        }
+    }
+
+    // Empty stack gives 0, like other implementations
+    Parameter pop()
+    {
+        return size_ > 0 ? values_[--size_] : Parameter{0, nullptr};
+    }
+
+private:
+    Parameter values_[stack_size];
+    int size_ = 0;
+};
+
+class Output
+{
+public:
+    Output(char* data, std::size_t size)
+        : data_(data)
+        , capacity_(size > 0 ? size - 1 : 0)
+        , terminate_(size > 0)
+    {
+    }
+
+    void write(const char* data, std::size_t size)
+    {
+        const std::size_t free = capacity_ - size_;
+        const std::size_t count = size < free ? size : free;
+        std::memcpy(data_ + size_, data, count);
+        size_ += count;
+    }
+
+    void write(char c)
+    {
+        if (size_ < capacity_)
+        {
+            data_[size_++] = c;
+        }
+    }
+
+    void write_decimal(long number)
+    {
+        char digits[24];
+        std::size_t size = 0;
+        unsigned long value = number < 0 ? 0ul - static_cast<unsigned long>(number) : static_cast<unsigned long>(number);
+        do
+        {
+            digits[sizeof(digits) - ++size] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        if (number < 0)
+        {
+            digits[sizeof(digits) - ++size] = '-';
+        }
+        write(digits + sizeof(digits) - size, size);
+    }
+
+    std::size_t finish()
+    {
+        if (terminate_)
+        {
+            data_[size_] = 0;
+        }
+        return size_;
+    }
+
+private:
+    char* data_;
+    std::size_t capacity_;
+    std::size_t size_ = 0;
+    bool terminate_;
+};
+
+void write_formatted(Output& output, const std::uint8_t* operands, const Parameter& value)
+{
+    char format[16];
+    std::size_t size = 0;
+    format[size++] = '%';
+    const std::uint8_t flags = operands[1];
+    if (flags & flag_left)
+    {
+        format[size++] = '-';
+    }
+    if (flags & flag_sign)
+    {
+        format[size++] = '+';
+    }
+    if (flags & flag_alternate)
+    {
+        format[size++] = '#';
+    }
+    if (flags & flag_space)
+    {
+        format[size++] = ' ';
+    }
+    if (flags & flag_zero)
+    {
+        format[size++] = '0';
+    }
+    format[size++] = '*';
+    format[size++] = '.';
+    format[size++] = '*';
+    const char conversion = static_cast<char>(operands[0]);
+    if (conversion != 's')
+    {
+        format[size++] = 'l';
+    }
+    format[size++] = conversion;
+    format[size] = 0;
+
+    const int width = operands[2];
+    // Negative precision is same as no precision
+    const int precision = operands[3] == no_precision ? -1 : operands[3];
+    char buffer[TPARM_OUTPUT_SIZE];
+    const int written = conversion == 's'
+        ? std::snprintf(buffer, sizeof(buffer), format, width, precision, value.string != nullptr ? value.string : "")
+        : std::snprintf(buffer, sizeof(buffer), format, width, precision, value.number);
+    if (written > 0)
+    {
+        output.write(buffer, std::min(static_cast<std::size_t>(written), sizeof(buffer) - 1));
+    }
+}
+
+} // namespace
+
+bool ParameterizedString::emit(std::uint8_t byte)
+{
+    if (code_size_ >= sizeof(code_))
+    {
+        return false;
+    }
+    code_[code_size_++] = byte;
+    return true;
+}
+
+bool ParameterizedString::emit_text(const char* str, std::size_t size)
+{
+    while (size > 0)
+    {
+        const std::size_t part = size < 255 ? size : 255;
+        if (code_size_ + 2 + part > sizeof(code_))
+        {
+            return false;
+        }
+        code_[code_size_++] = text;
+        code_[code_size_++] = static_cast<std::uint8_t>(part);
+        std::memcpy(code_ + code_size_, str, part);
+        code_size_ += part;
+        str += part;
+        size -= part;
+    }
+    return true;
+}
+
+bool ParameterizedString::compile(const char* str)
+{
+    code_size_ = 0;
+    string_parameters_ = 0;
+    parameters_ = 0;
+    pure_ = true;
+    ansi_cursor_address_ = str != nullptr && std::strcmp(str, "\033[%i%p1%d;%p2%dH") == 0;
+    if (str == nullptr)
+    {
+        return false;
+    }
+
+    Condition conditions[nesting_depth];
+    int depth = 0;
+    // Parameter pushed by previous operation, it is string when printed with %s
+    int last_parameter = -1;
+    auto patch = [this](std::size_t position) {
+        code_[position] = static_cast<std::uint8_t>(code_size_ & 0xff);
+        code_[position + 1] = static_cast<std::uint8_t>(code_size_ >> 8);
+    };
+    auto emit_jump = [this](Operation operation, std::size_t& position) {
+        position = code_size_ + 1;
+        return emit(operation) && emit(0) && emit(0);
+    };
+
+    while (*str != 0)
+    {
+        const char* start = str;
+        while (*str != 0 && *str != '%')
+        {
+            ++str;
+        }
+        if (str != start && !emit_text(start, static_cast<std::size_t>(str - start)))
+        {
+            return false;
+        }
+        if (*str == 0)
+        {
+            break;
+        }
+
+        ++str;
+        const int parameter = last_parameter;
+        last_parameter = -1;
+        const char c = *str++;
+        bool ok = true;
+        switch (c)
+        {
+            case '%':
+                ok = emit_text("%", 1);
+                break;
+            case 'p':
+                if (*str < '1' || *str > '9')
+                {
+                    return false;
+                }
+                last_parameter = *str - '1';
+                parameters_ = std::max(parameters_, last_parameter + 1);
+                ok = emit(push_parameter) && emit(static_cast<std::uint8_t>(*str++ - '1'));
+                break;
+            case 'P':
+            case 'g':
+            {
+                const char name = *str++;
+                const bool dynamic = name >= 'a' && name <= 'z';
+                if (!dynamic && (name < 'A' || name > 'Z'))
+                {
+                    return false;
+                }
+                if (!dynamic)
+                {
+                    pure_ = false;
+                }
+                const Operation operation = c == 'P' ? (dynamic ? set_dynamic : set_static)
+                                                     : (dynamic ? get_dynamic : get_static);
+                ok = emit(operation) && emit(static_cast<std::uint8_t>(name - (dynamic ? 'a' : 'A')));
+                break;
+            }
+            case '\'':
+            {
+                const char value = *str++;
+                if (value == 0 || *str++ != '\'')
+                {
+                    return false;
+                }
+                ok = emit(push_constant) && emit(static_cast<std::uint8_t>(value)) && emit(0) && emit(0) && emit(0);
+                break;
+            }
+            case '{':
+            {
+                const bool negative = *str == '-';
+                str += negative;
+                const int value = read_decimal(str);
+                if (*str++ != '}')
+                {
+                    return false;
+                }
+                const std::uint32_t bits = static_cast<std::uint32_t>(negative ? -value : value);
+                ok = emit(push_constant) && emit(static_cast<std::uint8_t>(bits)) && emit(static_cast<std::uint8_t>(bits >> 8))
+                    && emit(static_cast<std::uint8_t>(bits >> 16)) && emit(static_cast<std::uint8_t>(bits >> 24));
+                break;
+            }
+            case 'l':
+                if (parameter >= 0)
+                {
+                    string_parameters_ = static_cast<std::uint16_t>(string_parameters_ | 1u << parameter);
+                }
+                ok = emit(string_length);
+                break;
+            case 'c':
+                ok = emit(print_character);
+                break;
+            case 'i':
+                ok = emit(increment);
+                break;
+            case '?':
+                if (depth == nesting_depth)
+                {
+                    return false;
+                }
+                conditions[depth++] = Condition{0, false, {}, 0};
+                break;
+            case 't':
+                if (depth == 0 || conditions[depth - 1].false_pending)
+                {
+                    return false;
+                }
+                conditions[depth - 1].false_pending = true;
+                ok = emit_jump(jump_if_false, conditions[depth - 1].false_jump);
+                break;
+            case 'e':
+            {
+                if (depth == 0 || conditions[depth - 1].end_jump_count == else_count)
+                {
+                    return false;
+                }
+                Condition& condition = conditions[depth - 1];
+                ok = emit_jump(jump, condition.end_jumps[condition.end_jump_count++]);
+                if (condition.false_pending)
+                {
+                    patch(condition.false_jump);
+                    condition.false_pending = false;
+                }
+                break;
+            }
+            case ';':
+            {
+                if (depth == 0)
+                {
+                    return false;
+                }
+                Condition& condition = conditions[--depth];
+                if (condition.false_pending)
+                {
+                    patch(condition.false_jump);
+                }
+                for (int i = 0; i < condition.end_jump_count; ++i)
+                {
+                    patch(condition.end_jumps[i]);
+                }
+                break;
+            }
+            default:
+            {
+                const Operation operation = binary_operation(c);
+                if (operation != text)
+                {
+                    ok = emit(operation);
+                    break;
+                }
+
+                // %[[:]flags][width[.precision]][doxXs]
+                --str;
+                std::uint8_t flags = 0;
+                const bool colon = *str == ':';
+                str += colon;
+                for (;; ++str)
+                {
+                    std::uint8_t flag = 0;
+                    if (*str == '#')
+                    {
+                        flag = flag_alternate;
+                    }
+                    else if (*str == ' ')
+                    {
+                        flag = flag_space;
+                    }
+                    else if (colon && *str == '-')
+                    {
+                        flag = flag_left;
+                    }
+                    else if (colon && *str == '+')
+                    {
+                        flag = flag_sign;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                    flags = static_cast<std::uint8_t>(flags | flag);
+                }
+                if (*str == '0')
+                {
+                    flags = static_cast<std::uint8_t>(flags | flag_zero);
+                }
+                const int width = read_decimal(str);
+                int precision = no_precision;
+                if (*str == '.')
+                {
+                    ++str;
+                    precision = read_decimal(str);
+                }
+                const char conversion = *str++;
+                if (std::strchr("doxXs", conversion) == nullptr || conversion == 0 || width > 255 || precision > 255)
+                {
+                    return false;
+                }
+                if (conversion == 's' && parameter >= 0)
+                {
+                    string_parameters_ = static_cast<std::uint16_t>(string_parameters_ | 1u << parameter);
+                }
+                if (conversion == 'd' && flags == 0 && width == 0 && precision == no_precision)
+                {
+                    ok = emit(print_decimal);
+                }
+                else
+                {
+                    ok = emit(print_formatted) && emit(static_cast<std::uint8_t>(conversion)) && emit(flags)
+                        && emit(static_cast<std::uint8_t>(width)) && emit(static_cast<std::uint8_t>(precision));
+                }
+                break;
+            }
+        }
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return depth == 0;
+}
+
+std::size_t ParameterizedString::expand(const Parameter* parameters, Variables& variables, char* output,
+    std::size_t size) const
+{
+    Parameter values[parameter_count];
+    std::memcpy(values, parameters, sizeof(values));
+    Stack stack;
+    Output out(output, size);
+    std::memset(variables.dynamic, 0, sizeof(variables.dynamic));
+
+    std::size_t pc = 0;
+    while (pc < code_size_)
+    {
+        const Operation operation = static_cast<Operation>(code_[pc++]);
+        switch (operation)
+        {
+            case text:
+                out.write(reinterpret_cast<const char*>(code_ + pc + 1), code_[pc]);
+                pc += 1u + code_[pc];
+                break;
+            case push_parameter:
+                stack.push(values[code_[pc]].number, values[code_[pc]].string);
+                ++pc;
+                break;
+            case push_constant:
+            {
+                const std::uint32_t bits = static_cast<std::uint32_t>(code_[pc]) | static_cast<std::uint32_t>(code_[pc + 1]) << 8
+                    | static_cast<std::uint32_t>(code_[pc + 2]) << 16 | static_cast<std::uint32_t>(code_[pc + 3]) << 24;
+                stack.push(static_cast<std::int32_t>(bits));
+                pc += 4;
+                break;
+            }
+            case set_dynamic:
+                variables.dynamic[code_[pc++]] = stack.pop().number;
+                break;
+            case set_static:
+                variables.static_[code_[pc++]] = stack.pop().number;
+                break;
+            case get_dynamic:
+                stack.push(variables.dynamic[code_[pc++]]);
+                break;
+            case get_static:
+                stack.push(variables.static_[code_[pc++]]);
+                break;
+            case print_decimal:
+                out.write_decimal(stack.pop().number);
+                break;
+            case print_formatted:
+                write_formatted(out, code_ + pc, stack.pop());
+                pc += 4;
+                break;
+            case print_character:
+            {
+                // NUL cannot be sent in string, terminals take 0200 instead
+                const char c = static_cast<char>(stack.pop().number);
+                out.write(c != 0 ? c : static_cast<char>(0200));
+                break;
+            }
+            case string_length:
+            {
+                const Parameter value = stack.pop();
+                stack.push(value.string != nullptr ? static_cast<long>(std::strlen(value.string)) : 0);
+                break;
+            }
+            case increment:
+                ++values[0].number;
+                ++values[1].number;
+                break;
+            case logical_not:
+                stack.push(!stack.pop().number);
+                break;
+            case complement:
+                stack.push(~stack.pop().number);
+                break;
+            case jump_if_false:
+                pc = stack.pop().number != 0 ? pc + 2 : static_cast<std::size_t>(code_[pc] | code_[pc + 1] << 8);
+                break;
+            case jump:
+                pc = static_cast<std::size_t>(code_[pc] | code_[pc + 1] << 8);
+                break;
+            default:
+            {
+                const long right = stack.pop().number;
+                const long left = stack.pop().number;
+                long result = 0;
+                switch (operation)
+                {
+                    case add: result = wrapped(static_cast<unsigned long>(left) + static_cast<unsigned long>(right)); break;
+                    case subtract: result = wrapped(static_cast<unsigned long>(left) - static_cast<unsigned long>(right)); break;
+                    case multiply: result = wrapped(static_cast<unsigned long>(left) * static_cast<unsigned long>(right)); break;
+                    // LONG_MIN / -1 traps, so -1 divisor negates instead
+                    case divide:
+                        result = right == -1 ? wrapped(0ul - static_cast<unsigned long>(left)) : right != 0 ? left / right : 0;
+                        break;
+                    case modulo: result = right != 0 && right != -1 ? left % right : 0; break;
+                    case bit_and: result = left & right; break;
+                    case bit_or: result = left | right; break;
+                    case bit_xor: result = left ^ right; break;
+                    case equal: result = left == right; break;
+                    case greater: result = left > right; break;
+                    case less: result = left < right; break;
+                    case logical_and: result = left && right; break;
+                    case logical_or: result = left || right; break;
+                    default: break;
+                }
+                stack.push(result);
+                break;
+            }
+        }
+    }
+    return out.finish();
+}
+
+bool ParameterizedString::string_parameter(int index) const
+{
+    return index >= 0 && index < parameter_count && (string_parameters_ >> index & 1) != 0;
+}
+
+int ParameterizedString::parameters() const
+{
+    return parameters_;
+}
+
+bool ParameterizedString::pure() const
+{
+    return pure_ && string_parameters_ == 0;
+}
+
+bool ParameterizedString::ansi_cursor_address() const
+{
+    return ansi_cursor_address_;
+}
+
+const ParameterizedString* ParameterizedStringCache::program(const char* str)
+{
+    current_ = nullptr;
+    if (str == nullptr)
+    {
+        return nullptr;
+    }
+
+    const std::size_t length = std::strlen(str);
+    if (length >= TPARM_SOURCE_SIZE)
+    {
+        scratch_.key = nullptr;
+        scratch_.result_valid = false;
+        current_ = &scratch_;
+        return scratch_.program.compile(str) ? &scratch_.program : nullptr;
+    }
+
+    // Capability strings are aligned by neither database nor compiler
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(str);
+    Entry& entry = entries_[(address ^ address >> 7) & (TPARM_CACHE_SIZE - 1)];
+    if (entry.key != str || std::memcmp(entry.source, str, length + 1) != 0)
+    {
+        entry.key = nullptr;
+        entry.result_valid = false;
+        if (!entry.program.compile(str))
+        {
+            return nullptr;
+        }
+        entry.key = str;
+        std::memcpy(entry.source, str, length + 1);
+    }
+    current_ = &entry;
+    return &entry.program;
+}
+
+const char* ParameterizedStringCache::expand(const Parameter* parameters)
+{
+    if (current_ == nullptr)
+    {
+        return nullptr;
+    }
+
+    Entry& entry = *current_;
+    const bool pure = entry.program.pure();
+    if (pure && entry.result_valid)
+    {
+        bool same = true;
+        for (int i = 0; i < parameter_count && same; ++i)
+        {
+            same = entry.parameters[i].number == parameters[i].number;
+        }
+        if (same)
+        {
+            return entry.result;
+        }
+    }
+
+    entry.program.expand(parameters, variables_, entry.result, sizeof(entry.result));
+    entry.result_valid = pure;
+    std::memcpy(entry.parameters, parameters, sizeof(entry.parameters));
+    return entry.result;
+}
+
+void ParameterizedStringCache::clear()
+{
+    for (Entry& entry : entries_)
+    {
+        entry.key = nullptr;
+        entry.result_valid = false;
+    }
+    current_ = nullptr;
+}
+
+} // namespace msos::curses
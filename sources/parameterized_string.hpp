@@ -0,0 +1,131 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Bytecode of one compiled capability, enough for cup and sgr of common terminals
+#ifndef TPARM_CODE_SIZE
+    #define TPARM_CODE_SIZE 96
+#endif // TPARM_CODE_SIZE
+
+// Expanded capability, longer output is truncated
+#ifndef TPARM_OUTPUT_SIZE
+    #define TPARM_OUTPUT_SIZE 128
+#endif // TPARM_OUTPUT_SIZE
+
+// Compiled capabilities kept by tparm, must be power of 2
+#ifndef TPARM_CACHE_SIZE
+    #define TPARM_CACHE_SIZE 8
+#endif // TPARM_CACHE_SIZE
+
+// Longest capability string kept in cache, longer ones are compiled on each call
+#ifndef TPARM_SOURCE_SIZE
+    #define TPARM_SOURCE_SIZE 64
+#endif // TPARM_SOURCE_SIZE
+
+namespace msos::curses
+{
+
+constexpr int parameter_count = 9;
+
+struct Parameter
+{
+    long number;
+    // Set only for parameters printed with %s or measured with %l
+    const char* string;
+};
+
+// Static variables %PA..%PZ keep their values between expansions
+struct Variables
+{
+    long dynamic[26];
+    long static_[26];
+};
+
+// Capability string with % parameters, compiled once into bytecode, so
+// expanding it does not parse the string again.
+class ParameterizedString
+{
+public:
+    // False when str is malformed or does not fit in TPARM_CODE_SIZE
+    bool compile(const char* str);
+
+    // Writes at most size - 1 characters and terminator, returns length
+    std::size_t expand(const Parameter* parameters, Variables& variables, char* output, std::size_t size) const;
+
+    // Parameter is pushed only to be printed with %s or measured with %l
+    bool string_parameter(int index) const;
+
+    // Highest parameter used, arguments after it are not read
+    int parameters() const;
+
+    // Expansion depends only on parameters
+    bool pure() const;
+
+    // True for "\E[%i%p1%d;%p2%dH", cursor addressing of ANSI terminals
+    bool ansi_cursor_address() const;
+
+private:
+    bool emit(std::uint8_t byte);
+    bool emit_text(const char* text, std::size_t size);
+
+    std::uint8_t code_[TPARM_CODE_SIZE];
+    std::size_t code_size_ = 0;
+    std::uint16_t string_parameters_ = 0;
+    int parameters_ = 0;
+    bool pure_ = true;
+    bool ansi_cursor_address_ = false;
+};
+
+// Compiled capabilities found by address of capability string and
+// verified with its copy. Last parameters and result are remembered, so
+// repeating expansion with the same arguments is a comparison.
+class ParameterizedStringCache
+{
+public:
+    // Program of str, compiled on first use. Valid until next call,
+    // nullptr when str is malformed.
+    const ParameterizedString* program(const char* str);
+
+    // Expands program returned by last call of program(), result is valid
+    // until next expansion
+    const char* expand(const Parameter* parameters);
+
+    void clear();
+
+private:
+    struct Entry
+    {
+        const char* key = nullptr;
+        char source[TPARM_SOURCE_SIZE];
+        ParameterizedString program;
+        bool result_valid = false;
+        Parameter parameters[parameter_count];
+        char result[TPARM_OUTPUT_SIZE];
+    };
+
+    Entry entries_[TPARM_CACHE_SIZE];
+    // Used for strings too long to be cached
+    Entry scratch_;
+    Entry* current_ = nullptr;
+    Variables variables_ = {};
+};
+
+} // namespace msos::curses
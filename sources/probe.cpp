@@ -0,0 +1,229 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "probe.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace msos::curses
+{
+
+namespace
+{
+
+// Cursor position after a space repeated twice with REP tells if REP works
+constexpr int repeated_column = 4;
+// Primary Device Attributes of VT220 and later, these have ECH
+constexpr int vt220_class = 62;
+// Larger parameters are clamped, no reply checked uses them
+constexpr int max_parameter = 9999;
+
+bool contains(const char* data, std::size_t size, const char* value)
+{
+    const std::size_t length = std::strlen(value);
+    for (std::size_t i = 0; i + length <= size; ++i)
+    {
+        if (std::memcmp(data + i, value, length) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+const char* TerminalProbe::query()
+{
+    return "\033[H \033[2b\033[6n"          // REP, Cursor Position Report
+           "\033[?2026$p"                   // synchronized output mode
+           "\033[48;2;1;2;3m\033P$qm\033\\" // direct color, read back with DECRQSS
+           "\033[0m\r\033[K"
+           "\033[>c"                        // secondary Device Attributes
+           "\033[c";                        // primary Device Attributes
+}
+
+void TerminalProbe::push(const char* data, std::size_t size, Forward forward)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        push(data[i], forward);
+    }
+}
+
+void TerminalProbe::finish(Forward forward)
+{
+    if (size_ != 0)
+    {
+        forward(reply_, size_);
+    }
+    size_ = 0;
+    state_ = State::ground;
+}
+
+bool TerminalProbe::complete() const
+{
+    return complete_;
+}
+
+const TerminalFeatures& TerminalProbe::features() const
+{
+    return features_;
+}
+
+void TerminalProbe::push(char c, Forward forward)
+{
+    if (state_ == State::ground)
+    {
+        if (c != '\033')
+        {
+            forward(&c, 1);
+            return;
+        }
+        state_ = State::escape;
+    }
+    else if (size_ == sizeof(reply_))
+    {
+        // Too long to be reply
+        finish(forward);
+        push(c, forward);
+        return;
+    }
+
+    reply_[size_++] = c;
+    bool done = false;
+    switch (state_)
+    {
+        case State::escape:
+            if (size_ == 1)
+            {
+                return;
+            }
+            state_ = c == '[' ? State::control_sequence : c == 'P' ? State::device_control : State::ground;
+            done = state_ == State::ground;
+            break;
+        case State::control_sequence:
+            if (c >= 0x40 && c <= 0x7e)
+            {
+                parse_control_sequence();
+                done = true;
+            }
+            break;
+        case State::device_control:
+            state_ = c == '\033' ? State::device_control_escape : State::device_control;
+            break;
+        case State::device_control_escape:
+            if (c == '\\')
+            {
+                parse_device_control();
+                done = true;
+            }
+            state_ = State::device_control;
+            break;
+        default:
+            break;
+    }
+
+    if (done)
+    {
+        finish(forward);
+    }
+}
+
+void TerminalProbe::parse_control_sequence()
+{
+    const char final = reply_[size_ - 1];
+    const char prefix = reply_[2];
+    bool reply = true;
+    if (final == 'R' && prefix != '?' && prefix != '>')
+    {
+        features_.repeat_character = parameter(1) == repeated_column;
+    }
+    else if (final == 'y' && prefix == '?' && reply_[size_ - 2] == '$' && parameter(0) == 2026)
+    {
+        // 1 set, 2 reset, others mean mode is unknown or permanent
+        const int value = parameter(1);
+        features_.synchronized_output = value == 1 || value == 2;
+    }
+    else if (final == 'c' && prefix == '>')
+    {
+        // Secondary attributes are answered by VT220 compatible terminals only
+        features_.erase_characters = true;
+    }
+    else if (final == 'c' && prefix == '?')
+    {
+        features_.scroll_region = true;
+        features_.erase_characters = features_.erase_characters || parameter(0) >= vt220_class;
+        complete_ = true;
+    }
+    else
+    {
+        reply = false;
+    }
+
+    if (reply)
+    {
+        size_ = 0;
+    }
+}
+
+void TerminalProbe::parse_device_control()
+{
+    // Valid request is answered with DCS 1 $ r, then selected rendition
+    if (size_ > 4 && std::memcmp(reply_ + 2, "1$r", 3) == 0)
+    {
+        features_.direct_color = contains(reply_, size_, "48") && (contains(reply_, size_, "1:2:3")
+            || contains(reply_, size_, "1;2;3"));
+        size_ = 0;
+    }
+    else if (size_ > 4 && std::memcmp(reply_ + 2, "0$r", 3) == 0)
+    {
+        size_ = 0;
+    }
+}
+
+int TerminalProbe::parameter(std::size_t index) const
+{
+    std::size_t i = 2;
+    if (reply_[i] == '?' || reply_[i] == '>')
+    {
+        ++i;
+    }
+
+    for (std::size_t current = 0; i < size_; ++current)
+    {
+        int value = -1;
+        while (i < size_ && reply_[i] >= '0' && reply_[i] <= '9')
+        {
+            value = std::min((value < 0 ? 0 : value * 10) + (reply_[i] - '0'), max_parameter);
+            ++i;
+        }
+        if (current == index)
+        {
+            return value;
+        }
+        if (i >= size_ || reply_[i] != ';')
+        {
+            return -1;
+        }
+        ++i;
+    }
+    return -1;
+}
+
+} // namespace msos::curses
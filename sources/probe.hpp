@@ -0,0 +1,81 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+
+// Longest reply of terminal kept by probe, longer sequences are not replies
+#ifndef PROBE_REPLY_SIZE
+    #define PROBE_REPLY_SIZE 64
+#endif // PROBE_REPLY_SIZE
+
+namespace msos::curses
+{
+
+// Encodings terminal is known to understand, from terminfo or probe
+struct TerminalFeatures
+{
+    bool repeat_character = false;
+    bool erase_characters = false;
+    bool scroll_region = false;
+    bool direct_color = false;
+    bool synchronized_output = false;
+};
+
+// Parses replies to queries sent by probe. Terminals answer in order of
+// queries and every one answers primary Device Attributes, so its reply
+// ends probing. Bytes which are not replies, like keys typed meanwhile,
+// are passed on unchanged.
+class TerminalProbe
+{
+public:
+    using Forward = void (*)(const char* data, std::size_t size);
+
+    // Queries to send, leaves cursor at unknown position on first line
+    static const char* query();
+
+    void push(const char* data, std::size_t size, Forward forward);
+    // Passes on incomplete sequence when terminal stopped answering
+    void finish(Forward forward);
+
+    bool complete() const;
+    const TerminalFeatures& features() const;
+
+private:
+    enum class State
+    {
+        ground,
+        escape,
+        control_sequence,
+        device_control,
+        device_control_escape
+    };
+
+    void push(char c, Forward forward);
+    void parse_control_sequence();
+    void parse_device_control();
+    int parameter(std::size_t index) const;
+
+    State state_ = State::ground;
+    char reply_[PROBE_REPLY_SIZE];
+    std::size_t size_ = 0;
+    bool complete_ = false;
+    TerminalFeatures features_;
+};
+
+} // namespace msos::curses
@@ -0,0 +1,320 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "recorder.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace msos::curses
+{
+
+void Recorder::start(char* buffer, std::size_t capacity)
+{
+    buffer_ = buffer;
+    capacity_ = capacity;
+    size_ = 0;
+    active_ = true;
+    clock_gettime(CLOCK_MONOTONIC, &last_);
+}
+
+std::size_t Recorder::stop()
+{
+    active_ = false;
+    return size_;
+}
+
+const char* Recorder::data() const
+{
+    return buffer_;
+}
+
+std::size_t Recorder::size() const
+{
+    return size_;
+}
+
+bool Recorder::put_number(std::uint64_t value)
+{
+    do
+    {
+        if (size_ == capacity_)
+        {
+            return false;
+        }
+        const std::uint8_t low = static_cast<std::uint8_t>(value & 0x7f);
+        value >>= 7;
+        buffer_[size_++] = static_cast<char>(value != 0 ? low | 0x80 : low);
+    } while (value != 0);
+    return true;
+}
+
+void Recorder::append(Event event, const char* data, std::size_t size)
+{
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const long delta = (now.tv_sec - last_.tv_sec) * 1000000 + (now.tv_nsec - last_.tv_nsec) / 1000;
+    // Time of dropped nanoseconds is carried to next record
+    last_.tv_sec += delta / 1000000;
+    last_.tv_nsec += delta % 1000000 * 1000;
+    if (last_.tv_nsec >= 1000000000)
+    {
+        ++last_.tv_sec;
+        last_.tv_nsec -= 1000000000;
+    }
+
+    const std::size_t start = size_;
+    if (size_ == capacity_)
+    {
+        active_ = false;
+        return;
+    }
+    buffer_[size_++] = static_cast<char>(event);
+    if (!put_number(static_cast<std::uint64_t>(delta > 0 ? delta : 0)) || !put_number(size)
+        || capacity_ - size_ < size)
+    {
+        // Recording keeps only whole records
+        size_ = start;
+        active_ = false;
+        return;
+    }
+    std::memcpy(buffer_ + size_, data, size);
+    size_ += size;
+}
+
+RecordingReader::RecordingReader(const char* data, std::size_t size)
+    : data_(data)
+    , size_(size)
+{
+}
+
+bool RecordingReader::get_number(std::uint64_t& value)
+{
+    value = 0;
+    for (unsigned shift = 0; offset_ < size_ && shift < 64; shift += 7)
+    {
+        const std::uint8_t byte = static_cast<std::uint8_t>(data_[offset_++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RecordingReader::next(Record& record)
+{
+    std::uint64_t delta = 0;
+    std::uint64_t size = 0;
+    if (offset_ == size_)
+    {
+        return false;
+    }
+    record.event = static_cast<Recorder::Event>(data_[offset_++]);
+    if (!get_number(delta) || !get_number(size) || size_ - offset_ < size)
+    {
+        offset_ = size_;
+        return false;
+    }
+    time_us_ += static_cast<unsigned long>(delta);
+    record.time_us = time_us_;
+    record.data = data_ + offset_;
+    record.size = static_cast<std::size_t>(size);
+    offset_ += record.size;
+    return true;
+}
+
+namespace
+{
+
+char short_escape(unsigned char c)
+{
+    switch (c)
+    {
+        case '"':
+        case '\\':
+            return static_cast<char>(c);
+        case '\n':
+            return 'n';
+        case '\r':
+            return 'r';
+        case '\t':
+            return 't';
+        default:
+            return 0;
+    }
+}
+
+class JsonWriter
+{
+public:
+    JsonWriter(output_callback callback, void* context)
+        : callback_(callback)
+        , context_(context)
+    {
+    }
+
+    void write(const char* data, std::size_t size)
+    {
+        if (ok_ && size != 0)
+        {
+            ok_ = callback_(context_, data, static_cast<int>(size)) == static_cast<int>(size);
+        }
+    }
+
+    void write(const char* str)
+    {
+        write(str, std::strlen(str));
+    }
+
+    // Well formed UTF-8 is kept, other bytes are escaped one by one as
+    // if they were Latin-1, so every string is valid JSON
+    void write_string(const char* data, std::size_t size)
+    {
+        std::size_t i = 0;
+        while (i < size)
+        {
+            const unsigned char c = static_cast<unsigned char>(data[i]);
+            const std::size_t length = sequence_length(data + i, size - i);
+            if (length > 1)
+            {
+                write(data + i, length);
+                i += length;
+                continue;
+            }
+
+            char escaped[8];
+            const char shorthand = short_escape(c);
+            if (shorthand != 0)
+            {
+                escaped[0] = '\\';
+                escaped[1] = shorthand;
+                write(escaped, 2);
+            }
+            else if (c < 0x20 || c >= 0x7f)
+            {
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                write(escaped, 6);
+            }
+            else
+            {
+                write(data + i, 1);
+            }
+            ++i;
+        }
+    }
+
+    bool ok() const
+    {
+        return ok_;
+    }
+
+    // Length of complete multibyte sequence at data, 0 when incomplete
+    // at end and 1 for single byte or invalid one
+    static std::size_t sequence_length(const char* data, std::size_t size)
+    {
+        const unsigned char c = static_cast<unsigned char>(data[0]);
+        const std::size_t length = c >= 0xf0 && c < 0xf5 ? 4 : c >= 0xe0 ? 3 : c >= 0xc2 && c < 0xe0 ? 2 : 1;
+        if (c >= 0xf5)
+        {
+            return 1;
+        }
+        for (std::size_t i = 1; i < length; ++i)
+        {
+            if (i == size)
+            {
+                return 0;
+            }
+            if ((static_cast<unsigned char>(data[i]) & 0xc0) != 0x80)
+            {
+                return 1;
+            }
+        }
+        return length;
+    }
+
+private:
+    output_callback callback_;
+    void* context_;
+    bool ok_ = true;
+};
+
+constexpr std::size_t utf8_max = 4;
+
+// Characters split between records of same kind are moved to later one
+struct Pending
+{
+    char data[utf8_max];
+    std::size_t size = 0;
+};
+
+} // namespace
+
+bool write_asciicast(const char* recording, std::size_t size, int lines, int columns, const char* term,
+    output_callback callback, void* context)
+{
+    JsonWriter writer(callback, context);
+    char line[64];
+    std::snprintf(line, sizeof(line), "{\"version\": 2, \"width\": %d, \"height\": %d, ", columns, lines);
+    writer.write(line);
+    writer.write("\"env\": {\"TERM\": \"");
+    writer.write_string(term, std::strlen(term));
+    writer.write("\"}}\n");
+
+    Pending pending[2];
+    RecordingReader reader(recording, size);
+    RecordingReader::Record record;
+    while (reader.next(record))
+    {
+        Pending& carried = pending[record.event == Recorder::Event::input ? 1 : 0];
+        std::snprintf(line, sizeof(line), "[%lu.%06lu, \"%c\", \"", record.time_us / 1000000, record.time_us % 1000000,
+            static_cast<char>(record.event));
+        writer.write(line);
+
+        // Completes carried character with first bytes of this record
+        std::size_t used = 0;
+        while (carried.size != 0 && used < record.size && carried.size < utf8_max
+            && JsonWriter::sequence_length(carried.data, carried.size) == 0)
+        {
+            carried.data[carried.size++] = record.data[used++];
+        }
+        writer.write_string(carried.data, carried.size);
+        carried.size = 0;
+
+        std::size_t end = record.size;
+        for (std::size_t back = 1; back < utf8_max && back <= end - used; ++back)
+        {
+            const unsigned char c = static_cast<unsigned char>(record.data[end - back]);
+            if ((c & 0xc0) != 0x80)
+            {
+                if (c >= 0xc2 && JsonWriter::sequence_length(record.data + end - back, back) == 0)
+                {
+                    carried.size = back;
+                    std::memcpy(carried.data, record.data + end - back, back);
+                    end -= back;
+                }
+                break;
+            }
+        }
+        writer.write_string(record.data + used, end - used);
+        writer.write("\"]\n");
+    }
+    return writer.ok();
+}
+
+} // namespace msos::curses
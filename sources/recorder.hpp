@@ -0,0 +1,103 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <time.h>
+
+#include "curses.h"
+
+namespace msos::curses
+{
+
+// Tees output and input of screen into buffer given by application.
+// Each chunk is one record: kind, microseconds since previous record and
+// size, both as LEB128, then bytes. Records that do not fit end recording.
+class Recorder
+{
+public:
+    enum class Event : char
+    {
+        output = 'o',
+        input = 'i'
+    };
+
+    void start(char* buffer, std::size_t capacity);
+    // Returns size of recording, which stays in buffer for export
+    std::size_t stop();
+
+    bool active() const
+    {
+        return active_;
+    }
+
+    void record(Event event, const char* data, std::size_t size)
+    {
+        if (active_ && size != 0)
+        {
+            append(event, data, size);
+        }
+    }
+
+    const char* data() const;
+    std::size_t size() const;
+
+private:
+    void append(Event event, const char* data, std::size_t size);
+    bool put_number(std::uint64_t value);
+
+    char* buffer_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    bool active_ = false;
+    struct timespec last_ = {};
+};
+
+// Walks records of recording, time is microseconds since its start
+class RecordingReader
+{
+public:
+    struct Record
+    {
+        Recorder::Event event;
+        unsigned long time_us;
+        const char* data;
+        std::size_t size;
+    };
+
+    RecordingReader(const char* data, std::size_t size);
+
+    bool next(Record& record);
+
+private:
+    bool get_number(std::uint64_t& value);
+
+    const char* data_;
+    std::size_t size_;
+    std::size_t offset_ = 0;
+    unsigned long time_us_ = 0;
+};
+
+// asciicast v2: header line, then one [time, kind, data] line per record.
+// Returns false when callback takes less than given.
+bool write_asciicast(const char* recording, std::size_t size, int lines, int columns, const char* term,
+    output_callback callback, void* context);
+
+} // namespace msos::curses
@@ -0,0 +1,58 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+namespace msos::curses
+{
+
+// Moves cells of lines x columns grid, stored line after line, into layout
+// of new size in place. Cells that still fit keep their position, exposed
+// ones are set to blank.
+template <typename Cell>
+void reflow(Cell* cells, int lines, int columns, int new_lines, int new_columns, Cell blank)
+{
+    const int kept_lines = std::min(lines, new_lines);
+    const int kept_columns = std::min(columns, new_columns);
+    const std::size_t kept_size = static_cast<std::size_t>(std::max(kept_columns, 0)) * sizeof(Cell);
+    const auto move_line = [=](int y) {
+        std::memmove(cells + y * new_columns, cells + y * columns, kept_size);
+        std::fill(cells + y * new_columns + kept_columns, cells + (y + 1) * new_columns, blank);
+    };
+
+    // Wider lines move towards end, so last one goes first
+    if (new_columns > columns)
+    {
+        for (int y = kept_lines - 1; y >= 0; --y)
+        {
+            move_line(y);
+        }
+    }
+    else
+    {
+        for (int y = 0; y < kept_lines; ++y)
+        {
+            move_line(y);
+        }
+    }
+    std::fill(cells + std::max(kept_lines, 0) * new_columns, cells + new_lines * new_columns, blank);
+}
+
+} // namespace msos::curses
@@ -0,0 +1,876 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "renderer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "reflow.hpp"
+#include "terminfo.hpp"
+#include "unicode.hpp"
+
+namespace msos::curses
+{
+
+namespace
+{
+
+constexpr unsigned attributes_mask = 0xff00;
+constexpr std::size_t motion_size = 2 * TERMINAL_SEQUENCE_SIZE;
+// Padding of cursor address longer than this is not sent
+constexpr std::size_t motion_padding_size = TERMINAL_SEQUENCE_SIZE / 2;
+constexpr char begin_synchronized[] = "\033[?2026h";
+constexpr char end_synchronized[] = "\033[?2026l";
+// UTF-8 of character with combining mark
+constexpr std::size_t text_size = 8;
+
+unsigned as_unsigned(chtype cell)
+{
+    return static_cast<unsigned short>(cell);
+}
+
+std::uint32_t text_of(const wchar_t* text, int index)
+{
+    return text != nullptr ? static_cast<std::uint32_t>(text[index]) : 0;
+}
+
+std::size_t format_number(char* out, int number)
+{
+    char digits[8];
+    std::size_t size = 0;
+    do
+    {
+        digits[size++] = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number != 0 && size < sizeof(digits));
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        out[i] = digits[size - i - 1];
+    }
+    return size;
+}
+
+std::size_t format_csi(char* out, int number, char command)
+{
+    std::size_t size = 0;
+    out[size++] = '\033';
+    out[size++] = '[';
+    if (number != 1)
+    {
+        size += format_number(out + size, number);
+    }
+    out[size++] = command;
+    return size;
+}
+
+} // namespace
+
+void Renderer::set_line_speed(const LineSpeed& speed)
+{
+    speed_ = speed;
+    search_motions_ = speed.baudrate < MOTION_SEARCH_BAUDRATE;
+}
+
+void Renderer::set_sequences(const Sequences& sequences)
+{
+    assign(carriage_return_, sequences.carriage_return, {"\r", 1});
+    assign(cursor_left_, sequences.cursor_left, {"\b", 1});
+    assign(cursor_down_, sequences.cursor_down, {"\n", 1});
+    assign(clr_eol_, sequences.clr_eol, {"\033[K", 3});
+    assign(clr_eos_, sequences.clr_eos, {"\033[J", 3});
+    assign(enter_alt_charset_mode_, sequences.enter_alt_charset_mode, {"\033(0", 3});
+    assign(exit_alt_charset_mode_, sequences.exit_alt_charset_mode, {"\033(B", 3});
+    assign(cursor_invisible_, sequences.cursor_invisible, {"", 0});
+    assign(cursor_normal_, sequences.cursor_normal, {"", 0});
+
+    ansi_cursor_address_ = true;
+    cursor_address_padding_ = 0;
+    if (sequences.cursor_address != nullptr)
+    {
+        char stripped[TPARM_SOURCE_SIZE];
+        std::size_t size = 0;
+        bool fits = true;
+        std::size_t padding = 0;
+        const auto output = [&stripped, &size, &fits](const char* data, std::size_t length) {
+            fits = fits && size + length < sizeof(stripped);
+            if (fits)
+            {
+                std::memcpy(stripped + size, data, length);
+                size += length;
+            }
+        };
+        split_padding(sequences.cursor_address, 1, output, [this, &padding](int tenths, bool mandatory) {
+            padding += speed_.padding_count(tenths, mandatory);
+        });
+        stripped[fits ? size : 0] = 0;
+        cursor_address_padding_ = std::min(padding, motion_padding_size);
+        ansi_cursor_address_ = !fits || !cursor_address_.compile(stripped) || cursor_address_.ansi_cursor_address();
+    }
+}
+
+void Renderer::assign(Sequence& sequence, const char* value, const Sequence& fallback) const
+{
+    sequence = fallback;
+    if (value == nullptr)
+    {
+        return;
+    }
+
+    // Pad characters are stored with sequence, so they count in its cost.
+    // Output never waits for terminal, padding that does not fit is dropped.
+    Sequence stripped = {};
+    bool fits = true;
+    std::size_t padding = 0;
+    const auto output = [&stripped, &fits](const char* data, std::size_t size) {
+        fits = fits && stripped.size + size <= sizeof(stripped.data);
+        if (fits)
+        {
+            std::memcpy(stripped.data + stripped.size, data, size);
+            stripped.size = static_cast<std::uint8_t>(stripped.size + size);
+        }
+    };
+    split_padding(value, 1, output, [this, &padding](int tenths, bool mandatory) {
+        padding += speed_.padding_count(tenths, mandatory);
+    });
+    if (!fits || stripped.size == 0)
+    {
+        return;
+    }
+    if (stripped.size + padding <= sizeof(stripped.data))
+    {
+        std::memset(stripped.data + stripped.size, speed_.pad, padding);
+        stripped.size = static_cast<std::uint8_t>(stripped.size + padding);
+    }
+    sequence = stripped;
+}
+
+void Renderer::resize(int lines, int columns)
+{
+    lines_ = lines;
+    columns_ = columns;
+    clear();
+}
+
+void Renderer::reshape(int lines, int columns)
+{
+    const int kept = std::min(lines, lines_);
+    int clipped = kept;
+    for (int y = 0; y < clipped && columns < columns_; ++y)
+    {
+        for (int x = columns; x < columns_; ++x)
+        {
+            const int index = y * columns_ + x;
+            if ((physical_[index] != 0 && physical_[index] != ' ') || physical_text(index) != 0)
+            {
+                clipped = y;
+                break;
+            }
+        }
+    }
+
+    reflow(physical_, lines_, columns_, lines, columns, chtype(0));
+    if (CURSES_WIDECHAR)
+    {
+        reflow(physical_text_, lines_, columns_, lines, columns, wchar_t(0));
+    }
+    mark_stale(lines, lines_, false);
+    lines_ = lines;
+    columns_ = columns;
+    if (clipped < kept)
+    {
+        mark_stale(clipped, lines, true);
+    }
+    invalidate();
+}
+
+void Renderer::clear()
+{
+    std::memset(physical_, 0, sizeof(physical_));
+    std::memset(stale_lines_, 0, sizeof(stale_lines_));
+    std::memset(physical_text_, 0, sizeof(physical_text_));
+    cursor_y_ = 0;
+    cursor_x_ = 0;
+    cursor_known_ = true;
+    attributes_ &= A_ALTCHARSET;
+}
+
+void Renderer::invalidate()
+{
+    cursor_known_ = false;
+    attributes_known_ = false;
+}
+
+void Renderer::invalidate_attributes()
+{
+    attributes_known_ = false;
+}
+
+void Renderer::invalidate_lines(int from, int count)
+{
+    from = std::max(from, 0);
+    const int to = std::min(from + std::max(count, 0), lines_);
+    if (from >= to)
+    {
+        return;
+    }
+    mark_stale(from, to, true);
+    invalidate();
+}
+
+void Renderer::mark_stale(int from, int to, bool stale)
+{
+    for (int y = from; y < to; ++y)
+    {
+        const std::uint32_t bit = 1u << (y % 32);
+        stale_lines_[y / 32] = stale ? stale_lines_[y / 32] | bit : stale_lines_[y / 32] & ~bit;
+    }
+}
+
+void Renderer::set_background_erase(bool enabled)
+{
+    background_erase_ = enabled;
+}
+
+void Renderer::set_repeat_character(bool enabled)
+{
+    repeat_character_ = enabled;
+}
+
+void Renderer::set_erase_characters(bool enabled)
+{
+    erase_characters_ = enabled;
+}
+
+void Renderer::set_synchronized_output(bool enabled)
+{
+    synchronized_output_ = enabled;
+}
+
+void Renderer::set_cursor_visible(bool visible)
+{
+    cursor_visible_ = visible;
+}
+
+std::size_t Renderer::begin_frame(Writer writer)
+{
+    if (!synchronized_output_ || frame_open_)
+    {
+        return 0;
+    }
+    writer(begin_synchronized, sizeof(begin_synchronized) - 1);
+    frame_open_ = true;
+    return sizeof(begin_synchronized) - 1;
+}
+
+void Renderer::limit_output(std::size_t bytes)
+{
+    output_limit_ = bytes;
+}
+
+bool Renderer::complete() const
+{
+    return complete_;
+}
+
+void Renderer::update(const WINDOW& window, const SgrCache& sgr, Writer writer)
+{
+    sgr_ = &sgr;
+    writer_ = writer;
+    counters_ = RenderCounters();
+    framing_ = true;
+    frame_motion_ = 0;
+    written_ = 0;
+    complete_ = true;
+
+    const std::size_t line_size = static_cast<std::size_t>(columns_);
+    const wchar_t* text = CURSES_WIDECHAR ? window.wide_buffer : nullptr;
+    const int screen_size = lines_ * columns_;
+    const int screen_tail = blank_tail(window, text, 0, screen_size);
+    for (int y = 0; y < lines_; ++y)
+    {
+        const int offset = y * columns_;
+        const chtype* line = window.screen_buffer + offset;
+        chtype* shadow = physical_ + offset;
+        const std::uint32_t stale = 1u << (y % 32);
+        if (stale_lines_[y / 32] & stale)
+        {
+            // Complement differs from every cell, so whole line is sent
+            stale_lines_[y / 32] &= ~stale;
+            for (int x = 0; x < columns_; ++x)
+            {
+                shadow[x] = static_cast<chtype>(~line[x]);
+            }
+        }
+        const bool same_cells = std::memcmp(line, shadow, line_size * sizeof(chtype)) == 0;
+        const bool same_text = text == nullptr
+            || std::memcmp(text + offset, physical_text_ + offset, line_size * sizeof(wchar_t)) == 0;
+        if (same_cells && same_text)
+        {
+            continue;
+        }
+        counters_.cells_diffed += line_size;
+
+        // Blank end of line, or of whole screen, may be cleared with single erase
+        const bool screen_end = screen_tail < offset + columns_;
+        const int tail = screen_end ? std::max(screen_tail, offset) : blank_tail(window, text, offset, offset + columns_);
+        draw_range(window, text, y, 0, tail - offset);
+        if (!room())
+        {
+            // Rest differs from shadow, next update continues there
+            break;
+        }
+        if (!erase(window, tail, screen_end ? screen_size : offset + columns_))
+        {
+            draw_range(window, text, y, tail - offset, columns_);
+        }
+        else if (screen_end)
+        {
+            // Lines below were erased too, terminal shows them right
+            mark_stale(y + 1, lines_, false);
+        }
+    }
+
+    // Cursor restore alone neither opens frame nor is worth hiding cursor
+    framing_ = false;
+    if (!window.leave_cursor && window.cursor_y < lines_ && window.cursor_x < columns_)
+    {
+        move(window.cursor_y, window.cursor_x);
+    }
+    close_frame();
+    flush();
+}
+
+bool Renderer::follow(const Renderer& leader, const SgrCache& sgr, Writer writer)
+{
+    if (lines_ != leader.lines_ || columns_ != leader.columns_
+        || background_erase_ != leader.background_erase_
+        || repeat_character_ != leader.repeat_character_
+        || erase_characters_ != leader.erase_characters_
+        || synchronized_output_ != leader.synchronized_output_
+        || cursor_visible_ != leader.cursor_visible_
+        || ansi_cursor_address_ != leader.ansi_cursor_address_
+        || std::memcmp(physical_, leader.physical_, sizeof(physical_)) != 0
+        || std::memcmp(physical_text_, leader.physical_text_, sizeof(physical_text_)) != 0
+        || std::memcmp(stale_lines_, leader.stale_lines_, sizeof(stale_lines_)) != 0)
+    {
+        return false;
+    }
+
+    sgr_ = &sgr;
+    writer_ = writer;
+    counters_ = RenderCounters();
+    if (leader.cursor_known_)
+    {
+        move(leader.cursor_y_, leader.cursor_x_);
+    }
+    cursor_known_ = leader.cursor_known_;
+    if (leader.attributes_known_)
+    {
+        set_attributes(leader.attributes_);
+    }
+    attributes_known_ = leader.attributes_known_;
+    flush();
+    return true;
+}
+
+const RenderCounters& Renderer::counters() const
+{
+    return counters_;
+}
+
+void Renderer::draw_range(const WINDOW& window, const wchar_t* text, int y, int from, int to)
+{
+    const int offset = y * columns_;
+    const chtype* line = window.screen_buffer + offset;
+    const chtype* shadow = physical_ + offset;
+    for (int x = from; x < to; ++x)
+    {
+        const std::uint32_t cell_text = text_of(text, offset + x);
+        if (line[x] == shadow[x] && cell_text == physical_text(offset + x))
+        {
+            continue;
+        }
+        if (!room())
+        {
+            return;
+        }
+
+        if (cell_text == cell_continuation)
+        {
+            // Right half differs while left does not, whole character is redrawn
+            if (x > 0)
+            {
+                draw(y, x - 1, line[x - 1], text_of(text, offset + x - 1));
+            }
+            continue;
+        }
+
+        const int run = cell_text == 0 && (repeat_character_ || erase_characters_)
+            ? changed_run(window, text, y, x, to) : 1;
+        if (run > 1 && (erase_characters(window, y, x, run) || repeat_character(window, y, x, run)))
+        {
+            x += run - 1;
+            continue;
+        }
+        x += draw(y, x, line[x], cell_text) - 1;
+    }
+}
+
+bool Renderer::erasable(chtype cell, std::uint32_t text) const
+{
+    constexpr unsigned visible_attributes = A_UNDERLINE | A_REVERSE | A_ALTCHARSET;
+    const unsigned value = as_unsigned(cell);
+    const unsigned character = value & A_CHARTEXT;
+    return text == 0 && (character == 0 || character == ' ') && (value & visible_attributes) == 0
+        && (background_erase_ || sgr_->default_background(value));
+}
+
+int Renderer::blank_tail(const WINDOW& window, const wchar_t* text, int from, int to) const
+{
+    if (to == from || !erasable(window.screen_buffer[to - 1], text_of(text, to - 1)))
+    {
+        return to;
+    }
+
+    const unsigned attributes = as_unsigned(window.screen_buffer[to - 1]) & attributes_mask;
+    int start = to - 1;
+    while (start > from && erasable(window.screen_buffer[start - 1], text_of(text, start - 1))
+        && (as_unsigned(window.screen_buffer[start - 1]) & attributes_mask) == attributes)
+    {
+        --start;
+    }
+    return start;
+}
+
+bool Renderer::erase(const WINDOW& window, int from, int to)
+{
+    // Erase pays off when more cells changed than its bytes, padding included
+    const Sequence& clear = to > (from / columns_ + 1) * columns_ ? clr_eos_ : clr_eol_;
+    const int erase_threshold = clear.size + 1;
+    int first = to;
+    int changed = 0;
+    for (int i = from; i < to && changed < erase_threshold; ++i)
+    {
+        if (physical_[i] != window.screen_buffer[i] || physical_text(i) != 0)
+        {
+            first = std::min(first, i);
+            ++changed;
+        }
+    }
+    if (changed < erase_threshold)
+    {
+        return false;
+    }
+
+    const int y = first / columns_;
+    move(y, first % columns_);
+    set_attributes(as_unsigned(window.screen_buffer[first]) & attributes_mask);
+    write(OutputKind::erase, to > (y + 1) * columns_ ? clr_eos_ : clr_eol_);
+
+    const std::size_t cells = static_cast<std::size_t>(to - first);
+    counters_.cells_changed += cells;
+    std::memcpy(physical_ + first, window.screen_buffer + first, cells * sizeof(chtype));
+    if (CURSES_WIDECHAR)
+    {
+        std::memset(physical_text_ + first, 0, cells * sizeof(wchar_t));
+    }
+    return true;
+}
+
+int Renderer::changed_run(const WINDOW& window, const wchar_t* text, int y, int x, int to) const
+{
+    const int offset = y * columns_;
+    const chtype cell = window.screen_buffer[offset + x];
+    int count = 1;
+    while (x + count < to && window.screen_buffer[offset + x + count] == cell
+        && text_of(text, offset + x + count) == 0
+        && (physical_[offset + x + count] != cell || physical_text(offset + x + count) != 0))
+    {
+        ++count;
+    }
+    return count;
+}
+
+bool Renderer::erase_characters(const WINDOW& window, int y, int x, int count)
+{
+    // ECH leaves cursor in place, next cell usually needs cursor forward
+    char sequence[motion_size];
+    const std::size_t size = format_csi(sequence, count, 'X');
+    const int index = y * columns_ + x;
+    if (!erase_characters_ || !erasable(window.screen_buffer[index], 0) || 2 * size >= static_cast<std::size_t>(count))
+    {
+        return false;
+    }
+
+    move(y, x);
+    set_attributes(as_unsigned(window.screen_buffer[index]) & attributes_mask);
+    write(OutputKind::erase, sequence, size);
+    const std::size_t cells = static_cast<std::size_t>(count);
+    counters_.cells_changed += cells;
+    std::memcpy(physical_ + index, window.screen_buffer + index, cells * sizeof(chtype));
+    if (CURSES_WIDECHAR)
+    {
+        std::memset(physical_text_ + index, 0, cells * sizeof(wchar_t));
+    }
+    return true;
+}
+
+bool Renderer::repeat_character(const WINDOW& window, int y, int x, int count)
+{
+    // REP repeats last graphic character, controls cannot be repeated
+    char sequence[motion_size];
+    const std::size_t size = format_csi(sequence, count - 1, 'b');
+    const int index = y * columns_ + x;
+    const chtype cell = window.screen_buffer[index];
+    const unsigned character = as_unsigned(cell) & A_CHARTEXT;
+    if (!repeat_character_ || (character != 0 && (character < ' ' || character > '~'))
+        || 1 + size >= static_cast<std::size_t>(count))
+    {
+        return false;
+    }
+
+    draw(y, x, cell, 0);
+    write(OutputKind::text, sequence, size);
+    for (int i = 1; i < count; ++i)
+    {
+        physical_[index + i] = cell;
+        if (CURSES_WIDECHAR)
+        {
+            physical_text_[index + i] = 0;
+        }
+    }
+    counters_.cells_changed += static_cast<unsigned long>(count - 1);
+    cursor_x_ = x + count;
+    cursor_known_ = cursor_known_ && cursor_x_ < columns_;
+    return true;
+}
+
+int Renderer::draw(int y, int x, chtype cell, std::uint32_t text)
+{
+    if (!cursor_known_ || cursor_y_ != y || cursor_x_ != x)
+    {
+        // Short gap may be cheaper to rewrite than to jump over
+        const int gap = x - cursor_x_;
+        bool rewrite = cursor_known_ && attributes_known_ && cursor_y_ == y && gap > 0;
+        if (rewrite)
+        {
+            char sequence[motion_size];
+            rewrite = static_cast<std::size_t>(gap) < motion(y, x, sequence);
+        }
+
+        const chtype* shadow = physical_ + y * columns_;
+        for (int i = cursor_x_; rewrite && i < x; ++i)
+        {
+            rewrite = (as_unsigned(shadow[i]) & attributes_mask) == attributes_
+                && physical_text(y * columns_ + i) == 0;
+        }
+
+        if (rewrite)
+        {
+            for (int i = cursor_x_; i < x; ++i)
+            {
+                const char c = static_cast<char>(as_unsigned(shadow[i]) & A_CHARTEXT);
+                write(OutputKind::motion, c ? c : ' ');
+            }
+            cursor_x_ = x;
+        }
+        else
+        {
+            move(y, x);
+        }
+    }
+
+    set_attributes(as_unsigned(cell) & attributes_mask);
+    write_text(cell, text);
+
+    const int index = y * columns_ + x;
+    int width = 1;
+    physical_[index] = cell;
+    if (CURSES_WIDECHAR)
+    {
+        physical_text_[index] = static_cast<wchar_t>(text);
+        if (text != 0 && character_width(text & cell_codepoint_mask) == 2 && x + 1 < columns_)
+        {
+            physical_[index + 1] = cell;
+            physical_text_[index + 1] = static_cast<wchar_t>(cell_continuation);
+            width = 2;
+        }
+    }
+
+    counters_.cells_changed += static_cast<unsigned long>(width);
+    cursor_x_ += width;
+    if (cursor_x_ >= columns_)
+    {
+        // Terminals differ in handling of last column, do not rely on it
+        cursor_known_ = false;
+    }
+    return width;
+}
+
+std::uint32_t Renderer::physical_text(int index) const
+{
+    return CURSES_WIDECHAR ? static_cast<std::uint32_t>(physical_text_[index]) : 0;
+}
+
+void Renderer::write_text(chtype cell, std::uint32_t text)
+{
+    if (text == 0)
+    {
+        const char c = static_cast<char>(as_unsigned(cell) & A_CHARTEXT);
+        write(OutputKind::text, c ? c : ' ');
+        return;
+    }
+
+    char sequence[text_size];
+    std::size_t size = utf8_encode(text & cell_codepoint_mask, sequence);
+    const std::uint32_t combining = text >> cell_combining_offset;
+    if (combining != 0)
+    {
+        size += utf8_encode(combining_first + combining - 1, sequence + size);
+    }
+    write(OutputKind::text, sequence, size);
+}
+
+void Renderer::move(int y, int x)
+{
+    if (cursor_known_ && cursor_y_ == y && cursor_x_ == x)
+    {
+        return;
+    }
+
+    char sequence[motion_size];
+    const std::size_t size = motion(y, x, sequence);
+    // Terminal shows cursor jumping until frame ends, unless it is hidden.
+    // Synchronized frame is shown at once, cursor does not jump there.
+    if (framing_ && cursor_visible_ && !cursor_hidden_ && !synchronized_output_
+        && cursor_invisible_.size != 0 && cursor_normal_.size != 0)
+    {
+        frame_motion_ += size;
+        if (frame_motion_ > static_cast<std::size_t>(cursor_invisible_.size + cursor_normal_.size))
+        {
+            write(OutputKind::motion, cursor_invisible_);
+            cursor_hidden_ = true;
+        }
+    }
+    write(OutputKind::motion, sequence, size);
+    cursor_y_ = y;
+    cursor_x_ = x;
+    cursor_known_ = true;
+}
+
+std::size_t Renderer::motion(int y, int x, char* sequence) const
+{
+    // Absolute position is always valid, relative moves only when shorter
+    std::size_t size = 0;
+    if (ansi_cursor_address_)
+    {
+        sequence[size++] = '\033';
+        sequence[size++] = '[';
+        size += format_number(sequence + size, y + 1);
+        if (x != 0)
+        {
+            sequence[size++] = ';';
+            size += format_number(sequence + size, x + 1);
+        }
+        sequence[size++] = 'H';
+    }
+    else
+    {
+        const Parameter parameters[parameter_count] = {{y, nullptr}, {x, nullptr}};
+        Variables variables = {};
+        size = cursor_address_.expand(parameters, variables, sequence, motion_size - motion_padding_size);
+    }
+    std::memset(sequence + size, speed_.pad, cursor_address_padding_);
+    size += cursor_address_padding_;
+
+    if (!cursor_known_)
+    {
+        return size;
+    }
+
+    char relative[motion_size];
+    std::size_t relative_size = size;
+    // CSI relative moves are assumed only on terminals addressed with CSI
+    if (y == cursor_y_ && x > cursor_x_ && ansi_cursor_address_)
+    {
+        relative_size = format_csi(relative, x - cursor_x_, 'C');
+    }
+    else if (y == cursor_y_ && x == 0)
+    {
+        std::memcpy(relative, carriage_return_.data, carriage_return_.size);
+        relative_size = carriage_return_.size;
+    }
+    else if (y == cursor_y_ && x == cursor_x_ - 1)
+    {
+        std::memcpy(relative, cursor_left_.data, cursor_left_.size);
+        relative_size = cursor_left_.size;
+    }
+    else if (y == cursor_y_ && ansi_cursor_address_)
+    {
+        relative_size = format_csi(relative, cursor_x_ - x, 'D');
+    }
+    else if (y == cursor_y_ + 1 && x == 0)
+    {
+        std::memcpy(relative, carriage_return_.data, carriage_return_.size);
+        std::memcpy(relative + carriage_return_.size, cursor_down_.data, cursor_down_.size);
+        relative_size = carriage_return_.size + cursor_down_.size;
+    }
+
+    if (relative_size < size)
+    {
+        std::memcpy(sequence, relative, relative_size);
+        size = relative_size;
+    }
+
+    // Each byte on slow line costs more than trying other motions
+    if (search_motions_ && ansi_cursor_address_ && (y != cursor_y_ || x < cursor_x_ - 1))
+    {
+        relative_size = y != cursor_y_ ? vertical_motion(y, x, relative) : horizontal_motion(x, relative);
+        if (relative_size < size)
+        {
+            std::memcpy(sequence, relative, relative_size);
+            size = relative_size;
+        }
+    }
+    return size;
+}
+
+std::size_t Renderer::vertical_motion(int y, int x, char* sequence) const
+{
+    const std::size_t size = format_csi(sequence, y > cursor_y_ ? y - cursor_y_ : cursor_y_ - y, y > cursor_y_ ? 'B' : 'A');
+    return size + horizontal_motion(x, sequence + size);
+}
+
+std::size_t Renderer::horizontal_motion(int x, char* sequence) const
+{
+    if (x == cursor_x_)
+    {
+        return 0;
+    }
+    if (x > cursor_x_)
+    {
+        return format_csi(sequence, x - cursor_x_, 'C');
+    }
+    if (x == cursor_x_ - 1)
+    {
+        std::memcpy(sequence, cursor_left_.data, cursor_left_.size);
+        return cursor_left_.size;
+    }
+
+    // Back from cursor, or forward from start of line
+    char back[motion_size];
+    const std::size_t back_size = format_csi(back, cursor_x_ - x, 'D');
+    std::memcpy(sequence, carriage_return_.data, carriage_return_.size);
+    std::size_t size = carriage_return_.size;
+    if (x != 0)
+    {
+        size += format_csi(sequence + size, x, 'C');
+    }
+    if (back_size < size)
+    {
+        std::memcpy(sequence, back, back_size);
+        size = back_size;
+    }
+    return size;
+}
+
+void Renderer::set_attributes(unsigned attributes)
+{
+    const unsigned charset = attributes & A_ALTCHARSET;
+    if (!attributes_known_ || charset != (attributes_ & A_ALTCHARSET))
+    {
+        write(OutputKind::attributes, charset ? enter_alt_charset_mode_ : exit_alt_charset_mode_);
+    }
+
+    const unsigned rendition = attributes & ~static_cast<unsigned>(A_ALTCHARSET);
+    if (!attributes_known_ || rendition != (attributes_ & ~static_cast<unsigned>(A_ALTCHARSET)))
+    {
+        const SgrCache::Sequence& sequence = sgr_->get(attributes);
+        write(OutputKind::attributes, sequence.data, sequence.size);
+    }
+
+    attributes_ = attributes;
+    attributes_known_ = true;
+}
+
+bool Renderer::room()
+{
+    // Worst case of one drawn cell or erase, then of ending frame after it
+    const std::size_t step = 3 * motion_size + cursor_invisible_.size + 2 * TERMINAL_SEQUENCE_SIZE
+        + SGR_SEQUENCE_SIZE + text_size;
+    const std::size_t ending = motion_size + cursor_normal_.size + sizeof(begin_synchronized) + sizeof(end_synchronized);
+    complete_ = complete_ && written_ + step + ending <= output_limit_;
+    return complete_;
+}
+
+void Renderer::close_frame()
+{
+    if (cursor_hidden_)
+    {
+        write(OutputKind::motion, cursor_normal_);
+        cursor_hidden_ = false;
+    }
+    if (frame_open_)
+    {
+        write(OutputKind::motion, end_synchronized, sizeof(end_synchronized) - 1);
+        frame_open_ = false;
+    }
+}
+
+void Renderer::write(OutputKind kind, const char* data, std::size_t size)
+{
+    // Frame control is counted with cursor motion
+    if (framing_ && synchronized_output_ && !frame_open_)
+    {
+        frame_open_ = true;
+        write(OutputKind::motion, begin_synchronized, sizeof(begin_synchronized) - 1);
+    }
+    written_ += size;
+#if CURSES_STATS
+    counters_.bytes[static_cast<std::size_t>(kind)] += size;
+#else
+    static_cast<void>(kind);
+#endif // CURSES_STATS
+    if (frame_size_ + size > sizeof(frame_))
+    {
+        flush();
+    }
+    std::memcpy(frame_ + frame_size_, data, size);
+    frame_size_ += size;
+}
+
+void Renderer::write(OutputKind kind, const Sequence& sequence)
+{
+    write(kind, sequence.data, sequence.size);
+}
+
+void Renderer::write(OutputKind kind, char c)
+{
+    write(kind, &c, 1);
+}
+
+void Renderer::flush()
+{
+    if (frame_size_ != 0 && writer_ != nullptr)
+    {
+        writer_(frame_, frame_size_);
+    }
+    frame_size_ = 0;
+}
+
+} // namespace msos::curses
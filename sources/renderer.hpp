@@ -0,0 +1,215 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "curses.h"
+
+#include "line_speed.hpp"
+#include "parameterized_string.hpp"
+#include "sgr_cache.hpp"
+#include "stats.hpp"
+
+#ifndef SCREEN_BUFFER_SIZE
+    #define SCREEN_BUFFER_SIZE (24 * 80)
+#endif // SCREEN_BUFFER_SIZE
+
+// Longest terminal specific sequence, longer ones are replaced with default
+#ifndef TERMINAL_SEQUENCE_SIZE
+    #define TERMINAL_SEQUENCE_SIZE 16
+#endif // TERMINAL_SEQUENCE_SIZE
+
+// Slower lines make renderer try more cursor motions to find shorter one
+#ifndef MOTION_SEARCH_BAUDRATE
+    #define MOTION_SEARCH_BAUDRATE 115200
+#endif // MOTION_SEARCH_BAUDRATE
+
+#ifndef FRAME_BUFFER_SIZE
+    #define FRAME_BUFFER_SIZE 128
+#endif // FRAME_BUFFER_SIZE
+
+namespace msos::curses
+{
+
+// Keeps copy of what terminal displays and sends only differences
+// between that copy and virtual screen.
+class Renderer
+{
+public:
+    using Writer = void (*)(const char* data, std::size_t size);
+
+    // Terminal specific sequences, nullptr keeps VT100 default
+    struct Sequences
+    {
+        const char* carriage_return = nullptr;
+        const char* cursor_left = nullptr;
+        const char* cursor_down = nullptr;
+        const char* clr_eol = nullptr;
+        const char* clr_eos = nullptr;
+        const char* enter_alt_charset_mode = nullptr;
+        const char* exit_alt_charset_mode = nullptr;
+        const char* cursor_address = nullptr;
+        // Without both of them cursor is never hidden during updates
+        const char* cursor_invisible = nullptr;
+        const char* cursor_normal = nullptr;
+    };
+
+    // Padding of sequences depends on line speed, set it first
+    void set_line_speed(const LineSpeed& speed);
+    void set_sequences(const Sequences& sequences);
+
+    void resize(int lines, int columns);
+
+    // Terminal changed size and kept cells that still fit, exposed ones are
+    // blank. Lines below first one cut off are drawn by next update, since
+    // terminals that rewrap long lines move them.
+    void reshape(int lines, int columns);
+
+    // Terminal was cleared: blank screen, cursor at home, default attributes
+    void clear();
+
+    // Something else wrote to terminal, cursor and attributes are unknown
+    void invalidate();
+
+    // Color pair sequences changed, current attributes must be sent again
+    void invalidate_attributes();
+
+    // Terminal may show anything on these lines, next update draws them in
+    // full. Cursor and attributes are sent again too, output lost on the
+    // way could have changed them.
+    void invalidate_lines(int from, int count);
+
+    // Terminal erases with current background color instead of default one
+    void set_background_erase(bool enabled);
+
+    // Runs of same cell may be sent with REP and blank ones erased with ECH
+    void set_repeat_character(bool enabled);
+    void set_erase_characters(bool enabled);
+
+    // Updates are wrapped in synchronized output mode (DEC private mode
+    // 2026), terminal shows whole frame at once instead of while it arrives
+    void set_synchronized_output(bool enabled);
+
+    // Visible cursor is hidden during updates that would move it around
+    // for more bytes than hiding and showing it costs
+    void set_cursor_visible(bool visible);
+
+    // Opens synchronized frame before output sent outside of renderer,
+    // update closes it. Returns number of bytes written.
+    std::size_t begin_frame(Writer writer);
+
+    // Next updates write at most bytes. Cells that do not fit keep differing
+    // from shadow and are drawn by following update.
+    void limit_output(std::size_t bytes);
+    // False when last update stopped at output limit
+    bool complete() const;
+
+    void update(const WINDOW& window, const SgrCache& sgr, Writer writer);
+
+    // When terminal shows same cells as the one of leader, cursor and
+    // attributes are brought to state of leader. Then both renderers send
+    // same bytes for same updates. False when cells or encodings differ.
+    bool follow(const Renderer& leader, const SgrCache& sgr, Writer writer);
+
+    // Work of last update or follow
+    const RenderCounters& counters() const;
+
+private:
+    struct Sequence
+    {
+        char data[TERMINAL_SEQUENCE_SIZE];
+        std::uint8_t size;
+    };
+
+    void assign(Sequence& sequence, const char* value, const Sequence& fallback) const;
+    void write(OutputKind kind, const Sequence& sequence);
+    void draw_range(const WINDOW& window, const wchar_t* text, int y, int from, int to);
+    bool erasable(chtype cell, std::uint32_t text) const;
+    int blank_tail(const WINDOW& window, const wchar_t* text, int from, int to) const;
+    bool erase(const WINDOW& window, int from, int to);
+    // Number of changed cells equal to cell at x
+    int changed_run(const WINDOW& window, const wchar_t* text, int y, int x, int to) const;
+    bool erase_characters(const WINDOW& window, int y, int x, int count);
+    bool repeat_character(const WINDOW& window, int y, int x, int count);
+    // Returns number of columns drawn
+    int draw(int y, int x, chtype cell, std::uint32_t text);
+    std::uint32_t physical_text(int index) const;
+    void write_text(chtype cell, std::uint32_t text);
+    void move(int y, int x);
+    // False once output limit leaves no room for next cell
+    bool room();
+    void close_frame();
+    void mark_stale(int from, int to, bool stale);
+    std::size_t motion(int y, int x, char* sequence) const;
+    // Relative motions with CSI, searched on slow lines
+    std::size_t vertical_motion(int y, int x, char* sequence) const;
+    std::size_t horizontal_motion(int x, char* sequence) const;
+    void set_attributes(unsigned attributes);
+    void write(OutputKind kind, const char* data, std::size_t size);
+    void write(OutputKind kind, char c);
+    void flush();
+
+    chtype physical_[SCREEN_BUFFER_SIZE];
+    wchar_t physical_text_[CURSES_WIDECHAR ? SCREEN_BUFFER_SIZE : 1];
+    // Bit per line drawn in full by next update, see invalidate_lines
+    std::uint32_t stale_lines_[(SCREEN_BUFFER_SIZE + 31) / 32] = {};
+    int lines_ = 0;
+    int columns_ = 0;
+    int cursor_y_ = 0;
+    int cursor_x_ = 0;
+    bool cursor_known_ = false;
+    unsigned attributes_ = 0;
+    bool attributes_known_ = false;
+    bool background_erase_ = false;
+    bool repeat_character_ = false;
+    bool erase_characters_ = false;
+    bool synchronized_output_ = false;
+    bool cursor_visible_ = true;
+
+    const SgrCache* sgr_ = nullptr;
+    Sequence carriage_return_ = {"\r", 1};
+    Sequence cursor_left_ = {"\b", 1};
+    Sequence cursor_down_ = {"\n", 1};
+    Sequence clr_eol_ = {"\033[K", 3};
+    Sequence clr_eos_ = {"\033[J", 3};
+    Sequence enter_alt_charset_mode_ = {"\033(0", 3};
+    Sequence exit_alt_charset_mode_ = {"\033(B", 3};
+    Sequence cursor_invisible_ = {"", 0};
+    Sequence cursor_normal_ = {"", 0};
+    // ANSI form is formatted directly, others run compiled capability
+    ParameterizedString cursor_address_;
+    bool ansi_cursor_address_ = true;
+    std::size_t cursor_address_padding_ = 0;
+    LineSpeed speed_;
+    bool search_motions_ = false;
+    Writer writer_ = nullptr;
+    RenderCounters counters_;
+    char frame_[FRAME_BUFFER_SIZE];
+    std::size_t frame_size_ = 0;
+    // Update in progress, its first byte opens frame
+    bool framing_ = false;
+    bool frame_open_ = false;
+    bool cursor_hidden_ = false;
+    std::size_t frame_motion_ = 0;
+    std::size_t output_limit_ = SIZE_MAX;
+    std::size_t written_ = 0;
+    bool complete_ = true;
+};
+
+} // namespace msos::curses
@@ -0,0 +1,93 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+
+namespace msos::curses
+{
+
+// Fixed capacity byte FIFO, no heap usage
+template <std::size_t Capacity>
+class RingBuffer
+{
+public:
+    std::size_t push(const char* data, std::size_t size)
+    {
+        std::size_t i = 0;
+        for (; i < size && size_ < Capacity; ++i)
+        {
+            data_[(head_ + size_) % Capacity] = data[i];
+            ++size_;
+        }
+        return i;
+    }
+
+    std::size_t pop(char* out, std::size_t size)
+    {
+        std::size_t i = 0;
+        for (; i < size && size_ > 0; ++i)
+        {
+            out[i] = data_[head_];
+            consume(1);
+        }
+        return i;
+    }
+
+    char peek(std::size_t offset) const
+    {
+        return data_[(head_ + offset) % Capacity];
+    }
+
+    void consume(std::size_t size)
+    {
+        if (size > size_)
+        {
+            size = size_;
+        }
+        head_ = (head_ + size) % Capacity;
+        size_ -= size;
+    }
+
+    void clear()
+    {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    std::size_t free_space() const
+    {
+        return Capacity - size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+private:
+    char data_[Capacity];
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+};
+
+} // namespace msos::curses
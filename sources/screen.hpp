@@ -0,0 +1,90 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstdio>
+
+#include "curses.h"
+
+#include "color.hpp"
+#if CURSES_DRAW_QUEUE
+#include "draw_queue.hpp"
+#endif // CURSES_DRAW_QUEUE
+#include "input.hpp"
+#include "line_speed.hpp"
+#include "output_sink.hpp"
+#include "palette.hpp"
+#include "probe.hpp"
+#include "recorder.hpp"
+#include "renderer.hpp"
+#include "ring_buffer.hpp"
+#include "sgr_cache.hpp"
+#include "stats.hpp"
+#include "terminfo.hpp"
+
+#ifndef OUTPUT_BUFFER_SIZE
+    #define OUTPUT_BUFFER_SIZE 1024
+#endif // OUTPUT_BUFFER_SIZE
+
+// Everything that belongs to one terminal. Functions without SCREEN
+// argument work on current one, selected with set_term.
+struct SCREEN
+{
+    WINDOW window = {};
+    chtype buffer[SCREEN_BUFFER_SIZE];
+    wchar_t wide_buffer[CURSES_WIDECHAR ? SCREEN_BUFFER_SIZE : 1];
+    msos::curses::Renderer renderer;
+
+    msos::curses::OutputSink sink;
+    int output_fd = 1;
+    int input_fd = 0;
+    msos::curses::InputDecoder input;
+    bool echo_enabled = true;
+    bool paste_enabled = false;
+    // Chosen with curs_set, endwin shows cursor until next doupdate
+    int cursor_visibility = 1;
+    bool cursor_shown = false;
+    bool evloop_mode = false;
+    msos::curses::RingBuffer<OUTPUT_BUFFER_SIZE> output;
+
+    Color colors[COLOR_PAIRS];
+    msos::curses::Palette palette;
+    msos::curses::SgrCache sgr;
+    // Negative colors in pairs mean terminal default
+    bool default_colors = false;
+
+    msos::curses::Terminfo terminfo;
+    char terminal_name[32] = {};
+    const char* clear_screen = "\033[H\033[J";
+    msos::curses::TerminalFeatures features;
+    msos::curses::LineSpeed line_speed;
+    // Screen whose stdscr this one shows, drawn by doupdate of source
+    SCREEN* source = nullptr;
+    // Screen of same terminal and state whose output is sent here too
+    SCREEN* leader = nullptr;
+    // Terminal lost part of output, it is cleared and drawn again
+    bool repaint = false;
+    // Lines drawn again by each doupdate in round robin, see resync_lines
+    int resync_lines = 0;
+    int resync_next = 0;
+#if CURSES_DRAW_QUEUE
+    msos::curses::DrawQueue draw_queue;
+#endif // CURSES_DRAW_QUEUE
+    msos::curses::Statistics stats;
+    msos::curses::Recorder recorder;
+};
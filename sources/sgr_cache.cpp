@@ -0,0 +1,160 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "sgr_cache.hpp"
+
+namespace msos::curses
+{
+
+namespace
+{
+
+constexpr unsigned rendition_offset = 8;
+constexpr unsigned rendition_mask = 0x07;
+constexpr unsigned color_offset = 12;
+constexpr unsigned color_mask = 0x0f;
+
+class SequenceBuilder
+{
+public:
+    explicit SequenceBuilder(SgrCache::Sequence& sequence)
+        : sequence_(sequence)
+    {
+        sequence_.size = 0;
+    }
+
+    void append(const char* str)
+    {
+        while (*str != 0)
+        {
+            append(*str++);
+        }
+    }
+
+    void append(char c)
+    {
+        if (sequence_.size < sizeof(sequence_.data))
+        {
+            sequence_.data[sequence_.size++] = c;
+        }
+    }
+
+    void append_number(int number)
+    {
+        char digits[8];
+        std::size_t size = 0;
+        do
+        {
+            digits[size++] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        } while (number != 0 && size < sizeof(digits));
+
+        while (size != 0)
+        {
+            append(digits[--size]);
+        }
+    }
+
+    // Base is 30 for foreground and 40 for background
+    void append_color(const ColorCode& code, int base)
+    {
+        append(';');
+        switch (code.mode)
+        {
+            case ColorMode::basic:
+                append_number(base + code.index);
+                break;
+            case ColorMode::bright:
+                append_number(base + 60 + code.index - 8);
+                break;
+            case ColorMode::indexed:
+                append_number(base + 8);
+                append(";5;");
+                append_number(code.index);
+                break;
+            case ColorMode::direct:
+                append_number(base + 8);
+                append(";2;");
+                append_number(code.r);
+                append(';');
+                append_number(code.g);
+                append(';');
+                append_number(code.b);
+                break;
+        }
+    }
+
+private:
+    SgrCache::Sequence& sequence_;
+};
+
+} // namespace
+
+void SgrCache::build(const Color* colors, const Palette& palette)
+{
+    for (short pair = 0; pair < COLOR_PAIRS; ++pair)
+    {
+        build(pair, colors[pair], palette);
+    }
+}
+
+void SgrCache::build(short pair, const Color& color, const Palette& palette)
+{
+    default_background_[pair] = color.bg < COLOR_BLACK;
+
+    // Rendition bits follow chtype order: bold, underline, reverse
+    for (unsigned rendition = 0; rendition < renditions; ++rendition)
+    {
+        SequenceBuilder builder(sequences_[static_cast<std::size_t>(pair) * renditions + rendition]);
+        builder.append("\033[0");
+        if (rendition & (A_BOLD >> rendition_offset))
+        {
+            builder.append(";1");
+        }
+        if (rendition & (A_UNDERLINE >> rendition_offset))
+        {
+            builder.append(";4");
+        }
+        if (rendition & (A_REVERSE >> rendition_offset))
+        {
+            builder.append(";7");
+        }
+
+        if (color.fg >= COLOR_BLACK)
+        {
+            builder.append_color(palette.code(color.fg), 30);
+        }
+        if (color.bg >= COLOR_BLACK)
+        {
+            builder.append_color(palette.code(color.bg), 40);
+        }
+        builder.append('m');
+    }
+}
+
+const SgrCache::Sequence& SgrCache::get(unsigned attributes) const
+{
+    const unsigned pair = (attributes >> color_offset) & color_mask;
+    const unsigned rendition = (attributes >> rendition_offset) & rendition_mask;
+    return sequences_[pair * renditions + rendition];
+}
+
+bool SgrCache::default_background(unsigned attributes) const
+{
+    return default_background_[(attributes >> color_offset) & color_mask];
+}
+
+} // namespace msos::curses
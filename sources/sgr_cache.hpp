@@ -0,0 +1,62 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "curses.h"
+
+#include "color.hpp"
+#include "palette.hpp"
+
+#ifndef SGR_SEQUENCE_SIZE
+    #define SGR_SEQUENCE_SIZE 48
+#endif // SGR_SEQUENCE_SIZE
+
+namespace msos::curses
+{
+
+// Select Graphic Rendition sequences prepared for every color pair and
+// rendition, so changing attributes during refresh is a single copy.
+class SgrCache
+{
+public:
+    struct Sequence
+    {
+        char data[SGR_SEQUENCE_SIZE];
+        std::uint8_t size;
+    };
+
+    // Rebuilds sequences of all pairs, colors must have COLOR_PAIRS entries
+    void build(const Color* colors, const Palette& palette);
+    void build(short pair, const Color& color, const Palette& palette);
+
+    // Attributes as stored in cell, alternate charset is ignored
+    const Sequence& get(unsigned attributes) const;
+
+    // Erasing with these attributes leaves terminal default background
+    bool default_background(unsigned attributes) const;
+
+private:
+    static constexpr std::size_t renditions = 8;
+
+    Sequence sequences_[COLOR_PAIRS * renditions];
+    bool default_background_[COLOR_PAIRS];
+};
+
+} // namespace msos::curses
@@ -0,0 +1,129 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "stats.hpp"
+
+#if CURSES_STATS
+
+namespace msos::curses
+{
+
+std::size_t LatencyHistogram::bucket(unsigned long microseconds)
+{
+    if (microseconds < 4)
+    {
+        return microseconds;
+    }
+
+    std::size_t exponent = 2;
+    while (exponent + 1 < octaves && (microseconds >> (exponent + 1)) != 0)
+    {
+        ++exponent;
+    }
+    const std::size_t fraction = (microseconds >> (exponent - 2)) & 3;
+    // Values above last octave stay in its top bucket
+    return (microseconds >> (exponent + 1)) != 0 ? bucket_count - 1 : (exponent - 1) * 4 + fraction;
+}
+
+unsigned long LatencyHistogram::upper_bound(std::size_t bucket)
+{
+    if (bucket < 4)
+    {
+        return bucket;
+    }
+
+    const std::size_t exponent = bucket / 4 + 1;
+    const unsigned long lower = (4ul + bucket % 4) << (exponent - 2);
+    return lower + (1ul << (exponent - 2)) - 1;
+}
+
+void LatencyHistogram::add(unsigned long microseconds)
+{
+    ++buckets_[bucket(microseconds)];
+    ++count_;
+    maximum_ = microseconds > maximum_ ? microseconds : maximum_;
+}
+
+unsigned long LatencyHistogram::percentile(unsigned per_mille) const
+{
+    const unsigned long rank = (count_ * per_mille + 999) / 1000;
+    unsigned long seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i)
+    {
+        seen += buckets_[i];
+        if (seen >= rank && seen != 0)
+        {
+            // Top bucket has no upper bound
+            const unsigned long bound = i + 1 < bucket_count ? upper_bound(i) : maximum_;
+            return bound < maximum_ ? bound : maximum_;
+        }
+    }
+    return 0;
+}
+
+unsigned long LatencyHistogram::maximum() const
+{
+    return maximum_;
+}
+
+void Statistics::render(const RenderCounters& counters, bool frame)
+{
+    frames_ += frame ? 1 : 0;
+    cells_diffed_ += counters.cells_diffed;
+    cells_changed_ += counters.cells_changed;
+    for (std::size_t i = 0; i < output_kinds; ++i)
+    {
+        classified_[i] += counters.bytes[i];
+    }
+}
+
+Statistics::Timestamp Statistics::refresh_started() const
+{
+    Timestamp now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now;
+}
+
+void Statistics::refresh_finished(const Timestamp& start)
+{
+    const Timestamp now = refresh_started();
+    const long microseconds = (now.tv_sec - start.tv_sec) * 1000000 + (now.tv_nsec - start.tv_nsec) / 1000;
+    latency_.add(microseconds > 0 ? static_cast<unsigned long>(microseconds) : 0);
+}
+
+void Statistics::export_to(SCREEN_STATS& stats) const
+{
+    stats.frames = frames_;
+    stats.cells_diffed = cells_diffed_;
+    stats.cells_changed = cells_changed_;
+    stats.bytes = bytes_;
+    stats.text_bytes = classified_[static_cast<std::size_t>(OutputKind::text)];
+    stats.motion_bytes = classified_[static_cast<std::size_t>(OutputKind::motion)];
+    stats.attribute_bytes = classified_[static_cast<std::size_t>(OutputKind::attributes)];
+    stats.erase_bytes = classified_[static_cast<std::size_t>(OutputKind::erase)];
+    stats.syscalls = syscalls_;
+    stats.refresh_p50_us = latency_.percentile(500);
+    stats.refresh_p90_us = latency_.percentile(900);
+    stats.refresh_p99_us = latency_.percentile(990);
+    stats.refresh_max_us = latency_.maximum();
+    stats.input_bytes = input_bytes_;
+    stats.keys = keys_;
+}
+
+} // namespace msos::curses
+
+#endif // CURSES_STATS
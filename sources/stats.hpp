@@ -0,0 +1,170 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <time.h>
+
+#include "curses.h"
+
+namespace msos::curses
+{
+
+// Renderer output, bytes of other writes are counted as total only
+enum class OutputKind : std::uint8_t
+{
+    text,
+    motion,
+    attributes,
+    erase
+};
+
+constexpr std::size_t output_kinds = 4;
+
+// Work of one renderer update, added to every screen that received it
+struct RenderCounters
+{
+    // Cells of lines that differed and were compared cell by cell
+    unsigned long cells_diffed = 0;
+    // Cells sent to terminal, erased ones included
+    unsigned long cells_changed = 0;
+    unsigned long bytes[output_kinds] = {};
+};
+
+#if CURSES_STATS
+
+// Refresh latency in microseconds. Each power of two is split into four
+// buckets, so percentile is at most 25% above measured value.
+class LatencyHistogram
+{
+public:
+    void add(unsigned long microseconds);
+    // Upper bound of bucket holding per_mille of samples, at most maximum
+    unsigned long percentile(unsigned per_mille) const;
+    unsigned long maximum() const;
+
+private:
+    constexpr static std::size_t octaves = 24;
+    constexpr static std::size_t bucket_count = (octaves - 1) * 4;
+
+    static std::size_t bucket(unsigned long microseconds);
+    static unsigned long upper_bound(std::size_t bucket);
+
+    std::uint32_t buckets_[bucket_count] = {};
+    unsigned long count_ = 0;
+    unsigned long maximum_ = 0;
+};
+
+// Counters of one screen. Disabled with CURSES_STATS, then all calls are
+// empty and no clock is read.
+class Statistics
+{
+public:
+    using Timestamp = struct timespec;
+
+    void output(std::size_t size)
+    {
+        bytes_ += size;
+    }
+
+    // Bytes of other writes that belong to known kind
+    void classify(OutputKind kind, std::size_t size)
+    {
+        classified_[static_cast<std::size_t>(kind)] += size;
+    }
+
+    void render(const RenderCounters& counters, bool frame);
+
+    void syscalls(int count)
+    {
+        syscalls_ += static_cast<unsigned long>(count);
+    }
+
+    void input(std::size_t size)
+    {
+        input_bytes_ += size;
+    }
+
+    void keys(int count)
+    {
+        keys_ += static_cast<unsigned long>(count);
+    }
+
+    Timestamp refresh_started() const;
+    void refresh_finished(const Timestamp& start);
+
+    void export_to(SCREEN_STATS& stats) const;
+
+private:
+    unsigned long frames_ = 0;
+    unsigned long cells_diffed_ = 0;
+    unsigned long cells_changed_ = 0;
+    unsigned long bytes_ = 0;
+    unsigned long classified_[output_kinds] = {};
+    unsigned long syscalls_ = 0;
+    unsigned long input_bytes_ = 0;
+    unsigned long keys_ = 0;
+    LatencyHistogram latency_;
+};
+
+#else
+
+class Statistics
+{
+public:
+    using Timestamp = int;
+
+    void output(std::size_t)
+    {
+    }
+
+    void classify(OutputKind, std::size_t)
+    {
+    }
+
+    void render(const RenderCounters&, bool)
+    {
+    }
+
+    void syscalls(int)
+    {
+    }
+
+    void input(std::size_t)
+    {
+    }
+
+    void keys(int)
+    {
+    }
+
+    Timestamp refresh_started() const
+    {
+        return 0;
+    }
+
+    void refresh_finished(const Timestamp&)
+    {
+    }
+};
+
+#endif // CURSES_STATS
+
+} // namespace msos::curses
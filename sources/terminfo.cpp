@@ -0,0 +1,513 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "terminfo.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#if CURSES_BUILTIN_TERMINALS
+    #include "builtin_terminals.hpp"
+#endif // CURSES_BUILTIN_TERMINALS
+
+#if CURSES_TERMINFO_FILES
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif // CURSES_TERMINFO_FILES
+
+namespace msos::curses
+{
+
+namespace
+{
+
+constexpr unsigned legacy_magic = 0432;
+constexpr unsigned extended_number_magic = 01036;
+constexpr std::size_t header_size = 12;
+constexpr std::size_t extended_header_size = 10;
+
+int read_short(const std::uint8_t* data)
+{
+    return static_cast<std::int16_t>(static_cast<std::uint16_t>(data[0] | data[1] << 8));
+}
+
+int read_int(const std::uint8_t* data)
+{
+    const std::uint32_t value = static_cast<std::uint32_t>(data[0]) | static_cast<std::uint32_t>(data[1]) << 8
+        | static_cast<std::uint32_t>(data[2]) << 16 | static_cast<std::uint32_t>(data[3]) << 24;
+    return static_cast<std::int32_t>(value);
+}
+
+std::size_t even(std::size_t size)
+{
+    return size + (size & 1);
+}
+
+const CapabilityName* find_name(const CapabilityName* first, const CapabilityName* last, const char* name)
+{
+    const CapabilityName* found = std::lower_bound(first, last, name,
+        [](const CapabilityName& entry, const char* value) {
+            return std::strcmp(entry.name, value) < 0;
+        });
+    return found != last && std::strcmp(found->name, name) == 0 ? found : nullptr;
+}
+
+template <std::size_t N, std::size_t M>
+const CapabilityName* find_name(const CapabilityName (&terminfo)[N], const CapabilityName (&termcap)[M],
+    Naming naming, const char* name)
+{
+    return naming == Naming::terminfo ? find_name(std::begin(terminfo), std::end(terminfo), name)
+                                      : find_name(std::begin(termcap), std::end(termcap), name);
+}
+
+} // namespace
+
+Terminfo::~Terminfo()
+{
+    close();
+}
+
+bool Terminfo::load(const char* term)
+{
+    close();
+#ifdef CURSES_TERMINAL
+    static_cast<void>(term);
+    return use(terminals::CURSES_TERMINAL);
+#else
+    if (term == nullptr || *term == 0 || std::strchr(term, '/') != nullptr)
+    {
+        return false;
+    }
+
+#if CURSES_TERMINFO_FILES
+    const char* terminfo = std::getenv("TERMINFO");
+    if (terminfo != nullptr && *terminfo != 0 && load_from(terminfo, std::strlen(terminfo), term))
+    {
+        return true;
+    }
+
+    const char* home = std::getenv("HOME");
+    if (home != nullptr && *home != 0)
+    {
+        char directory[TERMINFO_PATH_SIZE];
+        const int length = std::snprintf(directory, sizeof(directory), "%s/.terminfo", home);
+        if (length > 0 && static_cast<std::size_t>(length) < sizeof(directory)
+            && load_from(directory, static_cast<std::size_t>(length), term))
+        {
+            return true;
+        }
+    }
+
+    const char* directories = std::getenv("TERMINFO_DIRS");
+    if (search(directories != nullptr ? directories : TERMINFO_DEFAULT_DIRS, term))
+    {
+        return true;
+    }
+#endif // CURSES_TERMINFO_FILES
+    return load_builtin(term);
+#endif // CURSES_TERMINAL
+}
+
+bool Terminfo::load_builtin(const char* term)
+{
+#if CURSES_BUILTIN_TERMINALS && !defined(CURSES_TERMINAL)
+    for (const Description* description : terminals::all)
+    {
+        if (description->matches(term))
+        {
+            return use(*description);
+        }
+    }
+#else
+    static_cast<void>(term);
+#endif // CURSES_BUILTIN_TERMINALS && !defined(CURSES_TERMINAL)
+    return false;
+}
+
+bool Terminfo::search(const char* directories, const char* term)
+{
+    while (true)
+    {
+        const char* end = std::strchr(directories, ':');
+        const std::size_t length = end != nullptr ? static_cast<std::size_t>(end - directories) : std::strlen(directories);
+        // Empty entry stands for default directories
+        const bool found = length == 0 ? search(TERMINFO_DEFAULT_DIRS, term) : load_from(directories, length, term);
+        if (found)
+        {
+            return true;
+        }
+        if (end == nullptr)
+        {
+            return false;
+        }
+        directories = end + 1;
+    }
+}
+
+bool Terminfo::load_from(const char* directory, std::size_t length, const char* term)
+{
+    // Entries are grouped by first letter, some systems use its hex code
+    char path[TERMINFO_PATH_SIZE];
+    const int size = static_cast<int>(std::min(length, sizeof(path)));
+    int written = std::snprintf(path, sizeof(path), "%.*s/%c/%s", size, directory, term[0], term);
+    if (written > 0 && static_cast<std::size_t>(written) < sizeof(path) && map(path))
+    {
+        return true;
+    }
+
+    written = std::snprintf(path, sizeof(path), "%.*s/%02x/%s", size, directory,
+        static_cast<unsigned>(static_cast<unsigned char>(term[0])), term);
+    return written > 0 && static_cast<std::size_t>(written) < sizeof(path) && map(path);
+}
+
+bool Terminfo::map(const char* path)
+{
+#if CURSES_TERMINFO_FILES
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat status = {};
+    void* data = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && status.st_size > 0)
+    {
+        data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(status.st_size);
+    if (!use(static_cast<const std::uint8_t*>(data), size))
+    {
+        munmap(data, size);
+        return false;
+    }
+    mapped_ = true;
+    return true;
+#else
+    static_cast<void>(path);
+    return false;
+#endif // CURSES_TERMINFO_FILES
+}
+
+bool Terminfo::use(const std::uint8_t* data, std::size_t size)
+{
+    close();
+    if (data == nullptr || size < header_size)
+    {
+        return false;
+    }
+
+    const unsigned magic = static_cast<unsigned>(read_short(data)) & 0xffff;
+    if (magic != legacy_magic && magic != extended_number_magic)
+    {
+        return false;
+    }
+
+    int counts[5];
+    for (int i = 0; i < 5; ++i)
+    {
+        counts[i] = read_short(data + 2 + i * 2);
+        if (counts[i] < 0)
+        {
+            return false;
+        }
+    }
+
+    const std::size_t number_size = magic == extended_number_magic ? 4 : 2;
+    const std::size_t names_size = static_cast<std::size_t>(counts[0]);
+    Section section;
+    section.boolean_count = static_cast<std::size_t>(counts[1]);
+    section.number_count = static_cast<std::size_t>(counts[2]);
+    section.string_count = static_cast<std::size_t>(counts[3]);
+    section.table_size = static_cast<std::size_t>(counts[4]);
+
+    std::size_t offset = header_size + names_size;
+    section.booleans = data + offset;
+    offset = even(offset + section.boolean_count);
+    section.numbers = data + offset;
+    offset += section.number_count * number_size;
+    section.strings = data + offset;
+    offset += section.string_count * 2;
+    section.table = data + offset;
+    offset += section.table_size;
+    if (offset > size || names_size == 0 || data[header_size + names_size - 1] != 0)
+    {
+        return false;
+    }
+
+    data_ = data;
+    size_ = size;
+    number_size_ = number_size;
+    names_ = reinterpret_cast<const char*>(data + header_size);
+    standard_ = section;
+
+    // Entry without valid extended part is still usable
+    offset = even(offset);
+    if (offset + extended_header_size <= size && !parse_extended(data + offset, size - offset))
+    {
+        extended_ = Section();
+        extended_names_ = nullptr;
+    }
+    return true;
+}
+
+bool Terminfo::parse_extended(const std::uint8_t* data, std::size_t size)
+{
+    int counts[5];
+    for (int i = 0; i < 5; ++i)
+    {
+        counts[i] = read_short(data + i * 2);
+        if (counts[i] < 0)
+        {
+            return false;
+        }
+    }
+
+    Section section;
+    section.boolean_count = static_cast<std::size_t>(counts[0]);
+    section.number_count = static_cast<std::size_t>(counts[1]);
+    section.string_count = static_cast<std::size_t>(counts[2]);
+    const std::size_t offsets = static_cast<std::size_t>(counts[3]);
+    section.table_size = static_cast<std::size_t>(counts[4]);
+    const std::size_t name_count = section.boolean_count + section.number_count + section.string_count;
+    if (offsets != section.string_count + name_count)
+    {
+        return false;
+    }
+
+    std::size_t offset = extended_header_size;
+    section.booleans = data + offset;
+    offset = even(offset + section.boolean_count);
+    section.numbers = data + offset;
+    offset += section.number_count * number_size_;
+    section.strings = data + offset;
+    offset += offsets * 2;
+    section.table = data + offset;
+    offset += section.table_size;
+    if (offset > size)
+    {
+        return false;
+    }
+
+    // Names start after the last string value
+    std::size_t names_start = 0;
+    for (std::size_t i = 0; i < section.string_count; ++i)
+    {
+        const char* value = read_string(section, i);
+        if (value != nullptr)
+        {
+            const std::size_t end = static_cast<std::size_t>(value - reinterpret_cast<const char*>(section.table))
+                + std::strlen(value) + 1;
+            names_start = std::max(names_start, end);
+        }
+    }
+
+    extended_ = section;
+    extended_names_ = section.strings + section.string_count * 2;
+    extended_name_table_ = section.table + names_start;
+    extended_name_table_size_ = section.table_size - names_start;
+    return true;
+}
+
+bool Terminfo::use(const Description& description)
+{
+    close();
+    description_ = &description;
+    names_ = description.names();
+    return true;
+}
+
+void Terminfo::close()
+{
+#if CURSES_TERMINFO_FILES
+    if (mapped_)
+    {
+        munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+#endif // CURSES_TERMINFO_FILES
+    description_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    names_ = nullptr;
+    standard_ = Section();
+    extended_ = Section();
+    extended_names_ = nullptr;
+    extended_name_table_ = nullptr;
+    extended_name_table_size_ = 0;
+}
+
+bool Terminfo::loaded() const
+{
+    return data_ != nullptr || description_ != nullptr;
+}
+
+const char* Terminfo::names() const
+{
+    return names_;
+}
+
+#ifndef CURSES_TERMINAL
+bool Terminfo::flag(Boolean capability) const
+{
+    if (description_ != nullptr)
+    {
+        return description_->flag(capability);
+    }
+    const std::size_t index = static_cast<std::size_t>(capability);
+    return index < standard_.boolean_count && standard_.booleans[index] == 1;
+}
+
+int Terminfo::number(Number capability) const
+{
+    if (description_ != nullptr)
+    {
+        return description_->number(capability);
+    }
+    return read_number(standard_, static_cast<std::size_t>(capability));
+}
+
+const char* Terminfo::string(String capability) const
+{
+    if (description_ != nullptr)
+    {
+        return description_->string(capability);
+    }
+    return read_string(standard_, static_cast<std::size_t>(capability));
+}
+#endif // CURSES_TERMINAL
+
+int Terminfo::flag(const char* name, Naming naming) const
+{
+    const CapabilityName* found = find_name(boolean_names, boolean_codes, naming, name);
+    if (found != nullptr)
+    {
+        return flag(static_cast<Boolean>(found->index));
+    }
+
+    const int position = find_extended(name);
+    if (position >= 0 && static_cast<std::size_t>(position) < extended_.boolean_count)
+    {
+        return extended_.booleans[position] == 1;
+    }
+    return -1;
+}
+
+int Terminfo::number(const char* name, Naming naming) const
+{
+    const CapabilityName* found = find_name(number_names, number_codes, naming, name);
+    if (found != nullptr)
+    {
+        return number(static_cast<Number>(found->index));
+    }
+
+    const int position = find_extended(name) - static_cast<int>(extended_.boolean_count);
+    if (position >= 0 && static_cast<std::size_t>(position) < extended_.number_count)
+    {
+        return read_number(extended_, static_cast<std::size_t>(position));
+    }
+    return -2;
+}
+
+const char* Terminfo::string(const char* name, bool* known, Naming naming) const
+{
+    *known = true;
+    const CapabilityName* found = find_name(string_names, string_codes, naming, name);
+    if (found != nullptr)
+    {
+        return string(static_cast<String>(found->index));
+    }
+
+    const int position = find_extended(name) - static_cast<int>(extended_.boolean_count + extended_.number_count);
+    if (position >= 0 && static_cast<std::size_t>(position) < extended_.string_count)
+    {
+        return read_string(extended_, static_cast<std::size_t>(position));
+    }
+    *known = false;
+    return nullptr;
+}
+
+int Terminfo::read_number(const Section& section, std::size_t index) const
+{
+    if (index >= section.number_count)
+    {
+        return -1;
+    }
+
+    const std::uint8_t* data = section.numbers + index * number_size_;
+    const int value = number_size_ == 4 ? read_int(data) : read_short(data);
+    return value < 0 ? -1 : value;
+}
+
+const char* Terminfo::read_string(const Section& section, std::size_t index) const
+{
+    if (index >= section.string_count)
+    {
+        return nullptr;
+    }
+
+    const int offset = read_short(section.strings + index * 2);
+    if (offset < 0 || static_cast<std::size_t>(offset) >= section.table_size)
+    {
+        return nullptr;
+    }
+
+    const std::uint8_t* value = section.table + offset;
+    if (std::memchr(value, 0, section.table_size - static_cast<std::size_t>(offset)) == nullptr)
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const char*>(value);
+}
+
+int Terminfo::find_extended(const char* name) const
+{
+    if (extended_names_ == nullptr)
+    {
+        return -1;
+    }
+
+    const std::size_t count = extended_.boolean_count + extended_.number_count + extended_.string_count;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const int offset = read_short(extended_names_ + i * 2);
+        if (offset < 0 || static_cast<std::size_t>(offset) >= extended_name_table_size_)
+        {
+            continue;
+        }
+
+        const char* candidate = reinterpret_cast<const char*>(extended_name_table_ + offset);
+        const std::size_t limit = extended_name_table_size_ - static_cast<std::size_t>(offset);
+        if (std::strncmp(candidate, name, limit) == 0 && std::memchr(candidate, 0, limit) != nullptr)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+} // namespace msos::curses
@@ -0,0 +1,213 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "description.hpp"
+#include "terminfo_names.hpp"
+
+// Load compiled terminfo entries from file system
+#ifndef CURSES_TERMINFO_FILES
+    #define CURSES_TERMINFO_FILES 1
+#endif // CURSES_TERMINFO_FILES
+
+// Use built-in description when terminal is not found in database
+#ifndef CURSES_BUILTIN_TERMINALS
+    #define CURSES_BUILTIN_TERMINALS 1
+#endif // CURSES_BUILTIN_TERMINALS
+
+// When defined to one of built-in descriptions (vt100, vt220, xterm_256color,
+// linux_console, screen), it is used for every terminal. Database is never
+// searched and capability lookups are constant expressions.
+#ifdef CURSES_TERMINAL
+    #include "builtin_terminals.hpp"
+#endif // CURSES_TERMINAL
+
+// Searched when neither TERMINFO nor TERMINFO_DIRS points to entry
+#ifndef TERMINFO_DEFAULT_DIRS
+    #define TERMINFO_DEFAULT_DIRS "/etc/terminfo:/lib/terminfo:/usr/share/terminfo"
+#endif // TERMINFO_DEFAULT_DIRS
+
+#ifndef TERMINFO_PATH_SIZE
+    #define TERMINFO_PATH_SIZE 256
+#endif // TERMINFO_PATH_SIZE
+
+namespace msos::curses
+{
+
+enum class Naming
+{
+    terminfo,
+    termcap
+};
+
+// Compiled terminfo entry, legacy or with 32-bit numbers. Sections are
+// located once when entry is loaded, capabilities are read directly from
+// entry data on each access.
+class Terminfo
+{
+public:
+    Terminfo() = default;
+    Terminfo(const Terminfo&) = delete;
+    Terminfo& operator=(const Terminfo&) = delete;
+    ~Terminfo();
+
+    // Maps entry of terminal from terminfo directories
+    bool load(const char* term);
+    // Uses entry already in memory, data must outlive this object
+    bool use(const std::uint8_t* data, std::size_t size);
+    bool use(const Description& description);
+    void close();
+
+    bool loaded() const;
+    // Names separated with '|', last one describes terminal
+    const char* names() const;
+
+#ifdef CURSES_TERMINAL
+    constexpr bool flag(Boolean capability) const
+    {
+        return terminals::CURSES_TERMINAL.flag(capability);
+    }
+
+    constexpr int number(Number capability) const
+    {
+        return terminals::CURSES_TERMINAL.number(capability);
+    }
+
+    constexpr const char* string(String capability) const
+    {
+        return terminals::CURSES_TERMINAL.string(capability);
+    }
+#else
+    bool flag(Boolean capability) const;
+    // -1 when absent
+    int number(Number capability) const;
+    // nullptr when absent
+    const char* string(String capability) const;
+#endif // CURSES_TERMINAL
+
+    // Also finds extended capabilities, returns -1 when name is not boolean
+    int flag(const char* name, Naming naming = Naming::terminfo) const;
+    // Returns -2 when name is not numeric, -1 when capability is absent
+    int number(const char* name, Naming naming = Naming::terminfo) const;
+    // Returns nullptr when absent, known is false when name is not string
+    const char* string(const char* name, bool* known, Naming naming = Naming::terminfo) const;
+
+private:
+    struct Section
+    {
+        const std::uint8_t* booleans = nullptr;
+        const std::uint8_t* numbers = nullptr;
+        const std::uint8_t* strings = nullptr;
+        const std::uint8_t* table = nullptr;
+        std::size_t boolean_count = 0;
+        std::size_t number_count = 0;
+        std::size_t string_count = 0;
+        std::size_t table_size = 0;
+    };
+
+    bool load_builtin(const char* term);
+    bool load_from(const char* directory, std::size_t length, const char* term);
+    bool search(const char* directories, const char* term);
+    bool map(const char* path);
+    bool parse_extended(const std::uint8_t* data, std::size_t size);
+    int read_number(const Section& section, std::size_t index) const;
+    const char* read_string(const Section& section, std::size_t index) const;
+    // Position of extended capability, counted over booleans, numbers and strings
+    int find_extended(const char* name) const;
+
+    const Description* description_ = nullptr;
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::size_t number_size_ = 2;
+    const char* names_ = nullptr;
+    Section standard_;
+    Section extended_;
+    // Names of extended capabilities follow their values in string table
+    const std::uint8_t* extended_names_ = nullptr;
+    const std::uint8_t* extended_name_table_ = nullptr;
+    std::size_t extended_name_table_size_ = 0;
+};
+
+// Calls output with parts of capability string and padding with delay of
+// each $<> in tenths of millisecond. Delay marked with '*' is multiplied
+// by affected lines, one marked with '/' is mandatory.
+template <typename Output, typename Padding>
+void split_padding(const char* str, int affected, Output output, Padding padding)
+{
+    const char* start = str;
+    while (*str != 0)
+    {
+        if (str[0] == '$' && str[1] == '<')
+        {
+            const char* end = str + 2;
+            while (*end != 0 && *end != '>')
+            {
+                ++end;
+            }
+            if (*end == '>')
+            {
+                if (str != start)
+                {
+                    output(start, static_cast<std::size_t>(str - start));
+                }
+
+                int tenths = 0;
+                bool fraction = false;
+                bool proportional = false;
+                bool mandatory = false;
+                for (const char* c = str + 2; c != end; ++c)
+                {
+                    if (*c >= '0' && *c <= '9' && !fraction)
+                    {
+                        tenths = tenths * 10 + (*c - '0');
+                    }
+                    else if (*c == '.' && !fraction)
+                    {
+                        fraction = true;
+                        tenths = tenths * 10 + (c[1] >= '0' && c[1] <= '9' ? c[1] - '0' : 0);
+                    }
+                    proportional = proportional || *c == '*';
+                    mandatory = mandatory || *c == '/';
+                }
+                tenths = fraction ? tenths : tenths * 10;
+                padding(proportional ? tenths * affected : tenths, mandatory);
+                str = end + 1;
+                start = str;
+                continue;
+            }
+        }
+        ++str;
+    }
+    if (str != start)
+    {
+        output(start, static_cast<std::size_t>(str - start));
+    }
+}
+
+// Calls output with parts of capability string, skipping $<> padding
+template <typename Output>
+void without_padding(const char* str, Output output)
+{
+    split_padding(str, 1, output, [](int, bool) {
+    });
+}
+
+} // namespace msos::curses
@@ -0,0 +1,1558 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+
+namespace msos::curses
+{
+
+// Capabilities in order of compiled terminfo format, see term(5)
+
+enum class Boolean : std::uint16_t
+{
+    auto_left_margin,
+    auto_right_margin,
+    no_esc_ctlc,
+    ceol_standout_glitch,
+    eat_newline_glitch,
+    erase_overstrike,
+    generic_type,
+    hard_copy,
+    has_meta_key,
+    has_status_line,
+    insert_null_glitch,
+    memory_above,
+    memory_below,
+    move_insert_mode,
+    move_standout_mode,
+    over_strike,
+    status_line_esc_ok,
+    dest_tabs_magic_smso,
+    tilde_glitch,
+    transparent_underline,
+    xon_xoff,
+    needs_xon_xoff,
+    prtr_silent,
+    hard_cursor,
+    non_rev_rmcup,
+    no_pad_char,
+    non_dest_scroll_region,
+    can_change,
+    back_color_erase,
+    hue_lightness_saturation,
+    col_addr_glitch,
+    cr_cancels_micro_mode,
+    has_print_wheel,
+    row_addr_glitch,
+    semi_auto_right_margin,
+    cpi_changes_res,
+    lpi_changes_res,
+    backspaces_with_bs,
+    crt_no_scrolling,
+    no_correctly_working_cr,
+    gnu_has_meta_key,
+    linefeed_is_newline,
+    has_hardware_tabs,
+    return_does_clr_eol,
+};
+
+enum class Number : std::uint16_t
+{
+    columns,
+    init_tabs,
+    lines,
+    lines_of_memory,
+    magic_cookie_glitch,
+    padding_baud_rate,
+    virtual_terminal,
+    width_status_line,
+    num_labels,
+    label_height,
+    label_width,
+    max_attributes,
+    maximum_windows,
+    max_colors,
+    max_pairs,
+    no_color_video,
+    buffer_capacity,
+    dot_vert_spacing,
+    dot_horz_spacing,
+    max_micro_address,
+    max_micro_jump,
+    micro_col_size,
+    micro_line_size,
+    number_of_pins,
+    output_res_char,
+    output_res_line,
+    output_res_horz_inch,
+    output_res_vert_inch,
+    print_rate,
+    wide_char_size,
+    buttons,
+    bit_image_entwining,
+    bit_image_type,
+    magic_cookie_glitch_ul,
+    carriage_return_delay,
+    new_line_delay,
+    backspace_delay,
+    horizontal_tab_delay,
+    number_of_function_keys,
+};
+
+enum class String : std::uint16_t
+{
+    back_tab,
+    bell,
+    carriage_return,
+    change_scroll_region,
+    clear_all_tabs,
+    clear_screen,
+    clr_eol,
+    clr_eos,
+    column_address,
+    command_character,
+    cursor_address,
+    cursor_down,
+    cursor_home,
+    cursor_invisible,
+    cursor_left,
+    cursor_mem_address,
+    cursor_normal,
+    cursor_right,
+    cursor_to_ll,
+    cursor_up,
+    cursor_visible,
+    delete_character,
+    delete_line,
+    dis_status_line,
+    down_half_line,
+    enter_alt_charset_mode,
+    enter_blink_mode,
+    enter_bold_mode,
+    enter_ca_mode,
+    enter_delete_mode,
+    enter_dim_mode,
+    enter_insert_mode,
+    enter_secure_mode,
+    enter_protected_mode,
+    enter_reverse_mode,
+    enter_standout_mode,
+    enter_underline_mode,
+    erase_chars,
+    exit_alt_charset_mode,
+    exit_attribute_mode,
+    exit_ca_mode,
+    exit_delete_mode,
+    exit_insert_mode,
+    exit_standout_mode,
+    exit_underline_mode,
+    flash_screen,
+    form_feed,
+    from_status_line,
+    init_1string,
+    init_2string,
+    init_3string,
+    init_file,
+    insert_character,
+    insert_line,
+    insert_padding,
+    key_backspace,
+    key_catab,
+    key_clear,
+    key_ctab,
+    key_dc,
+    key_dl,
+    key_down,
+    key_eic,
+    key_eol,
+    key_eos,
+    key_f0,
+    key_f1,
+    key_f10,
+    key_f2,
+    key_f3,
+    key_f4,
+    key_f5,
+    key_f6,
+    key_f7,
+    key_f8,
+    key_f9,
+    key_home,
+    key_ic,
+    key_il,
+    key_left,
+    key_ll,
+    key_npage,
+    key_ppage,
+    key_right,
+    key_sf,
+    key_sr,
+    key_stab,
+    key_up,
+    keypad_local,
+    keypad_xmit,
+    lab_f0,
+    lab_f1,
+    lab_f10,
+    lab_f2,
+    lab_f3,
+    lab_f4,
+    lab_f5,
+    lab_f6,
+    lab_f7,
+    lab_f8,
+    lab_f9,
+    meta_off,
+    meta_on,
+    newline,
+    pad_char,
+    parm_dch,
+    parm_delete_line,
+    parm_down_cursor,
+    parm_ich,
+    parm_index,
+    parm_insert_line,
+    parm_left_cursor,
+    parm_right_cursor,
+    parm_rindex,
+    parm_up_cursor,
+    pkey_key,
+    pkey_local,
+    pkey_xmit,
+    print_screen,
+    prtr_off,
+    prtr_on,
+    repeat_char,
+    reset_1string,
+    reset_2string,
+    reset_3string,
+    reset_file,
+    restore_cursor,
+    row_address,
+    save_cursor,
+    scroll_forward,
+    scroll_reverse,
+    set_attributes,
+    set_tab,
+    set_window,
+    tab,
+    to_status_line,
+    underline_char,
+    up_half_line,
+    init_prog,
+    key_a1,
+    key_a3,
+    key_b2,
+    key_c1,
+    key_c3,
+    prtr_non,
+    char_padding,
+    acs_chars,
+    plab_norm,
+    key_btab,
+    enter_xon_mode,
+    exit_xon_mode,
+    enter_am_mode,
+    exit_am_mode,
+    xon_character,
+    xoff_character,
+    ena_acs,
+    label_on,
+    label_off,
+    key_beg,
+    key_cancel,
+    key_close,
+    key_command,
+    key_copy,
+    key_create,
+    key_end,
+    key_enter,
+    key_exit,
+    key_find,
+    key_help,
+    key_mark,
+    key_message,
+    key_move,
+    key_next,
+    key_open,
+    key_options,
+    key_previous,
+    key_print,
+    key_redo,
+    key_reference,
+    key_refresh,
+    key_replace,
+    key_restart,
+    key_resume,
+    key_save,
+    key_suspend,
+    key_undo,
+    key_sbeg,
+    key_scancel,
+    key_scommand,
+    key_scopy,
+    key_screate,
+    key_sdc,
+    key_sdl,
+    key_select,
+    key_send,
+    key_seol,
+    key_sexit,
+    key_sfind,
+    key_shelp,
+    key_shome,
+    key_sic,
+    key_sleft,
+    key_smessage,
+    key_smove,
+    key_snext,
+    key_soptions,
+    key_sprevious,
+    key_sprint,
+    key_sredo,
+    key_sreplace,
+    key_sright,
+    key_srsume,
+    key_ssave,
+    key_ssuspend,
+    key_sundo,
+    req_for_input,
+    key_f11,
+    key_f12,
+    key_f13,
+    key_f14,
+    key_f15,
+    key_f16,
+    key_f17,
+    key_f18,
+    key_f19,
+    key_f20,
+    key_f21,
+    key_f22,
+    key_f23,
+    key_f24,
+    key_f25,
+    key_f26,
+    key_f27,
+    key_f28,
+    key_f29,
+    key_f30,
+    key_f31,
+    key_f32,
+    key_f33,
+    key_f34,
+    key_f35,
+    key_f36,
+    key_f37,
+    key_f38,
+    key_f39,
+    key_f40,
+    key_f41,
+    key_f42,
+    key_f43,
+    key_f44,
+    key_f45,
+    key_f46,
+    key_f47,
+    key_f48,
+    key_f49,
+    key_f50,
+    key_f51,
+    key_f52,
+    key_f53,
+    key_f54,
+    key_f55,
+    key_f56,
+    key_f57,
+    key_f58,
+    key_f59,
+    key_f60,
+    key_f61,
+    key_f62,
+    key_f63,
+    clr_bol,
+    clear_margins,
+    set_left_margin,
+    set_right_margin,
+    label_format,
+    set_clock,
+    display_clock,
+    remove_clock,
+    create_window,
+    goto_window,
+    hangup,
+    dial_phone,
+    quick_dial,
+    tone,
+    pulse,
+    flash_hook,
+    fixed_pause,
+    wait_tone,
+    user0,
+    user1,
+    user2,
+    user3,
+    user4,
+    user5,
+    user6,
+    user7,
+    user8,
+    user9,
+    orig_pair,
+    orig_colors,
+    initialize_color,
+    initialize_pair,
+    set_color_pair,
+    set_foreground,
+    set_background,
+    change_char_pitch,
+    change_line_pitch,
+    change_res_horz,
+    change_res_vert,
+    define_char,
+    enter_doublewide_mode,
+    enter_draft_quality,
+    enter_italics_mode,
+    enter_leftward_mode,
+    enter_micro_mode,
+    enter_near_letter_quality,
+    enter_normal_quality,
+    enter_shadow_mode,
+    enter_subscript_mode,
+    enter_superscript_mode,
+    enter_upward_mode,
+    exit_doublewide_mode,
+    exit_italics_mode,
+    exit_leftward_mode,
+    exit_micro_mode,
+    exit_shadow_mode,
+    exit_subscript_mode,
+    exit_superscript_mode,
+    exit_upward_mode,
+    micro_column_address,
+    micro_down,
+    micro_left,
+    micro_right,
+    micro_row_address,
+    micro_up,
+    order_of_pins,
+    parm_down_micro,
+    parm_left_micro,
+    parm_right_micro,
+    parm_up_micro,
+    select_char_set,
+    set_bottom_margin,
+    set_bottom_margin_parm,
+    set_left_margin_parm,
+    set_right_margin_parm,
+    set_top_margin,
+    set_top_margin_parm,
+    start_bit_image,
+    start_char_set_def,
+    stop_bit_image,
+    stop_char_set_def,
+    subscript_characters,
+    superscript_characters,
+    these_cause_cr,
+    zero_motion,
+    char_set_names,
+    key_mouse,
+    mouse_info,
+    req_mouse_pos,
+    get_mouse,
+    set_a_foreground,
+    set_a_background,
+    pkey_plab,
+    device_type,
+    code_set_init,
+    set0_des_seq,
+    set1_des_seq,
+    set2_des_seq,
+    set3_des_seq,
+    set_lr_margin,
+    set_tb_margin,
+    bit_image_repeat,
+    bit_image_newline,
+    bit_image_carriage_return,
+    color_names,
+    define_bit_image_region,
+    end_bit_image_region,
+    set_color_band,
+    set_page_length,
+    display_pc_char,
+    enter_pc_charset_mode,
+    exit_pc_charset_mode,
+    enter_scancode_mode,
+    exit_scancode_mode,
+    pc_term_options,
+    scancode_escape,
+    alt_scancode_esc,
+    enter_horizontal_hl_mode,
+    enter_left_hl_mode,
+    enter_low_hl_mode,
+    enter_right_hl_mode,
+    enter_top_hl_mode,
+    enter_vertical_hl_mode,
+    set_a_attributes,
+    set_pglen_inch,
+    termcap_init2,
+    termcap_reset,
+    linefeed_if_not_lf,
+    backspace_if_not_bs,
+    other_non_function_keys,
+    arrow_key_map,
+    acs_ulcorner,
+    acs_llcorner,
+    acs_urcorner,
+    acs_lrcorner,
+    acs_ltee,
+    acs_rtee,
+    acs_btee,
+    acs_ttee,
+    acs_hline,
+    acs_vline,
+    acs_plus,
+    memory_lock,
+    memory_unlock,
+    box_chars_1,
+};
+
+struct CapabilityName
+{
+    const char* name;
+    std::uint16_t index;
+};
+
+// Terminfo names sorted for binary search
+constexpr CapabilityName boolean_names[] = {
+    {"OTMT", 40},
+    {"OTNL", 41},
+    {"OTbs", 37},
+    {"OTnc", 39},
+    {"OTns", 38},
+    {"OTpt", 42},
+    {"OTxr", 43},
+    {"am", 1},
+    {"bce", 28},
+    {"bw", 0},
+    {"ccc", 27},
+    {"chts", 23},
+    {"cpix", 35},
+    {"crxm", 31},
+    {"da", 11},
+    {"daisy", 32},
+    {"db", 12},
+    {"eo", 5},
+    {"eslok", 16},
+    {"gn", 6},
+    {"hc", 7},
+    {"hls", 29},
+    {"hs", 9},
+    {"hz", 18},
+    {"in", 10},
+    {"km", 8},
+    {"lpix", 36},
+    {"mc5i", 22},
+    {"mir", 13},
+    {"msgr", 14},
+    {"ndscr", 26},
+    {"npc", 25},
+    {"nrrmc", 24},
+    {"nxon", 21},
+    {"os", 15},
+    {"sam", 34},
+    {"ul", 19},
+    {"xenl", 4},
+    {"xhp", 3},
+    {"xhpa", 30},
+    {"xon", 20},
+    {"xsb", 2},
+    {"xt", 17},
+    {"xvpa", 33},
+};
+
+// Terminfo names sorted for binary search
+constexpr CapabilityName number_names[] = {
+    {"OTdB", 36},
+    {"OTdC", 34},
+    {"OTdN", 35},
+    {"OTdT", 37},
+    {"OTkn", 38},
+    {"OTug", 33},
+    {"bitwin", 31},
+    {"bitype", 32},
+    {"btns", 30},
+    {"bufsz", 16},
+    {"colors", 13},
+    {"cols", 0},
+    {"cps", 28},
+    {"it", 1},
+    {"lh", 9},
+    {"lines", 2},
+    {"lm", 3},
+    {"lw", 10},
+    {"ma", 11},
+    {"maddr", 19},
+    {"mcs", 21},
+    {"mjump", 20},
+    {"mls", 22},
+    {"ncv", 15},
+    {"nlab", 8},
+    {"npins", 23},
+    {"orc", 24},
+    {"orhi", 26},
+    {"orl", 25},
+    {"orvi", 27},
+    {"pairs", 14},
+    {"pb", 5},
+    {"spinh", 18},
+    {"spinv", 17},
+    {"vt", 6},
+    {"widcs", 29},
+    {"wnum", 12},
+    {"wsl", 7},
+    {"xmc", 4},
+};
+
+// Terminfo names sorted for binary search
+constexpr CapabilityName string_names[] = {
+    {"OTG1", 402},
+    {"OTG2", 400},
+    {"OTG3", 401},
+    {"OTG4", 403},
+    {"OTGC", 410},
+    {"OTGD", 407},
+    {"OTGH", 408},
+    {"OTGL", 405},
+    {"OTGR", 404},
+    {"OTGU", 406},
+    {"OTGV", 409},
+    {"OTbc", 397},
+    {"OTi2", 394},
+    {"OTko", 398},
+    {"OTma", 399},
+    {"OTnl", 396},
+    {"OTrs", 395},
+    {"acsc", 146},
+    {"bel", 1},
+    {"bicr", 372},
+    {"binel", 371},
+    {"birep", 370},
+    {"blink", 26},
+    {"bold", 27},
+    {"box1", 413},
+    {"cbt", 0},
+    {"chr", 306},
+    {"civis", 13},
+    {"clear", 5},
+    {"cmdch", 9},
+    {"cnorm", 16},
+    {"colornm", 373},
+    {"cpi", 304},
+    {"cr", 2},
+    {"csin", 363},
+    {"csnm", 354},
+    {"csr", 3},
+    {"cub", 111},
+    {"cub1", 14},
+    {"cud", 107},
+    {"cud1", 11},
+    {"cuf", 112},
+    {"cuf1", 17},
+    {"cup", 10},
+    {"cuu", 114},
+    {"cuu1", 19},
+    {"cvr", 307},
+    {"cvvis", 20},
+    {"cwin", 277},
+    {"dch", 105},
+    {"dch1", 21},
+    {"dclk", 275},
+    {"defbi", 374},
+    {"defc", 308},
+    {"devt", 362},
+    {"dial", 280},
+    {"dim", 30},
+    {"dispc", 378},
+    {"dl", 106},
+    {"dl1", 22},
+    {"docr", 352},
+    {"dsl", 23},
+    {"ech", 37},
+    {"ed", 7},
+    {"ehhlm", 386},
+    {"el", 6},
+    {"el1", 269},
+    {"elhlm", 387},
+    {"elohlm", 388},
+    {"enacs", 155},
+    {"endbi", 375},
+    {"erhlm", 389},
+    {"ethlm", 390},
+    {"evhlm", 391},
+    {"ff", 46},
+    {"flash", 45},
+    {"fln", 273},
+    {"fsl", 47},
+    {"getm", 358},
+    {"hd", 24},
+    {"home", 12},
+    {"hook", 284},
+    {"hpa", 8},
+    {"ht", 134},
+    {"hts", 132},
+    {"hu", 137},
+    {"hup", 279},
+    {"ich", 108},
+    {"ich1", 52},
+    {"if", 51},
+    {"il", 110},
+    {"il1", 53},
+    {"ind", 129},
+    {"indn", 109},
+    {"initc", 299},
+    {"initp", 300},
+    {"invis", 32},
+    {"ip", 54},
+    {"iprog", 138},
+    {"is1", 48},
+    {"is2", 49},
+    {"is3", 50},
+    {"kBEG", 186},
+    {"kCAN", 187},
+    {"kCMD", 188},
+    {"kCPY", 189},
+    {"kCRT", 190},
+    {"kDC", 191},
+    {"kDL", 192},
+    {"kEND", 194},
+    {"kEOL", 195},
+    {"kEXT", 196},
+    {"kFND", 197},
+    {"kHLP", 198},
+    {"kHOM", 199},
+    {"kIC", 200},
+    {"kLFT", 201},
+    {"kMOV", 203},
+    {"kMSG", 202},
+    {"kNXT", 204},
+    {"kOPT", 205},
+    {"kPRT", 207},
+    {"kPRV", 206},
+    {"kRDO", 208},
+    {"kRES", 211},
+    {"kRIT", 210},
+    {"kRPL", 209},
+    {"kSAV", 212},
+    {"kSPD", 213},
+    {"kUND", 214},
+    {"ka1", 139},
+    {"ka3", 140},
+    {"kb2", 141},
+    {"kbeg", 158},
+    {"kbs", 55},
+    {"kc1", 142},
+    {"kc3", 143},
+    {"kcan", 159},
+    {"kcbt", 148},
+    {"kclo", 160},
+    {"kclr", 57},
+    {"kcmd", 161},
+    {"kcpy", 162},
+    {"kcrt", 163},
+    {"kctab", 58},
+    {"kcub1", 79},
+    {"kcud1", 61},
+    {"kcuf1", 83},
+    {"kcuu1", 87},
+    {"kdch1", 59},
+    {"kdl1", 60},
+    {"ked", 64},
+    {"kel", 63},
+    {"kend", 164},
+    {"kent", 165},
+    {"kext", 166},
+    {"kf0", 65},
+    {"kf1", 66},
+    {"kf10", 67},
+    {"kf11", 216},
+    {"kf12", 217},
+    {"kf13", 218},
+    {"kf14", 219},
+    {"kf15", 220},
+    {"kf16", 221},
+    {"kf17", 222},
+    {"kf18", 223},
+    {"kf19", 224},
+    {"kf2", 68},
+    {"kf20", 225},
+    {"kf21", 226},
+    {"kf22", 227},
+    {"kf23", 228},
+    {"kf24", 229},
+    {"kf25", 230},
+    {"kf26", 231},
+    {"kf27", 232},
+    {"kf28", 233},
+    {"kf29", 234},
+    {"kf3", 69},
+    {"kf30", 235},
+    {"kf31", 236},
+    {"kf32", 237},
+    {"kf33", 238},
+    {"kf34", 239},
+    {"kf35", 240},
+    {"kf36", 241},
+    {"kf37", 242},
+    {"kf38", 243},
+    {"kf39", 244},
+    {"kf4", 70},
+    {"kf40", 245},
+    {"kf41", 246},
+    {"kf42", 247},
+    {"kf43", 248},
+    {"kf44", 249},
+    {"kf45", 250},
+    {"kf46", 251},
+    {"kf47", 252},
+    {"kf48", 253},
+    {"kf49", 254},
+    {"kf5", 71},
+    {"kf50", 255},
+    {"kf51", 256},
+    {"kf52", 257},
+    {"kf53", 258},
+    {"kf54", 259},
+    {"kf55", 260},
+    {"kf56", 261},
+    {"kf57", 262},
+    {"kf58", 263},
+    {"kf59", 264},
+    {"kf6", 72},
+    {"kf60", 265},
+    {"kf61", 266},
+    {"kf62", 267},
+    {"kf63", 268},
+    {"kf7", 73},
+    {"kf8", 74},
+    {"kf9", 75},
+    {"kfnd", 167},
+    {"khlp", 168},
+    {"khome", 76},
+    {"khts", 86},
+    {"kich1", 77},
+    {"kil1", 78},
+    {"kind", 84},
+    {"kll", 80},
+    {"kmous", 355},
+    {"kmov", 171},
+    {"kmrk", 169},
+    {"kmsg", 170},
+    {"knp", 81},
+    {"knxt", 172},
+    {"kopn", 173},
+    {"kopt", 174},
+    {"kpp", 82},
+    {"kprt", 176},
+    {"kprv", 175},
+    {"krdo", 177},
+    {"kref", 178},
+    {"kres", 182},
+    {"krfr", 179},
+    {"kri", 85},
+    {"krmir", 62},
+    {"krpl", 180},
+    {"krst", 181},
+    {"ksav", 183},
+    {"kslt", 193},
+    {"kspd", 184},
+    {"ktbc", 56},
+    {"kund", 185},
+    {"lf0", 90},
+    {"lf1", 91},
+    {"lf10", 92},
+    {"lf2", 93},
+    {"lf3", 94},
+    {"lf4", 95},
+    {"lf5", 96},
+    {"lf6", 97},
+    {"lf7", 98},
+    {"lf8", 99},
+    {"lf9", 100},
+    {"ll", 18},
+    {"lpi", 305},
+    {"mc0", 118},
+    {"mc4", 119},
+    {"mc5", 120},
+    {"mc5p", 144},
+    {"mcub", 336},
+    {"mcub1", 330},
+    {"mcud", 335},
+    {"mcud1", 329},
+    {"mcuf", 337},
+    {"mcuf1", 331},
+    {"mcuu", 338},
+    {"mcuu1", 333},
+    {"meml", 411},
+    {"memu", 412},
+    {"mgc", 270},
+    {"mhpa", 328},
+    {"minfo", 356},
+    {"mrcup", 15},
+    {"mvpa", 332},
+    {"nel", 103},
+    {"oc", 298},
+    {"op", 297},
+    {"pad", 104},
+    {"pause", 285},
+    {"pctrm", 383},
+    {"pfkey", 115},
+    {"pfloc", 116},
+    {"pfx", 117},
+    {"pfxl", 361},
+    {"pln", 147},
+    {"porder", 334},
+    {"prot", 33},
+    {"pulse", 283},
+    {"qdial", 281},
+    {"rbim", 348},
+    {"rc", 126},
+    {"rcsd", 349},
+    {"rep", 121},
+    {"reqmp", 357},
+    {"rev", 34},
+    {"rf", 125},
+    {"rfi", 215},
+    {"ri", 130},
+    {"rin", 113},
+    {"ritm", 321},
+    {"rlm", 322},
+    {"rmacs", 38},
+    {"rmam", 152},
+    {"rmclk", 276},
+    {"rmcup", 40},
+    {"rmdc", 41},
+    {"rmicm", 323},
+    {"rmir", 42},
+    {"rmkx", 88},
+    {"rmln", 157},
+    {"rmm", 101},
+    {"rmp", 145},
+    {"rmpch", 380},
+    {"rmsc", 382},
+    {"rmso", 43},
+    {"rmul", 44},
+    {"rmxon", 150},
+    {"rs1", 122},
+    {"rs2", 123},
+    {"rs3", 124},
+    {"rshm", 324},
+    {"rsubm", 325},
+    {"rsupm", 326},
+    {"rum", 327},
+    {"rwidm", 320},
+    {"s0ds", 364},
+    {"s1ds", 365},
+    {"s2ds", 366},
+    {"s3ds", 367},
+    {"sbim", 346},
+    {"sc", 128},
+    {"scesa", 385},
+    {"scesc", 384},
+    {"sclk", 274},
+    {"scp", 301},
+    {"scs", 339},
+    {"scsd", 347},
+    {"sdrfq", 310},
+    {"setab", 360},
+    {"setaf", 359},
+    {"setb", 303},
+    {"setcolor", 376},
+    {"setf", 302},
+    {"sgr", 131},
+    {"sgr0", 39},
+    {"sgr1", 392},
+    {"sitm", 311},
+    {"slength", 393},
+    {"slines", 377},
+    {"slm", 312},
+    {"smacs", 25},
+    {"smam", 151},
+    {"smcup", 28},
+    {"smdc", 29},
+    {"smgb", 340},
+    {"smgbp", 341},
+    {"smgl", 271},
+    {"smglp", 342},
+    {"smglr", 368},
+    {"smgr", 272},
+    {"smgrp", 343},
+    {"smgt", 344},
+    {"smgtb", 369},
+    {"smgtp", 345},
+    {"smicm", 313},
+    {"smir", 31},
+    {"smkx", 89},
+    {"smln", 156},
+    {"smm", 102},
+    {"smpch", 379},
+    {"smsc", 381},
+    {"smso", 35},
+    {"smul", 36},
+    {"smxon", 149},
+    {"snlq", 314},
+    {"snrmq", 315},
+    {"sshm", 316},
+    {"ssubm", 317},
+    {"ssupm", 318},
+    {"subcs", 350},
+    {"sum", 319},
+    {"supcs", 351},
+    {"swidm", 309},
+    {"tbc", 4},
+    {"tone", 282},
+    {"tsl", 135},
+    {"u0", 287},
+    {"u1", 288},
+    {"u2", 289},
+    {"u3", 290},
+    {"u4", 291},
+    {"u5", 292},
+    {"u6", 293},
+    {"u7", 294},
+    {"u8", 295},
+    {"u9", 296},
+    {"uc", 136},
+    {"vpa", 127},
+    {"wait", 286},
+    {"wind", 133},
+    {"wingo", 278},
+    {"xoffc", 154},
+    {"xonc", 153},
+    {"zerom", 353},
+};
+
+// Termcap names sorted for binary search
+constexpr CapabilityName boolean_codes[] = {
+    {"5i", 22},
+    {"HC", 23},
+    {"MT", 40},
+    {"ND", 26},
+    {"NL", 41},
+    {"NP", 25},
+    {"NR", 24},
+    {"YA", 30},
+    {"YB", 31},
+    {"YC", 32},
+    {"YD", 33},
+    {"YE", 34},
+    {"YF", 35},
+    {"YG", 36},
+    {"am", 1},
+    {"bs", 37},
+    {"bw", 0},
+    {"cc", 27},
+    {"da", 11},
+    {"db", 12},
+    {"eo", 5},
+    {"es", 16},
+    {"gn", 6},
+    {"hc", 7},
+    {"hl", 29},
+    {"hs", 9},
+    {"hz", 18},
+    {"in", 10},
+    {"km", 8},
+    {"mi", 13},
+    {"ms", 14},
+    {"nc", 39},
+    {"ns", 38},
+    {"nx", 21},
+    {"os", 15},
+    {"pt", 42},
+    {"ul", 19},
+    {"ut", 28},
+    {"xb", 2},
+    {"xn", 4},
+    {"xo", 20},
+    {"xr", 43},
+    {"xs", 3},
+    {"xt", 17},
+};
+
+// Termcap names sorted for binary search
+constexpr CapabilityName number_codes[] = {
+    {"BT", 30},
+    {"Co", 13},
+    {"MW", 12},
+    {"NC", 15},
+    {"Nl", 8},
+    {"Ya", 16},
+    {"Yb", 17},
+    {"Yc", 18},
+    {"Yd", 19},
+    {"Ye", 20},
+    {"Yf", 21},
+    {"Yg", 22},
+    {"Yh", 23},
+    {"Yi", 24},
+    {"Yj", 25},
+    {"Yk", 26},
+    {"Yl", 27},
+    {"Ym", 28},
+    {"Yn", 29},
+    {"Yo", 31},
+    {"Yp", 32},
+    {"co", 0},
+    {"dB", 36},
+    {"dC", 34},
+    {"dN", 35},
+    {"dT", 37},
+    {"it", 1},
+    {"kn", 38},
+    {"lh", 9},
+    {"li", 2},
+    {"lm", 3},
+    {"lw", 10},
+    {"ma", 11},
+    {"pa", 14},
+    {"pb", 5},
+    {"sg", 4},
+    {"ug", 33},
+    {"vt", 6},
+    {"ws", 7},
+};
+
+// Termcap names sorted for binary search
+constexpr CapabilityName string_codes[] = {
+    {"!1", 212},
+    {"!2", 213},
+    {"!3", 214},
+    {"#1", 198},
+    {"#2", 199},
+    {"#3", 200},
+    {"#4", 201},
+    {"%0", 177},
+    {"%1", 168},
+    {"%2", 169},
+    {"%3", 170},
+    {"%4", 171},
+    {"%5", 172},
+    {"%6", 173},
+    {"%7", 174},
+    {"%8", 175},
+    {"%9", 176},
+    {"%a", 202},
+    {"%b", 203},
+    {"%c", 204},
+    {"%d", 205},
+    {"%e", 206},
+    {"%f", 207},
+    {"%g", 208},
+    {"%h", 209},
+    {"%i", 210},
+    {"%j", 211},
+    {"&0", 187},
+    {"&1", 178},
+    {"&2", 179},
+    {"&3", 180},
+    {"&4", 181},
+    {"&5", 182},
+    {"&6", 183},
+    {"&7", 184},
+    {"&8", 185},
+    {"&9", 186},
+    {"*0", 197},
+    {"*1", 188},
+    {"*2", 189},
+    {"*3", 190},
+    {"*4", 191},
+    {"*5", 192},
+    {"*6", 193},
+    {"*7", 194},
+    {"*8", 195},
+    {"*9", 196},
+    {"@0", 167},
+    {"@1", 158},
+    {"@2", 159},
+    {"@3", 160},
+    {"@4", 161},
+    {"@5", 162},
+    {"@6", 163},
+    {"@7", 164},
+    {"@8", 165},
+    {"@9", 166},
+    {"AB", 360},
+    {"AF", 359},
+    {"AL", 110},
+    {"CC", 9},
+    {"CM", 15},
+    {"CW", 277},
+    {"DC", 105},
+    {"DI", 280},
+    {"DK", 275},
+    {"DL", 106},
+    {"DO", 107},
+    {"F1", 216},
+    {"F2", 217},
+    {"F3", 218},
+    {"F4", 219},
+    {"F5", 220},
+    {"F6", 221},
+    {"F7", 222},
+    {"F8", 223},
+    {"F9", 224},
+    {"FA", 225},
+    {"FB", 226},
+    {"FC", 227},
+    {"FD", 228},
+    {"FE", 229},
+    {"FF", 230},
+    {"FG", 231},
+    {"FH", 232},
+    {"FI", 233},
+    {"FJ", 234},
+    {"FK", 235},
+    {"FL", 236},
+    {"FM", 237},
+    {"FN", 238},
+    {"FO", 239},
+    {"FP", 240},
+    {"FQ", 241},
+    {"FR", 242},
+    {"FS", 243},
+    {"FT", 244},
+    {"FU", 245},
+    {"FV", 246},
+    {"FW", 247},
+    {"FX", 248},
+    {"FY", 249},
+    {"FZ", 250},
+    {"Fa", 251},
+    {"Fb", 252},
+    {"Fc", 253},
+    {"Fd", 254},
+    {"Fe", 255},
+    {"Ff", 256},
+    {"Fg", 257},
+    {"Fh", 258},
+    {"Fi", 259},
+    {"Fj", 260},
+    {"Fk", 261},
+    {"Fl", 262},
+    {"Fm", 263},
+    {"Fn", 264},
+    {"Fo", 265},
+    {"Fp", 266},
+    {"Fq", 267},
+    {"Fr", 268},
+    {"G1", 402},
+    {"G2", 400},
+    {"G3", 401},
+    {"G4", 403},
+    {"GC", 410},
+    {"GD", 407},
+    {"GH", 408},
+    {"GL", 405},
+    {"GR", 404},
+    {"GU", 406},
+    {"GV", 409},
+    {"Gm", 358},
+    {"HU", 279},
+    {"IC", 108},
+    {"Ic", 299},
+    {"Ip", 300},
+    {"K1", 139},
+    {"K2", 141},
+    {"K3", 140},
+    {"K4", 142},
+    {"K5", 143},
+    {"Km", 355},
+    {"LE", 111},
+    {"LF", 157},
+    {"LO", 156},
+    {"Lf", 273},
+    {"MC", 270},
+    {"ML", 271},
+    {"MR", 272},
+    {"MT", 369},
+    {"Mi", 356},
+    {"PA", 285},
+    {"PU", 283},
+    {"QD", 281},
+    {"RA", 152},
+    {"RC", 276},
+    {"RF", 215},
+    {"RI", 112},
+    {"RQ", 357},
+    {"RX", 150},
+    {"S1", 378},
+    {"S2", 379},
+    {"S3", 380},
+    {"S4", 381},
+    {"S5", 382},
+    {"S6", 383},
+    {"S7", 384},
+    {"S8", 385},
+    {"SA", 151},
+    {"SC", 274},
+    {"SF", 109},
+    {"SR", 113},
+    {"SX", 149},
+    {"Sb", 303},
+    {"Sf", 302},
+    {"TO", 282},
+    {"UP", 114},
+    {"WA", 286},
+    {"WG", 278},
+    {"XF", 154},
+    {"XN", 153},
+    {"Xh", 386},
+    {"Xl", 387},
+    {"Xo", 388},
+    {"Xr", 389},
+    {"Xt", 390},
+    {"Xv", 391},
+    {"Xy", 370},
+    {"YI", 393},
+    {"YZ", 377},
+    {"Yv", 372},
+    {"Yw", 373},
+    {"Yx", 374},
+    {"Yy", 375},
+    {"Yz", 376},
+    {"ZA", 304},
+    {"ZB", 305},
+    {"ZC", 306},
+    {"ZD", 307},
+    {"ZE", 308},
+    {"ZF", 309},
+    {"ZG", 310},
+    {"ZH", 311},
+    {"ZI", 312},
+    {"ZJ", 313},
+    {"ZK", 314},
+    {"ZL", 315},
+    {"ZM", 316},
+    {"ZN", 317},
+    {"ZO", 318},
+    {"ZP", 319},
+    {"ZQ", 320},
+    {"ZR", 321},
+    {"ZS", 322},
+    {"ZT", 323},
+    {"ZU", 324},
+    {"ZV", 325},
+    {"ZW", 326},
+    {"ZX", 327},
+    {"ZY", 328},
+    {"ZZ", 329},
+    {"Za", 330},
+    {"Zb", 331},
+    {"Zc", 332},
+    {"Zd", 333},
+    {"Ze", 334},
+    {"Zf", 335},
+    {"Zg", 336},
+    {"Zh", 337},
+    {"Zi", 338},
+    {"Zj", 339},
+    {"Zk", 340},
+    {"Zl", 341},
+    {"Zm", 342},
+    {"Zn", 343},
+    {"Zo", 344},
+    {"Zp", 345},
+    {"Zq", 346},
+    {"Zr", 347},
+    {"Zs", 348},
+    {"Zt", 349},
+    {"Zu", 350},
+    {"Zv", 351},
+    {"Zw", 352},
+    {"Zx", 353},
+    {"Zy", 354},
+    {"Zz", 371},
+    {"ac", 146},
+    {"ae", 38},
+    {"al", 53},
+    {"as", 25},
+    {"bc", 397},
+    {"bl", 1},
+    {"bt", 0},
+    {"bx", 413},
+    {"cb", 269},
+    {"cd", 7},
+    {"ce", 6},
+    {"ch", 8},
+    {"ci", 363},
+    {"cl", 5},
+    {"cm", 10},
+    {"cr", 2},
+    {"cs", 3},
+    {"ct", 4},
+    {"cv", 127},
+    {"dc", 21},
+    {"dl", 22},
+    {"dm", 29},
+    {"do", 11},
+    {"ds", 23},
+    {"dv", 362},
+    {"eA", 155},
+    {"ec", 37},
+    {"ed", 41},
+    {"ei", 42},
+    {"ff", 46},
+    {"fh", 284},
+    {"fs", 47},
+    {"hd", 24},
+    {"ho", 12},
+    {"hu", 137},
+    {"i1", 48},
+    {"i2", 394},
+    {"i3", 50},
+    {"iP", 138},
+    {"ic", 52},
+    {"if", 51},
+    {"im", 31},
+    {"ip", 54},
+    {"is", 49},
+    {"k0", 65},
+    {"k1", 66},
+    {"k2", 68},
+    {"k3", 69},
+    {"k4", 70},
+    {"k5", 71},
+    {"k6", 72},
+    {"k7", 73},
+    {"k8", 74},
+    {"k9", 75},
+    {"k;", 67},
+    {"kA", 78},
+    {"kB", 148},
+    {"kC", 57},
+    {"kD", 59},
+    {"kE", 63},
+    {"kF", 84},
+    {"kH", 80},
+    {"kI", 77},
+    {"kL", 60},
+    {"kM", 62},
+    {"kN", 81},
+    {"kP", 82},
+    {"kR", 85},
+    {"kS", 64},
+    {"kT", 86},
+    {"ka", 56},
+    {"kb", 55},
+    {"kd", 61},
+    {"ke", 88},
+    {"kh", 76},
+    {"kl", 79},
+    {"ko", 398},
+    {"kr", 83},
+    {"ks", 89},
+    {"kt", 58},
+    {"ku", 87},
+    {"l0", 90},
+    {"l1", 91},
+    {"l2", 93},
+    {"l3", 94},
+    {"l4", 95},
+    {"l5", 96},
+    {"l6", 97},
+    {"l7", 98},
+    {"l8", 99},
+    {"l9", 100},
+    {"la", 92},
+    {"le", 14},
+    {"ll", 18},
+    {"ma", 399},
+    {"mb", 26},
+    {"md", 27},
+    {"me", 39},
+    {"mh", 30},
+    {"mk", 32},
+    {"ml", 411},
+    {"mm", 102},
+    {"mo", 101},
+    {"mp", 33},
+    {"mr", 34},
+    {"mu", 412},
+    {"nd", 17},
+    {"nl", 396},
+    {"nw", 103},
+    {"oc", 298},
+    {"op", 297},
+    {"pO", 144},
+    {"pc", 104},
+    {"pf", 119},
+    {"pk", 115},
+    {"pl", 116},
+    {"pn", 147},
+    {"po", 120},
+    {"ps", 118},
+    {"px", 117},
+    {"r1", 122},
+    {"r2", 123},
+    {"r3", 124},
+    {"rP", 145},
+    {"rc", 126},
+    {"rf", 125},
+    {"rp", 121},
+    {"rs", 395},
+    {"s0", 364},
+    {"s1", 365},
+    {"s2", 366},
+    {"s3", 367},
+    {"sA", 392},
+    {"sa", 131},
+    {"sc", 128},
+    {"se", 43},
+    {"sf", 129},
+    {"so", 35},
+    {"sp", 301},
+    {"sr", 130},
+    {"st", 132},
+    {"ta", 134},
+    {"te", 40},
+    {"ti", 28},
+    {"ts", 135},
+    {"u0", 287},
+    {"u1", 288},
+    {"u2", 289},
+    {"u3", 290},
+    {"u4", 291},
+    {"u5", 292},
+    {"u6", 293},
+    {"u7", 294},
+    {"u8", 295},
+    {"u9", 296},
+    {"uc", 136},
+    {"ue", 44},
+    {"up", 19},
+    {"us", 36},
+    {"vb", 45},
+    {"ve", 16},
+    {"vi", 13},
+    {"vs", 20},
+    {"wi", 133},
+    {"xl", 361},
+};
+
+} // namespace msos::curses
@@ -0,0 +1,154 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "width_table.hpp"
+
+namespace msos::curses
+{
+
+constexpr char32_t replacement_character = 0xfffd;
+
+// Text plane of window cell: 0 for narrow cells described by chtype alone,
+// otherwise codepoint with optional combining diacritical mark (U+0300..U+036F)
+// packed above it. Right half of double width character holds continuation.
+constexpr std::uint32_t cell_continuation = 0x110000;
+constexpr std::uint32_t cell_codepoint_mask = 0x1fffff;
+constexpr std::uint32_t cell_combining_offset = 24;
+constexpr char32_t combining_first = 0x0300;
+constexpr char32_t combining_last = 0x036f;
+
+// Column width of codepoint: 0 for combining marks, 2 for East Asian wide
+// and full width characters, -1 for control characters
+constexpr int character_width(char32_t c)
+{
+    if (c < 0x20 || (c >= 0x7f && c < 0xa0))
+    {
+        return c == 0 ? 0 : -1;
+    }
+    if (c < 0x300)
+    {
+        return 1;
+    }
+
+    std::size_t low = 0;
+    std::size_t high = sizeof(width_table) / sizeof(width_table[0]);
+    while (low < high)
+    {
+        const std::size_t middle = (low + high) / 2;
+        const char32_t first = width_table[middle][0] & cell_codepoint_mask;
+        if (c < first)
+        {
+            high = middle;
+        }
+        else if (c > width_table[middle][1])
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            return static_cast<int>(width_table[middle][0] >> 21);
+        }
+    }
+    return 1;
+}
+
+static_assert(character_width('a') == 1);
+static_assert(character_width(0x0301) == 0);
+static_assert(character_width(0x4e2d) == 2);
+
+// Returns number of bytes written to out (at most 4)
+constexpr std::size_t utf8_encode(char32_t c, char* out)
+{
+    if (c < 0x80)
+    {
+        out[0] = static_cast<char>(c);
+        return 1;
+    }
+    if (c < 0x800)
+    {
+        out[0] = static_cast<char>(0xc0 | (c >> 6));
+        out[1] = static_cast<char>(0x80 | (c & 0x3f));
+        return 2;
+    }
+    if (c < 0x10000)
+    {
+        out[0] = static_cast<char>(0xe0 | (c >> 12));
+        out[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        out[2] = static_cast<char>(0x80 | (c & 0x3f));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xf0 | (c >> 18));
+    out[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+    out[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+    out[3] = static_cast<char>(0x80 | (c & 0x3f));
+    return 4;
+}
+
+// Length of sequence started by lead byte, 0 for invalid lead
+constexpr std::size_t utf8_length(unsigned char lead)
+{
+    if (lead < 0x80)
+    {
+        return 1;
+    }
+    if (lead >= 0xc2 && lead <= 0xdf)
+    {
+        return 2;
+    }
+    if (lead >= 0xe0 && lead <= 0xef)
+    {
+        return 3;
+    }
+    if (lead >= 0xf0 && lead <= 0xf4)
+    {
+        return 4;
+    }
+    return 0;
+}
+
+// Decodes complete sequence of utf8_length(data[0]) bytes,
+// returns replacement character for malformed input
+constexpr char32_t utf8_decode(const unsigned char* data, std::size_t length)
+{
+    if (length == 1)
+    {
+        return data[0];
+    }
+
+    char32_t c = data[0] & (0x7f >> length);
+    for (std::size_t i = 1; i < length; ++i)
+    {
+        if ((data[i] & 0xc0) != 0x80)
+        {
+            return replacement_character;
+        }
+        c = (c << 6) | (data[i] & 0x3f);
+    }
+
+    constexpr char32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (c < minimum[length] || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+    {
+        return replacement_character;
+    }
+    return c;
+}
+
+} // namespace msos::curses
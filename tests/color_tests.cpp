@@ -16,6 +16,11 @@
 
 #include <mstest/mstest.hpp>
 
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
 #include "curses.h"
 
 #include "msos/libc/printf.hpp"
@@ -23,13 +28,54 @@
 class ColorsShould : public mstest::Test
 {
 public:
+    // Draws character with given colors on terminal described by environment
+    std::string draw(const char* term, const char* colorterm, short fg, short bg)
+    {
+        setenv("TERM", term, 1);
+        setupterm(term, STDOUT_FILENO, nullptr);
+        if (colorterm != nullptr)
+        {
+            setenv("COLORTERM", colorterm, 1);
+        }
+        else
+        {
+            unsetenv("COLORTERM");
+        }
+        start_color();
+        init_pair(1, fg, bg);
+        clear();
+        printf_history().clear();
+        attrset(COLOR_PAIR(1));
+        mvaddch(0, 0, 'x');
+        refresh();
+        attrset(A_NORMAL);
+
+        std::string data;
+        for (const auto& call : printf_history())
+        {
+            data += call.str();
+        }
+        return data;
+    }
+
+    void setup() override
+    {
+        const char* term = std::getenv("TERM");
+        term_ = term != nullptr ? term : "";
+    }
+
     void teardown() override
     {
+        setenv("TERM", term_.c_str(), 1);
+        unsetenv("COLORTERM");
         printf_history().clear();
         clear_flush_counter();
         clear_tcgetattr();
         clear_tcsetattr();
     }
+
+private:
+    std::string term_;
 };
 
 MSTEST_F(ColorsShould, InitColorPairs)
@@ -63,3 +109,107 @@ MSTEST_F(ColorsShould, FailWhenGetPairOutOfRange)
     mstest::expect_eq(ERR, pair_content(COLOR_PAIRS, &foreground, &background));
 }
 
+
+MSTEST_F(ColorsShould, StoreColorContent)
+{
+    initscr();
+    short r, g, b;
+    mstest::expect_eq(OK, color_content(COLOR_RED, &r, &g, &b));
+    mstest::expect_eq(r, 804);
+    mstest::expect_eq(g, 0);
+    mstest::expect_eq(b, 0);
+
+    mstest::expect_eq(OK, init_color(COLOR_RED, 1000, 500, 0));
+    mstest::expect_eq(OK, color_content(COLOR_RED, &r, &g, &b));
+    mstest::expect_eq(r, 1000);
+    mstest::expect_eq(g, 500);
+    mstest::expect_eq(b, 0);
+
+    mstest::expect_eq(ERR, init_color(COLOR_RED, 1001, 0, 0));
+    mstest::expect_eq(ERR, init_color(COLORS + 1, 0, 0, 0));
+    mstest::expect_eq(ERR, color_content(0, &r, &g, &b));
+    endwin();
+}
+
+MSTEST_F(ColorsShould, UseIndexedColorsOn256ColorTerminal)
+{
+    initscr();
+    mstest::expect_eq(draw("xterm-256color", nullptr, 197, COLOR_BLUE), "\033(B\033[0;38;5;196;44mx");
+    mstest::expect_false(can_change_color());
+    endwin();
+}
+
+MSTEST_F(ColorsShould, UseDirectColorsForChangedColors)
+{
+    initscr();
+    init_color(20, 1000, 500, 0);
+    mstest::expect_eq(draw("xterm-256color", "truecolor", 20, COLOR_BLACK), "\033(B\033[0;38;2;255;128;0;40mx");
+    mstest::expect_true(can_change_color());
+    endwin();
+}
+
+MSTEST_F(ColorsShould, ApproximateColorsOnBasicTerminal)
+{
+    initscr();
+    init_color(20, 1000, 100, 0);
+    init_color(21, 0, 100, 900);
+    mstest::expect_eq(draw("xterm", nullptr, 20, 21), "\033(B\033[0;31;44mx");
+    mstest::expect_eq(draw("xterm-16color", nullptr, 20, 197), "\033(B\033[0;91;101mx");
+    endwin();
+}
+
+MSTEST_F(ColorsShould, AcceptDefaultColorOnlyAfterUseDefaultColors)
+{
+    initscr();
+    mstest::expect_eq(ERR, init_pair(1, -1, COLOR_RED));
+    mstest::expect_eq(OK, use_default_colors());
+    mstest::expect_eq(OK, init_pair(1, -1, COLOR_RED));
+    mstest::expect_eq(ERR, init_pair(1, -2, COLOR_RED));
+    endwin();
+}
+
+MSTEST_F(ColorsShould, PaintPairZeroWithAssumedDefaultColors)
+{
+    initscr();
+    mstest::expect_eq(OK, assume_default_colors(COLOR_WHITE, COLOR_BLUE));
+    printf_history().clear();
+    clear();
+    mstest::expect_eq(printf_history().front().str(), "\033[0;37;44m");
+    use_default_colors();
+    endwin();
+}
+
+MSTEST_F(ColorsShould, EraseColoredBackgroundOnBceTerminal)
+{
+    initscr();
+    setenv("TERM", "xterm", 1);
+    setupterm(nullptr, STDOUT_FILENO, nullptr);
+    start_color();
+    init_pair(1, COLOR_WHITE, COLOR_BLUE);
+    clear();
+    printf_history().clear();
+    bkgd(static_cast<chtype>(COLOR_PAIR(1) << A_ATTRIBUTES_OFFSET));
+    refresh();
+    bkgd(0);
+    std::string data;
+    for (const auto& call : printf_history())
+    {
+        data += call.str();
+    }
+    mstest::expect_eq(data, "\033(B\033[0;37;44m\033[J");
+    endwin();
+}
+
+MSTEST_F(ColorsShould, PaintColoredBackgroundWithoutBce)
+{
+    initscr();
+    mstest::expect_eq(draw("msos-tests", nullptr, COLOR_WHITE, COLOR_BLUE), "\033(B\033[0;37;44mx");
+    printf_history().clear();
+    attrset(COLOR_PAIR(1));
+    mvaddstr(0, 1, "     ");
+    refresh();
+    attrset(A_NORMAL);
+    mstest::expect_eq(printf_history().size(), 1u);
+    mstest::expect_eq(printf_history().front().str(), "     ");
+    endwin();
+}
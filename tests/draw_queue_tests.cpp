@@ -0,0 +1,212 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+
+#include <mstest/mstest.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "msos/libc/printf.hpp"
+
+#include "curses.h"
+#include "draw_queue.hpp"
+
+namespace
+{
+
+std::string row_text(int y, int x, int size)
+{
+    std::string text;
+    for (int i = 0; i < size; ++i)
+    {
+        text += static_cast<char>(stdscr->screen_buffer[y * stdscr->max_x + x + i] & A_CHARTEXT);
+    }
+    return text;
+}
+
+} // namespace
+
+class DrawQueueShould : public mstest::Test
+{
+public:
+    void setup() override
+    {
+        initscr();
+        screen_ = set_term(nullptr);
+        clear();
+        refresh();
+    }
+
+    void teardown() override
+    {
+        printf_history().clear();
+        clear_flush_counter();
+        clear_tcgetattr();
+        clear_tcsetattr();
+        endwin();
+    }
+
+protected:
+    SCREEN* screen_ = nullptr;
+};
+
+MSTEST_F(DrawQueueShould, ApplyQueuedTextOnUpdate)
+{
+    mstest::expect_eq(queue_mvaddnstr(screen_, 2, 5, 0, "queued", -1), OK);
+    mstest::expect_false(row_text(2, 5, 6) == "queued");
+
+    refresh();
+    mstest::expect_eq(row_text(2, 5, 6), "queued");
+    mstest::expect_eq(stdscr->cursor_y, 2);
+    mstest::expect_eq(stdscr->cursor_x, 11);
+}
+
+MSTEST_F(DrawQueueShould, KeepWindowAttributes)
+{
+    attrset(COLOR_PAIR(2));
+    queue_mvaddnstr(screen_, 0, 0, COLOR_PAIR(1), "a", -1);
+    refresh();
+
+    mstest::expect_eq(stdscr->screen_buffer[0], static_cast<chtype>((COLOR_PAIR(1) << A_ATTRIBUTES_OFFSET) | 'a'));
+    mstest::expect_eq(stdscr->attributes, static_cast<char>(COLOR_PAIR(2)));
+    attrset(A_NORMAL);
+}
+
+MSTEST_F(DrawQueueShould, ApplyCommandsInOrder)
+{
+    queue_mvaddnstr(screen_, 1, 0, 0, "first", -1);
+    queue_mvaddnstr(screen_, 1, 0, 0, "sec", 3);
+    queue_move(screen_, 4, 7);
+    refresh();
+
+    mstest::expect_eq(row_text(1, 0, 5), "secst");
+    mstest::expect_eq(stdscr->cursor_y, 4);
+    mstest::expect_eq(stdscr->cursor_x, 7);
+}
+
+MSTEST_F(DrawQueueShould, RejectCommandsWhenFull)
+{
+    int queued = 0;
+    while (queued < 1024 && queue_move(screen_, 0, 0) == OK)
+    {
+        ++queued;
+    }
+    mstest::expect_true(queued > 0 && queued < 1024);
+    mstest::expect_eq(queue_move(screen_, 0, 0), ERR);
+    mstest::expect_eq(queue_mvaddnstr(nullptr, 0, 0, 0, "a", -1), ERR);
+
+    refresh();
+    mstest::expect_eq(queue_move(screen_, 0, 0), OK);
+}
+
+MSTEST_F(DrawQueueShould, RejectPositionsOutsideOfScreen)
+{
+    const int lines = getmaxy(stdscr);
+    const int columns = getmaxx(stdscr);
+    mstest::expect_eq(queue_move(screen_, -1, 0), ERR);
+    mstest::expect_eq(queue_move(screen_, 0, -1), ERR);
+    mstest::expect_eq(queue_move(screen_, lines, 0), ERR);
+    mstest::expect_eq(queue_move(screen_, 0, columns), ERR);
+    mstest::expect_eq(queue_move(screen_, 70000, 0), ERR);
+    mstest::expect_eq(queue_mvaddnstr(screen_, 0, 65536, 0, "a", -1), ERR);
+    mstest::expect_eq(queue_mvaddnstr(screen_, lines - 1, columns - 1, 0, "a", -1), OK);
+    mstest::expect_eq(wmove(stdscr, -1, 0), ERR);
+    mstest::expect_eq(wmove(stdscr, 0, -1), ERR);
+}
+
+MSTEST_F(DrawQueueShould, SplitLongTextOnCharacterBoundaries)
+{
+    // Two byte characters, odd offset puts boundary inside character
+    const std::string text = "x" + std::string(20, ' ') + "\xc5\x82\xc5\x82\xc5\x82 end";
+    queue_mvaddnstr(screen_, 3, 0, 0, text.c_str(), -1);
+    refresh();
+
+    mstest::expect_eq(stdscr->wide_buffer[3 * stdscr->max_x + 21], static_cast<wchar_t>(0x142));
+    mstest::expect_eq(stdscr->wide_buffer[3 * stdscr->max_x + 22], static_cast<wchar_t>(0x142));
+    mstest::expect_eq(stdscr->wide_buffer[3 * stdscr->max_x + 23], static_cast<wchar_t>(0x142));
+    mstest::expect_eq(row_text(3, 24, 4), " end");
+}
+
+MSTEST_F(DrawQueueShould, PublishCommandsOfOnePushTogether)
+{
+    msos::curses::DrawQueue queue;
+    bool taken_early = false;
+    const bool queued = queue.push(3, [&](std::size_t i, msos::curses::DrawCommand& command) {
+        command.kind = msos::curses::DrawCommand::Kind::more_text;
+        command.size = static_cast<std::uint8_t>(i);
+        msos::curses::DrawCommand early;
+        taken_early = taken_early || queue.pop(early);
+    });
+    mstest::expect_true(queued);
+    mstest::expect_false(taken_early);
+
+    msos::curses::DrawCommand command;
+    for (std::uint8_t i = 0; i < 3; ++i)
+    {
+        mstest::expect_true(queue.pop(command));
+        mstest::expect_eq(command.size, i);
+    }
+    mstest::expect_false(queue.pop(command));
+}
+
+MSTEST_F(DrawQueueShould, AcceptCommandsFromManyThreads)
+{
+    constexpr int producers = 4;
+    constexpr int rows = 4;
+    // Longer than one command, so each text takes several slots
+    const auto text_of = [](int producer, int row) {
+        return "thread " + std::to_string(producer) + " row " + std::to_string(row) + " spans several commands";
+    };
+    std::atomic<int> running{producers};
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([this, producer, &running, &text_of] {
+            for (int row = 0; row < rows; ++row)
+            {
+                const std::string text = text_of(producer, row);
+                while (queue_mvaddnstr(screen_, producer * rows + row, 1, 0, text.c_str(), -1) != OK)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            --running;
+        });
+    }
+    // Render thread consumes while producers are still publishing
+    while (running > 0)
+    {
+        refresh();
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    refresh();
+
+    for (int producer = 0; producer < producers; ++producer)
+    {
+        for (int row = 0; row < rows; ++row)
+        {
+            const std::string text = text_of(producer, row);
+            mstest::expect_eq(row_text(producer * rows + row, 1, static_cast<int>(text.size())), text);
+        }
+    }
+}
@@ -0,0 +1,510 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <mstest/mstest.hpp>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "curses.h"
+
+#include "msos/libc/printf.hpp"
+
+#include "vt_emulator.hpp"
+
+class InputShould : public mstest::Test
+{
+public:
+    void setup() override
+    {
+        initscr();
+        evloop_enable(TRUE);
+        keypad(stdscr, TRUE);
+    }
+
+    void teardown() override
+    {
+        int keys[16];
+        evloop_feed(NULL, 0, keys, 16, NULL);
+        MEVENT event;
+        while (getmouse(&event) == OK);
+        mousemask(0, NULL);
+        bracketed_paste(FALSE);
+        char data[64];
+        while (evloop_drain(data, sizeof(data)) > 0);
+        evloop_enable(FALSE);
+        printf_history().clear();
+        clear_flush_counter();
+        clear_tcgetattr();
+        clear_tcsetattr();
+    }
+
+    int feed(std::string_view data, int* keys, int max_keys)
+    {
+        return evloop_feed(data.data(), static_cast<int>(data.size()), keys, max_keys, NULL);
+    }
+
+    void queue(std::string_view data)
+    {
+        int keys[1];
+        evloop_feed(data.data(), static_cast<int>(data.size()), keys, 0, NULL);
+    }
+
+    std::string drain()
+    {
+        std::string data;
+        char chunk[64];
+        int size;
+        while ((size = evloop_drain(chunk, sizeof(chunk))) > 0)
+        {
+            data.append(chunk, static_cast<std::size_t>(size));
+        }
+        return data;
+    }
+};
+
+MSTEST_F(InputShould, DecodePlainCharacters)
+{
+    int keys[8];
+    mstest::expect_eq(feed("ab", keys, 8), 2);
+    mstest::expect_eq(keys[0], 'a');
+    mstest::expect_eq(keys[1], 'b');
+}
+
+MSTEST_F(InputShould, DecodeEscapeSequences)
+{
+    int keys[8];
+    mstest::expect_eq(feed("\033[A\033OB\033[3~\033[15~", keys, 8), 4);
+    mstest::expect_eq(keys[0], KEY_UP);
+    mstest::expect_eq(keys[1], KEY_DOWN);
+    mstest::expect_eq(keys[2], KEY_DC);
+    mstest::expect_eq(keys[3], KEY_F(5));
+}
+
+MSTEST_F(InputShould, ClampLongSequenceParameters)
+{
+    int keys[32];
+    const int decoded = feed("\033[99999999999999999999~\033[3~", keys, 32);
+    mstest::expect_true(decoded > 0);
+    mstest::expect_eq(keys[decoded - 1], KEY_DC);
+}
+
+MSTEST_F(InputShould, KeepPartialSequenceBetweenFeeds)
+{
+    int keys[8];
+    mstest::expect_eq(feed("x\033[", keys, 8), 1);
+    mstest::expect_eq(keys[0], 'x');
+    mstest::expect_eq(evloop_input_timeout(), ESCDELAY);
+    mstest::expect_eq(feed("6~", keys, 8), 1);
+    mstest::expect_eq(keys[0], KEY_NPAGE);
+    mstest::expect_eq(evloop_input_timeout(), -1);
+}
+
+MSTEST_F(InputShould, ReleaseLoneEscapeAfterTimeout)
+{
+    int keys[8];
+    mstest::expect_eq(feed("\033", keys, 8), 0);
+    mstest::expect_eq(evloop_feed(NULL, 0, keys, 8, NULL), 1);
+    mstest::expect_eq(keys[0], 033);
+}
+
+MSTEST_F(InputShould, PassSequencesThroughWithoutKeypad)
+{
+    keypad(stdscr, FALSE);
+    int keys[8];
+    mstest::expect_eq(feed("\033[A", keys, 8), 3);
+    mstest::expect_eq(keys[0], 033);
+    mstest::expect_eq(keys[1], '[');
+    mstest::expect_eq(keys[2], 'A');
+}
+
+MSTEST_F(InputShould, QueueKeysNotFittingInOutput)
+{
+    int keys[2];
+    mstest::expect_eq(feed("abc", keys, 2), 2);
+    mstest::expect_eq(keys[1], 'b');
+    mstest::expect_eq(getch(), 'c');
+    mstest::expect_eq(getch(), ERR);
+}
+
+MSTEST_F(InputShould, ReturnPushedBackKeyFirst)
+{
+    int keys[8];
+    mstest::expect_eq(ungetch(KEY_LEFT), OK);
+    mstest::expect_eq(feed("q", keys, 8), 2);
+    mstest::expect_eq(keys[0], KEY_LEFT);
+    mstest::expect_eq(keys[1], 'q');
+}
+
+MSTEST_F(InputShould, QueueOutputUntilDrained)
+{
+    printf_history().clear();
+    clear();
+    mstest::expect_true(printf_history().empty());
+    mstest::expect_true(evloop_output_pending());
+
+    char data[8];
+    mstest::expect_eq(evloop_drain(data, sizeof(data)), 8);
+    mstest::expect_eq(std::string_view(data, 8), "\033[0m\033[H\033");
+    mstest::expect_eq(evloop_drain(data, sizeof(data)), 2);
+    mstest::expect_eq(std::string_view(data, 2), "[J");
+    mstest::expect_false(evloop_output_pending());
+}
+
+MSTEST_F(InputShould, DrawScreenLargerThanOutputQueue)
+{
+    const int lines = getmaxy(stdscr);
+    const int columns = getmaxx(stdscr);
+    msos::curses::VtEmulator terminal(lines, columns, false);
+    std::string output = drain();
+    terminal.feed(output.data(), output.size());
+
+    // Every cell changes attributes, frame is several times the queue
+    for (int y = 0; y < lines; ++y)
+    {
+        for (int x = 0; x < columns; ++x)
+        {
+            const chtype bold = (x + y) % 2 ? A_BOLD : A_NORMAL;
+            mvaddch(y, x, static_cast<chtype>(bold | ('a' + (x + y) % 26)));
+        }
+    }
+    refresh();
+    output = drain();
+    terminal.feed(output.data(), output.size());
+    mstest::expect_true(output.size() > 1024);
+
+    for (int y = 0; y < lines; ++y)
+    {
+        for (int x = 0; x < columns; ++x)
+        {
+            mstest::expect_eq(terminal.cell(y, x).text, static_cast<std::uint32_t>('a' + (x + y) % 26));
+            mstest::expect_eq(terminal.cell(y, x).bold, (x + y) % 2 == 1);
+        }
+    }
+
+    refresh();
+    mstest::expect_eq(drain(), "");
+}
+
+MSTEST_F(InputShould, EnableMouseTracking)
+{
+    mstest::expect_eq(mousemask(ALL_MOUSE_EVENTS | REPORT_MOUSE_POSITION, NULL), ALL_MOUSE_EVENTS | REPORT_MOUSE_POSITION);
+    char data[32];
+    const int size = evloop_drain(data, sizeof(data));
+    mstest::expect_eq(std::string_view(data, static_cast<std::size_t>(size)), "\033[?1003h\033[?1006h");
+    mstest::expect_true(has_mouse());
+}
+
+MSTEST_F(InputShould, DecodeSgrMouseReport)
+{
+    mousemask(BUTTON1_PRESSED | BUTTON1_RELEASED, NULL);
+    int keys[8];
+    mstest::expect_eq(feed("\033[<0;12;5M\033[<0;12;5m", keys, 8), 2);
+    mstest::expect_eq(keys[0], KEY_MOUSE);
+    mstest::expect_eq(keys[1], KEY_MOUSE);
+
+    MEVENT event;
+    mstest::expect_eq(getmouse(&event), OK);
+    mstest::expect_eq(event.x, 11);
+    mstest::expect_eq(event.y, 4);
+    mstest::expect_eq(event.bstate, BUTTON1_PRESSED);
+    mstest::expect_eq(getmouse(&event), OK);
+    mstest::expect_eq(event.bstate, BUTTON1_RELEASED);
+    mstest::expect_eq(getmouse(&event), ERR);
+}
+
+MSTEST_F(InputShould, DecodeX10MouseReport)
+{
+    mousemask(ALL_MOUSE_EVENTS, NULL);
+    int keys[8];
+    mstest::expect_eq(feed("\033[M\x21\x2a", keys, 8), 0);
+    mstest::expect_eq(feed("\x25", keys, 8), 1);
+    mstest::expect_eq(keys[0], KEY_MOUSE);
+
+    MEVENT event;
+    mstest::expect_eq(getmouse(&event), OK);
+    mstest::expect_eq(event.x, 9);
+    mstest::expect_eq(event.y, 4);
+    mstest::expect_eq(event.bstate, BUTTON2_PRESSED);
+}
+
+MSTEST_F(InputShould, MergeMotionReportsIntoLatestPosition)
+{
+    mousemask(ALL_MOUSE_EVENTS | REPORT_MOUSE_POSITION, NULL);
+    int keys[8];
+    mstest::expect_eq(feed("\033[<32;1;1M\033[<32;2;1M\033[<32;3;2Mq\033[<32;4;2M", keys, 8), 2);
+    mstest::expect_eq(keys[0], KEY_MOUSE);
+    mstest::expect_eq(keys[1], 'q');
+
+    MEVENT event;
+    mstest::expect_eq(getmouse(&event), OK);
+    mstest::expect_eq(event.x, 3);
+    mstest::expect_eq(event.y, 1);
+    mstest::expect_eq(event.bstate, REPORT_MOUSE_POSITION);
+    mstest::expect_eq(getmouse(&event), ERR);
+}
+
+MSTEST_F(InputShould, ReturnPushedBackMouseEventFirst)
+{
+    mousemask(BUTTON1_PRESSED, NULL);
+    int keys[8];
+    mstest::expect_eq(feed("\033[<0;12;5M", keys, 8), 1);
+
+    MEVENT pushed = {};
+    pushed.x = 2;
+    pushed.y = 3;
+    pushed.bstate = BUTTON1_CLICKED;
+    mstest::expect_eq(ungetmouse(&pushed), OK);
+    mstest::expect_eq(getch(), KEY_MOUSE);
+
+    MEVENT event;
+    mstest::expect_eq(getmouse(&event), OK);
+    mstest::expect_eq(event.bstate, BUTTON1_CLICKED);
+    mstest::expect_eq(event.x, 2);
+    mstest::expect_eq(getmouse(&event), OK);
+    mstest::expect_eq(event.bstate, BUTTON1_PRESSED);
+    mstest::expect_eq(event.x, 11);
+}
+
+MSTEST_F(InputShould, KeepReportedMouseEventsWhenQueueIsFull)
+{
+    mousemask(BUTTON1_PRESSED, NULL);
+    int keys[16];
+    std::string reports;
+    for (int x = 1; x <= 9; ++x)
+    {
+        reports += "\033[<0;" + std::to_string(x) + ";1M";
+    }
+    // Report that does not fit gets no KEY_MOUSE
+    mstest::expect_eq(feed(reports, keys, 16), 8);
+
+    MEVENT pushed = {};
+    mstest::expect_eq(ungetmouse(&pushed), ERR);
+    MEVENT event;
+    for (int x = 0; x < 8; ++x)
+    {
+        mstest::expect_eq(getmouse(&event), OK);
+        mstest::expect_eq(event.x, x);
+    }
+    mstest::expect_eq(getmouse(&event), ERR);
+}
+
+MSTEST_F(InputShould, DropMouseEventsOutsideOfMask)
+{
+    mousemask(BUTTON1_PRESSED, NULL);
+    int keys[8];
+    mstest::expect_eq(feed("\033[<2;1;1M\033[<64;1;1Mz", keys, 8), 1);
+    mstest::expect_eq(keys[0], 'z');
+}
+
+MSTEST_F(InputShould, EnableBracketedPaste)
+{
+    bracketed_paste(TRUE);
+    char data[16];
+    const int size = evloop_drain(data, sizeof(data));
+    mstest::expect_eq(std::string_view(data, static_cast<std::size_t>(size)), "\033[?2004h");
+}
+
+MSTEST_F(InputShould, DeliverPasteAsSingleKey)
+{
+    bracketed_paste(TRUE);
+    int keys[8];
+    mstest::expect_eq(feed("a\033[200~line 1\r\033[Aline 2\033[201~b", keys, 8), 2);
+    mstest::expect_eq(keys[0], 'a');
+    mstest::expect_eq(keys[1], KEY_PASTE);
+
+    int size;
+    const char* paste = getpaste(&size);
+    mstest::expect_eq(std::string_view(paste, static_cast<std::size_t>(size)), "line 1\r\033[Aline 2");
+
+    mstest::expect_eq(feed("", keys, 8), 1);
+    mstest::expect_eq(keys[0], 'b');
+    mstest::expect_true(getpaste(&size) == nullptr);
+    mstest::expect_eq(size, 0);
+}
+
+MSTEST_F(InputShould, WaitForPasteEndMarker)
+{
+    bracketed_paste(TRUE);
+    int keys[8];
+    mstest::expect_eq(feed("\033[200~abc\033[20", keys, 8), 0);
+    mstest::expect_eq(feed("1~", keys, 8), 1);
+    mstest::expect_eq(keys[0], KEY_PASTE);
+
+    int size;
+    const char* paste = getpaste(&size);
+    mstest::expect_eq(std::string_view(paste, static_cast<std::size_t>(size)), "abc");
+}
+
+MSTEST_F(InputShould, TakeOnlyInputThatFits)
+{
+    const std::string data(300, 'x');
+    int keys[10];
+    int received = 0;
+    for (std::size_t offset = 0; offset < data.size();)
+    {
+        int consumed;
+        const int decoded = evloop_feed(data.data() + offset, static_cast<int>(data.size() - offset), keys, 10, &consumed);
+        if (consumed == 0 && decoded == 0)
+        {
+            break;
+        }
+        received += decoded;
+        offset += static_cast<std::size_t>(consumed);
+    }
+    int decoded;
+    while ((decoded = feed("", keys, 10)) > 0)
+    {
+        received += decoded;
+    }
+    mstest::expect_eq(received, 300);
+}
+
+MSTEST_F(InputShould, DeliverPasteLongerThanInputQueue)
+{
+    bracketed_paste(TRUE);
+    const std::string payload(3000, 'p');
+    const std::string data = "\033[200~" + payload + "\033[201~z";
+    std::string pasted;
+    std::string typed;
+    int keys[4];
+    for (std::size_t offset = 0; offset < data.size() || typed.empty();)
+    {
+        int consumed;
+        const int decoded = evloop_feed(data.data() + offset, static_cast<int>(data.size() - offset), keys, 4, &consumed);
+        if (consumed == 0 && decoded == 0)
+        {
+            break;
+        }
+        offset += static_cast<std::size_t>(consumed);
+        for (int i = 0; i < decoded; ++i)
+        {
+            if (keys[i] == KEY_PASTE)
+            {
+                int size;
+                const char* paste = getpaste(&size);
+                pasted.append(paste, static_cast<std::size_t>(size));
+            }
+            else
+            {
+                typed.push_back(static_cast<char>(keys[i]));
+            }
+        }
+    }
+    mstest::expect_eq(pasted, payload);
+    mstest::expect_eq(typed, "z");
+}
+
+MSTEST_F(InputShould, EditLineInsideWindow)
+{
+    clear();
+    queue("abd\033[Dc\177x\r");
+    char line[16];
+    mstest::expect_eq(mvgetnstr(3, 10, line, 15), OK);
+    mstest::expect_eq(std::string_view(line), "abxd");
+    mstest::expect_eq(stdscr->screen_buffer[3 * stdscr->max_x + 10], 'a');
+    mstest::expect_eq(stdscr->screen_buffer[3 * stdscr->max_x + 12], 'x');
+    mstest::expect_eq(stdscr->screen_buffer[3 * stdscr->max_x + 13], 'd');
+    mstest::expect_eq(stdscr->cursor_x, 13);
+}
+
+MSTEST_F(InputShould, EditUtf8CharactersAsWhole)
+{
+    clear();
+    // a, z with dot, CJK character, backspace removes whole CJK character
+    queue("a\xc5\xbc\xe4\xb8\xad\177\033[D\xc3\xa9\r");
+    char line[16];
+    mstest::expect_eq(mvgetnstr(2, 0, line, 15), OK);
+    mstest::expect_eq(std::string_view(line), "a\xc3\xa9\xc5\xbc");
+    const int row = 2 * stdscr->max_x;
+    mstest::expect_eq(stdscr->screen_buffer[row], 'a');
+    mstest::expect_eq(stdscr->wide_buffer[row + 1], static_cast<wchar_t>(0xe9));
+    mstest::expect_eq(stdscr->wide_buffer[row + 2], static_cast<wchar_t>(0x17c));
+    mstest::expect_eq(stdscr->wide_buffer[row + 3], 0);
+    mstest::expect_eq(stdscr->screen_buffer[row + 3], ' ');
+}
+
+MSTEST_F(InputShould, KeepMultibyteCharacterWithinLimit)
+{
+    clear();
+    queue("ab\xc5\xbc\r");
+    char line[4];
+    mstest::expect_eq(getnstr(line, 3), OK);
+    mstest::expect_eq(std::string_view(line), "ab");
+}
+
+MSTEST_F(InputShould, EchoOnlyEditedSpan)
+{
+    clear();
+    queue("abc");
+    char line[16];
+    mstest::expect_eq(mvgetnstr(0, 0, line, 15), ERR);
+    drain();
+
+    queue("d\r");
+    mstest::expect_eq(getnstr(line, 15), OK);
+    mstest::expect_eq(drain(), "d");
+}
+
+MSTEST_F(InputShould, LimitLineLength)
+{
+    clear();
+    queue("abcdef\n");
+    char line[4];
+    mstest::expect_eq(getnstr(line, 3), OK);
+    mstest::expect_eq(std::string_view(line), "abc");
+}
+
+MSTEST_F(InputShould, ReadLineIntoPointer)
+{
+    clear();
+    queue("abc\n");
+    char line[16];
+    char* target = line;
+    mstest::expect_eq(getstr(target), OK);
+    mstest::expect_eq(std::string_view(line), "abc");
+}
+
+MSTEST_F(InputShould, KillWholeLine)
+{
+    clear();
+    struct termios tattr = {};
+    tattr.c_cc[VKILL] = 0x15;
+    set_tcgetattr(&tattr);
+    queue("abc\x15z\n");
+    char line[16];
+    mstest::expect_eq(getnstr(line, 15), OK);
+    mstest::expect_eq(std::string_view(line), "z");
+    mstest::expect_eq(stdscr->screen_buffer[1], ' ');
+
+    tattr.c_cc[VKILL] = 0;
+    set_tcgetattr(&tattr);
+}
+
+MSTEST_F(InputShould, AssembleUtf8Characters)
+{
+    queue("\xc5");
+    wint_t c;
+    mstest::expect_eq(get_wch(&c), ERR);
+    queue("\xbc\033[Bq");
+    mstest::expect_eq(get_wch(&c), OK);
+    mstest::expect_eq(c, static_cast<wint_t>(0x17c));
+    mstest::expect_eq(get_wch(&c), KEY_CODE_YES);
+    mstest::expect_eq(c, static_cast<wint_t>(KEY_DOWN));
+    mstest::expect_eq(get_wch(&c), OK);
+    mstest::expect_eq(c, static_cast<wint_t>('q'));
+}
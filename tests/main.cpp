@@ -16,7 +16,11 @@
 
 #include <mstest/mstest.hpp>
 
+#include <cstdlib>
+
 int main()
 {
+    // Output must not depend on terminal which runs tests
+    setenv("TERM", "msos-tests", 1);
     return mstest::run_tests();
 }
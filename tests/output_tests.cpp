@@ -16,6 +16,7 @@
 
 #include <mstest/mstest.hpp>
 
+#include <csignal>
 #include <string_view>
 
 #include <unistd.h>
@@ -188,3 +189,278 @@ MSTEST_F(OutputShould, TrimCharStringAtMargin)
     mstest::expect_eq(stdscr->screen_buffer[stdscr->max_x * 2 - 1], 'b');
     mstest::expect_eq(stdscr->screen_buffer[stdscr->max_x * 2], 0);
 }
+
+std::string printed()
+{
+    std::string data;
+    for (const auto& call : printf_history())
+    {
+        data += call.str();
+    }
+    return data;
+}
+
+MSTEST_F(OutputShould, RefreshSendsOnlyChangedCells)
+{
+    clear();
+    printf_history().clear();
+    mvaddch(2, 3, 'x');
+    refresh();
+    mstest::expect_eq(printed(), "\033[3;4H\033(B\033[0mx", &string_as_number);
+
+    printf_history().clear();
+    refresh();
+    mstest::expect_eq(printed(), "");
+
+    mvaddch(2, 5, 'y');
+    mvaddch(2, 20, 'z');
+    refresh();
+    mstest::expect_eq(printed(), " y\033[14Cz", &string_as_number);
+}
+
+MSTEST_F(OutputShould, RefreshUsesWindowAttributes)
+{
+    clear();
+    printf_history().clear();
+    attrset(A_UNDERLINE >> A_ATTRIBUTES_OFFSET);
+    mvaddch(0, 0, 'u');
+    refresh();
+    mstest::expect_eq(printed(), "\033(B\033[0;4mu", &string_as_number);
+}
+
+MSTEST_F(OutputShould, RefreshUsesColorPairSequences)
+{
+    start_color();
+    init_pair(1, COLOR_RED, COLOR_BLUE);
+    clear();
+    printf_history().clear();
+    attrset(COLOR_PAIR(1) | (A_BOLD >> A_ATTRIBUTES_OFFSET));
+    mvaddch(0, 0, 'a');
+    refresh();
+    mstest::expect_eq(printed(), "\033(B\033[0;1;31;44ma", &string_as_number);
+
+    printf_history().clear();
+    init_pair(1, COLOR_GREEN, COLOR_BLUE);
+    attrset(COLOR_PAIR(1));
+    addch('b');
+    refresh();
+    mstest::expect_eq(printed(), "\033(B\033[0;32;44mb", &string_as_number);
+    attrset(A_NORMAL);
+}
+
+MSTEST_F(OutputShould, MergeBackgroundIntoWrittenCharacters)
+{
+    clear();
+    bkgdset(static_cast<chtype>('.' | A_BOLD));
+    mvaddstr(0, 0, "a b");
+    mstest::expect_eq(stdscr->screen_buffer[0], static_cast<chtype>('a' | A_BOLD));
+    mstest::expect_eq(stdscr->screen_buffer[1], static_cast<chtype>('.' | A_BOLD));
+    mstest::expect_eq(stdscr->screen_buffer[2], static_cast<chtype>('b' | A_BOLD));
+    mstest::expect_eq(getbkgd(stdscr), static_cast<chtype>('.' | A_BOLD));
+    bkgdset(0);
+}
+
+MSTEST_F(OutputShould, ReplaceBackgroundOfWholeWindow)
+{
+    constexpr chtype pair = static_cast<chtype>(COLOR_PAIR(2) << A_ATTRIBUTES_OFFSET);
+    constexpr chtype other_pair = static_cast<chtype>(COLOR_PAIR(3) << A_ATTRIBUTES_OFFSET);
+    clear();
+    mvaddch(0, 0, 'a');
+    mvaddch(0, 1, static_cast<chtype>('b' | other_pair));
+    mstest::expect_eq(bkgd(static_cast<chtype>(' ' | pair)), OK);
+    mstest::expect_eq(stdscr->screen_buffer[0], static_cast<chtype>('a' | pair));
+    mstest::expect_eq(stdscr->screen_buffer[1], static_cast<chtype>('b' | other_pair));
+    mstest::expect_eq(stdscr->screen_buffer[2], static_cast<chtype>(' ' | pair));
+
+    mstest::expect_eq(bkgd(0), OK);
+    mstest::expect_eq(stdscr->screen_buffer[0], static_cast<chtype>('a'));
+    mstest::expect_eq(stdscr->screen_buffer[2], static_cast<chtype>(' '));
+}
+
+MSTEST_F(OutputShould, EraseBlankEndOfScreen)
+{
+    clear();
+    mvaddstr(0, 0, "abcdefgh");
+    refresh();
+    printf_history().clear();
+    mvaddstr(0, 0, "ab      ");
+    refresh();
+    mstest::expect_eq(printed(), "\033[6D\033[J\033[6C", &string_as_number);
+}
+
+MSTEST_F(OutputShould, DecodeUtf8IntoWideCells)
+{
+    clear();
+    mstest::expect_eq(mvaddstr(1, 0, "a\xc5\xbc\xe4\xb8\xad"), OK);
+    const int line = stdscr->max_x;
+    mstest::expect_eq(stdscr->screen_buffer[line], 'a');
+    mstest::expect_eq(stdscr->wide_buffer[line], 0);
+    mstest::expect_eq(stdscr->wide_buffer[line + 1], static_cast<wchar_t>(0x17c));
+    mstest::expect_eq(stdscr->wide_buffer[line + 2], static_cast<wchar_t>(0x4e2d));
+    mstest::expect_eq(stdscr->cursor_x, 4);
+
+    printf_history().clear();
+    refresh();
+    mstest::expect_eq(printed(), "\r\n\033(B\033[0ma\xc5\xbc\xe4\xb8\xad", &string_as_number);
+}
+
+MSTEST_F(OutputShould, BlankOtherHalfOfOverwrittenWideCharacter)
+{
+    clear();
+    const wchar_t text[] = {0x4e2d, 0x6587, 0};
+    mstest::expect_eq(addwstr(text), OK);
+    mstest::expect_eq(mvaddch(0, 1, 'x'), OK);
+    mstest::expect_eq(stdscr->screen_buffer[0], ' ');
+    mstest::expect_eq(stdscr->wide_buffer[0], 0);
+    mstest::expect_eq(stdscr->screen_buffer[1], 'x');
+    mstest::expect_eq(stdscr->wide_buffer[2], static_cast<wchar_t>(0x6587));
+}
+
+MSTEST_F(OutputShould, WrapWideCharacterNotFittingInLine)
+{
+    clear();
+    const wchar_t text[] = {0x4e2d, 0};
+    mstest::expect_eq(mvaddwstr(0, stdscr->max_x - 1, text), OK);
+    mstest::expect_eq(stdscr->screen_buffer[stdscr->max_x - 1], ' ');
+    mstest::expect_eq(stdscr->wide_buffer[stdscr->max_x], static_cast<wchar_t>(0x4e2d));
+    mstest::expect_eq(stdscr->cursor_y, 1);
+    mstest::expect_eq(stdscr->cursor_x, 2);
+}
+
+MSTEST_F(OutputShould, RedrawWholeWideCharacterWhenHalfChanged)
+{
+    clear();
+    const wchar_t text[] = {0x4e2d, 0};
+    mvaddwstr(0, 4, text);
+    refresh();
+
+    stdscr->wide_buffer[5] = 0;
+    stdscr->screen_buffer[5] = 'y';
+    stdscr->cursor_x = 6;
+    printf_history().clear();
+    refresh();
+    mstest::expect_eq(printed(), "\by", &string_as_number);
+}
+
+MSTEST_F(OutputShould, KeepCombiningMarkWithCharacter)
+{
+    clear();
+    cchar_t c;
+    const wchar_t text[] = {'e', 0x301, 0};
+    mstest::expect_eq(setcchar(&c, text, A_BOLD, 0, NULL), OK);
+    mstest::expect_eq(add_wch(&c), OK);
+    mstest::expect_eq(stdscr->cursor_x, 1);
+
+    printf_history().clear();
+    refresh();
+    mstest::expect_eq(printed(), "\033(B\033[0;1me\xcc\x81", &string_as_number);
+}
+
+MSTEST_F(OutputShould, DrawDefaultLinesForMissingBorderCharacters)
+{
+    clear();
+    mstest::expect_eq(box_set(stdscr, nullptr, nullptr), OK);
+    const int width = stdscr->max_x;
+    const int last = stdscr->max_y * width - 1;
+    mstest::expect_eq(stdscr->wide_buffer[0], static_cast<wchar_t>(0x250c));
+    mstest::expect_eq(stdscr->wide_buffer[1], static_cast<wchar_t>(0x2500));
+    mstest::expect_eq(stdscr->wide_buffer[width - 1], static_cast<wchar_t>(0x2510));
+    mstest::expect_eq(stdscr->wide_buffer[width], static_cast<wchar_t>(0x2502));
+    mstest::expect_eq(stdscr->wide_buffer[last - width + 1], static_cast<wchar_t>(0x2514));
+    mstest::expect_eq(stdscr->wide_buffer[last], static_cast<wchar_t>(0x2518));
+
+    cchar_t side;
+    const wchar_t text[] = {'|', 0};
+    setcchar(&side, text, 0, 0, NULL);
+    mstest::expect_eq(wborder_set(stdscr, &side, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr), OK);
+    mstest::expect_eq(stdscr->screen_buffer[width], '|');
+    mstest::expect_eq(stdscr->wide_buffer[2 * width - 1], static_cast<wchar_t>(0x2502));
+}
+
+MSTEST_F(OutputShould, RedrawLinesInFull)
+{
+    clear();
+    mvaddstr(2, 0, "abc");
+    mvaddstr(3, 0, "def");
+    refresh();
+
+    printf_history().clear();
+    mstest::expect_eq(wredrawln(stdscr, 3, 1), OK);
+    refresh();
+    mstest::expect_eq(printed(), "\033[4H\033(B\033[0mdef\033[J", &string_as_number);
+
+    printf_history().clear();
+    mstest::expect_eq(redrawwin(stdscr), OK);
+    refresh();
+    mstest::expect_true(printed().find("abc") != std::string::npos);
+    mstest::expect_true(printed().find("def") != std::string::npos);
+    mstest::expect_eq(wredrawln(stdscr, -1, 1), ERR);
+}
+
+MSTEST_F(OutputShould, ResyncFewLinesPerFrame)
+{
+    clear();
+    mvaddstr(3, 0, "abc");
+    refresh();
+    mstest::expect_eq(resync_lines(nullptr, -1), ERR);
+    mstest::expect_eq(resync_lines(nullptr, 2), OK);
+
+    printf_history().clear();
+    refresh();
+    mstest::expect_eq(printed().find("abc"), std::string::npos);
+    printf_history().clear();
+    refresh();
+    mstest::expect_true(printed().find("abc") != std::string::npos);
+
+    // Lines are visited round robin, so each of them comes back
+    for (int frame = 0; frame < getmaxy(stdscr) / 2 - 1; ++frame)
+    {
+        printf_history().clear();
+        refresh();
+        mstest::expect_eq(printed().find("abc"), std::string::npos);
+    }
+    printf_history().clear();
+    refresh();
+    mstest::expect_true(printed().find("abc") != std::string::npos);
+    resync_lines(nullptr, 0);
+}
+
+MSTEST_F(OutputShould, ResizeKeepingCellsThatFit)
+{
+    clear();
+    mvaddstr(0, 0, "abc");
+    mvaddstr(10, 70, "0123456789");
+    refresh();
+
+    mstest::expect_false(is_term_resized(getmaxy(stdscr), getmaxx(stdscr)));
+    mstest::expect_true(is_term_resized(20, 60));
+    mstest::expect_eq(resizeterm(20, 60), OK);
+    mstest::expect_eq(getmaxy(stdscr), 20);
+    mstest::expect_eq(getmaxx(stdscr), 60);
+    mstest::expect_eq(stdscr->screen_buffer[2], static_cast<chtype>('c'));
+    mstest::expect_eq(getch(), KEY_RESIZE);
+
+    // Line that was cut off and ones below it are drawn, others are kept
+    printf_history().clear();
+    refresh();
+    mstest::expect_eq(printed().rfind("\033[11H", 0), 0u);
+    mstest::expect_eq(printed().find("abc"), std::string::npos);
+
+    // Exposed cells are blank on terminal already
+    mstest::expect_eq(resize_term(20, 96), OK);
+    mstest::expect_eq(stdscr->screen_buffer[96 + 2], static_cast<chtype>(0));
+    mstest::expect_eq(stdscr->screen_buffer[2], static_cast<chtype>('c'));
+    printf_history().clear();
+    mvaddch(18, 90, 'z');
+    refresh();
+    mstest::expect_eq(printed(), "\033[19;91H\033(B\033[0mz", &string_as_number);
+    resize_term(24, 80);
+}
+
+MSTEST_F(OutputShould, ReportResizeAfterSigwinch)
+{
+    resize_term(1, 1);
+    raise(SIGWINCH);
+    mstest::expect_eq(getch(), KEY_RESIZE);
+    mstest::expect_true(getmaxx(stdscr) > 1);
+}
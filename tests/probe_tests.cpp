@@ -0,0 +1,176 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <mstest/mstest.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+#include "msos/libc/printf.hpp"
+
+#include "curses.h"
+
+namespace
+{
+
+constexpr std::string_view replies = "\033[1;4R"
+                                     "\033[?2026;2$y"
+                                     "\033P1$r0;48:2::1:2:3m\033\\"
+                                     "\033[>41;380;0c"
+                                     "\033[?64;1;2;6;9;15;22c";
+
+std::string printed()
+{
+    std::string data;
+    for (const auto& call : printf_history())
+    {
+        data += call.str();
+    }
+    return data;
+}
+
+} // namespace
+
+class TerminalProbeShould : public mstest::Test
+{
+public:
+    void setup() override
+    {
+        // Terminal replies are read from standard input
+        int fds[2];
+        static_cast<void>(pipe(fds));
+        input_ = dup(STDIN_FILENO);
+        dup2(fds[0], STDIN_FILENO);
+        close(fds[0]);
+        terminal_ = fds[1];
+        term_ = std::getenv("TERM");
+    }
+
+    void teardown() override
+    {
+        endwin();
+        use_terminal_probe(FALSE, -1);
+        close(terminal_);
+        dup2(input_, STDIN_FILENO);
+        close(input_);
+        setenv("TERM", term_.c_str(), 1);
+        setupterm(nullptr, STDOUT_FILENO, nullptr);
+        printf_history().clear();
+        clear_flush_counter();
+        clear_tcgetattr();
+        clear_tcsetattr();
+    }
+
+    void reply(std::string_view data)
+    {
+        static_cast<void>(write(terminal_, data.data(), data.size()));
+    }
+
+private:
+    int input_ = -1;
+    int terminal_ = -1;
+    std::string term_;
+};
+
+MSTEST_F(TerminalProbeShould, NotQueryTerminalUnlessEnabled)
+{
+    reply(replies);
+    initscr();
+    mstest::expect_eq(terminal_features(), 0);
+    mstest::expect_eq(printed().find("\033[c"), std::string::npos);
+}
+
+MSTEST_F(TerminalProbeShould, EnableEncodingsConfirmedByTerminal)
+{
+    reply(replies);
+    use_terminal_probe(TRUE, 1000);
+    initscr();
+    mstest::expect_eq(printed().rfind("\033[H \033[2b\033[6n", 0), 0u);
+    mstest::expect_eq(terminal_features(), TERMINAL_REPEAT | TERMINAL_ERASE_CHARACTERS | TERMINAL_SCROLL_REGION
+        | TERMINAL_DIRECT_COLOR | TERMINAL_SYNCHRONIZED_OUTPUT);
+    start_color();
+    mstest::expect_true(can_change_color());
+
+    mvaddstr(0, 0, "----------------x");
+    refresh();
+    printf_history().clear();
+    mvaddstr(0, 0, "                ");
+    mvaddstr(1, 0, "abc");
+    refresh();
+    // Terminal confirmed synchronized output, so frame is wrapped in it
+    mstest::expect_eq(printed(), "\033[?2026h\r\033[16X\r\nabc\033[?2026l");
+}
+
+MSTEST_F(TerminalProbeShould, RepeatCharacters)
+{
+    reply(replies);
+    use_terminal_probe(TRUE, 1000);
+    initscr();
+    clear();
+    refresh();
+    printf_history().clear();
+    mvaddstr(0, 0, "----------------x");
+    mvaddstr(1, 0, "----");
+    refresh();
+    mstest::expect_eq(printed(), "\033[?2026h\033(B\033[0m-\033[15bx\r\n----\033[?2026l");
+}
+
+MSTEST_F(TerminalProbeShould, KeepKeysTypedDuringProbe)
+{
+    reply("k\033[?1;2c");
+    use_terminal_probe(TRUE, 1000);
+    initscr();
+    mstest::expect_eq(terminal_features(), TERMINAL_SCROLL_REGION);
+    mstest::expect_eq(getch(), 'k');
+}
+
+MSTEST_F(TerminalProbeShould, ClampLongReplyParameters)
+{
+    reply("\033[1;99999999999999999999R\033[?1;99999999999999999999c");
+    use_terminal_probe(TRUE, 1000);
+    initscr();
+    mstest::expect_eq(terminal_features(), TERMINAL_SCROLL_REGION);
+}
+
+MSTEST_F(TerminalProbeShould, PreferAnswersOverTerminfo)
+{
+    // Terminfo claims REP and ECH, but terminal echoes repeated character only once
+    setenv("TERM", "xterm-256color", 1);
+    reply("\033[1;2R\033[?1;2c");
+    use_terminal_probe(TRUE, 1000);
+    initscr();
+    mstest::expect_eq(terminal_features(), TERMINAL_SCROLL_REGION);
+
+    mvaddstr(0, 0, "----------------x");
+    refresh();
+    mstest::expect_eq(printed().find("\033[15b"), std::string::npos);
+}
+
+MSTEST_F(TerminalProbeShould, GiveUpWhenTerminalDoesNotAnswer)
+{
+    reply("\033[1;2R");
+    use_terminal_probe(TRUE, 20);
+    const auto start = std::chrono::steady_clock::now();
+    initscr();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    mstest::expect_true(elapsed < std::chrono::milliseconds(500));
+    mstest::expect_eq(terminal_features(), 0);
+}
@@ -0,0 +1,146 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <mstest/mstest.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "msos/libc/printf.hpp"
+
+#include "curses.h"
+
+#include "recorder.hpp"
+
+namespace
+{
+
+std::vector<std::string> lines_of(const std::string& text)
+{
+    std::vector<std::string> lines;
+    std::size_t start = 0;
+    for (std::size_t end; (end = text.find('\n', start)) != std::string::npos; start = end + 1)
+    {
+        lines.push_back(text.substr(start, end - start));
+    }
+    return lines;
+}
+
+int append(void* context, const char* data, int size)
+{
+    static_cast<std::string*>(context)->append(data, static_cast<std::size_t>(size));
+    return size;
+}
+
+} // namespace
+
+class RecorderShould : public mstest::Test
+{
+public:
+    void setup() override
+    {
+        initial_ = set_term(nullptr);
+        output_ = std::fopen("/dev/null", "w");
+        input_ = std::fopen("/dev/null", "r");
+        created_ = newterm("vt100", output_, input_);
+        set_output_buffer(created_, output_buffer_, sizeof(output_buffer_));
+    }
+
+    void teardown() override
+    {
+        set_term(created_);
+        stop_recording(created_);
+        evloop_enable(false);
+        endwin();
+        delscreen(created_);
+        std::fclose(output_);
+        std::fclose(input_);
+        set_term(initial_);
+        printf_history().clear();
+        clear_flush_counter();
+        clear_tcgetattr();
+        clear_tcsetattr();
+    }
+
+protected:
+    static char recording_[1024];
+    SCREEN* created_ = nullptr;
+
+private:
+    static char output_buffer_[4096];
+    SCREEN* initial_ = nullptr;
+    FILE* output_ = nullptr;
+    FILE* input_ = nullptr;
+};
+
+char RecorderShould::recording_[1024];
+char RecorderShould::output_buffer_[4096];
+
+MSTEST_F(RecorderShould, ExportOutputAndInputAsAsciicast)
+{
+    mstest::expect_eq(start_recording(created_, recording_, sizeof(recording_)), OK);
+    mvaddstr(0, 0, "rec \"quoted\"");
+    refresh();
+    evloop_enable(true);
+    int keys[4];
+    evloop_feed("\033[A", 3, keys, 4, NULL);
+    mstest::expect_true(stop_recording(created_) > 0);
+
+    std::string cast;
+    mstest::expect_eq(export_asciicast(created_, append, &cast), OK);
+    const std::vector<std::string> lines = lines_of(cast);
+    mstest::expect_eq(lines.size(), 3ul);
+    mstest::expect_eq(lines[0], "{\"version\": 2, \"width\": 80, \"height\": 24, \"env\": {\"TERM\": \"vt100\"}}");
+    mstest::expect_true(lines[1].find(", \"o\", \"") != std::string::npos);
+    mstest::expect_true(lines[1].find("rec \\\"quoted\\\"") != std::string::npos);
+    mstest::expect_eq(lines[2].substr(lines[2].find(',')), ", \"i\", \"\\u001b[A\"]");
+}
+
+MSTEST_F(RecorderShould, KeepOnlyWholeRecordsWhenFull)
+{
+    start_recording(created_, recording_, 16);
+    mvaddstr(0, 0, "short");
+    refresh();
+    mvaddstr(1, 0, "longer than what is left in recording");
+    refresh();
+    const int size = stop_recording(created_);
+    mstest::expect_true(size > 0 && size <= 16);
+
+    std::string cast;
+    export_asciicast(created_, append, &cast);
+    for (const std::string& line : lines_of(cast))
+    {
+        mstest::expect_true(line.back() == '}' || line.back() == ']');
+    }
+}
+
+MSTEST_F(RecorderShould, JoinCharactersSplitBetweenRecords)
+{
+    msos::curses::Recorder recorder;
+    recorder.start(recording_, sizeof(recording_));
+    recorder.record(msos::curses::Recorder::Event::output, "a\xc3", 2);
+    recorder.record(msos::curses::Recorder::Event::output, "\xa9" "b\x80", 3);
+    const std::size_t size = recorder.stop();
+
+    std::string cast;
+    mstest::expect_true(msos::curses::write_asciicast(recording_, size, 24, 80, "xterm", append, &cast));
+    const std::vector<std::string> lines = lines_of(cast);
+    mstest::expect_eq(lines.size(), 3ul);
+    mstest::expect_eq(lines[1].substr(lines[1].find(',')), ", \"o\", \"a\"]");
+    mstest::expect_eq(lines[2].substr(lines[2].find(',')), ", \"o\", \"\xc3\xa9" "b\\u0080\"]");
+}
@@ -0,0 +1,423 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <mstest/mstest.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "msos/libc/printf.hpp"
+
+#include "curses.h"
+
+namespace
+{
+
+// Pipes acting as serial line of one terminal
+class Line
+{
+public:
+    Line()
+    {
+        int output[2];
+        int input[2];
+        static_cast<void>(pipe(output));
+        static_cast<void>(pipe(input));
+        fcntl(output[0], F_SETFL, O_NONBLOCK);
+        screen_output_ = fdopen(output[1], "w");
+        setvbuf(screen_output_, nullptr, _IONBF, 0);
+        terminal_output_ = output[0];
+        screen_input_ = fdopen(input[0], "r");
+        terminal_input_ = input[1];
+    }
+
+    ~Line()
+    {
+        std::fclose(screen_output_);
+        std::fclose(screen_input_);
+        close(terminal_output_);
+        if (terminal_input_ >= 0)
+        {
+            close(terminal_input_);
+        }
+    }
+
+    SCREEN* open(const char* type)
+    {
+        return newterm(type, screen_output_, screen_input_);
+    }
+
+    std::string received()
+    {
+        std::string data;
+        char chunk[256];
+        ssize_t size;
+        while ((size = read(terminal_output_, chunk, sizeof(chunk))) > 0)
+        {
+            data.append(chunk, static_cast<std::size_t>(size));
+        }
+        return data;
+    }
+
+    void type(const char* keys)
+    {
+        static_cast<void>(write(terminal_input_, keys, std::strlen(keys)));
+    }
+
+    void hang_up()
+    {
+        close(terminal_input_);
+        terminal_input_ = -1;
+    }
+
+private:
+    FILE* screen_output_;
+    FILE* screen_input_;
+    int terminal_output_;
+    int terminal_input_;
+};
+
+} // namespace
+
+class ScreenShould : public mstest::Test
+{
+public:
+    void setup() override
+    {
+        initial_ = set_term(nullptr);
+    }
+
+    void teardown() override
+    {
+        for (SCREEN* created : created_)
+        {
+            set_term(created);
+            endwin();
+            delscreen(created);
+        }
+        created_.clear();
+        // Lines are closed only after their screens are deleted
+        lines_.clear();
+        set_term(initial_);
+        printf_history().clear();
+        clear_flush_counter();
+        clear_tcgetattr();
+        clear_tcsetattr();
+    }
+
+    Line& line()
+    {
+        lines_.push_back(std::make_unique<Line>());
+        return *lines_.back();
+    }
+
+    SCREEN* open(Line& line, const char* type)
+    {
+        SCREEN* created = line.open(type);
+        if (created != nullptr)
+        {
+            created_.push_back(created);
+        }
+        return created;
+    }
+
+private:
+    SCREEN* initial_ = nullptr;
+    std::vector<SCREEN*> created_;
+    std::vector<std::unique_ptr<Line>> lines_;
+};
+
+MSTEST_F(ScreenShould, DrawEachScreenOnItsTerminal)
+{
+    Line& first = line();
+    Line& second = line();
+    SCREEN* one = open(first, "msos-tests");
+    mvaddstr(1, 0, "first");
+    refresh();
+    SCREEN* two = open(second, "msos-tests");
+    mvaddstr(1, 0, "second");
+    refresh();
+    mstest::expect_true(one != nullptr && two != nullptr && one != two);
+
+    const std::string on_first = first.received();
+    const std::string on_second = second.received();
+    mstest::expect_true(on_first.find("first") != std::string::npos);
+    mstest::expect_true(on_first.find("second") == std::string::npos);
+    mstest::expect_true(on_second.find("second") != std::string::npos);
+    mstest::expect_true(on_second.find("first") == std::string::npos);
+    mstest::expect_true(printf_history().empty());
+
+    // Contents of screens are kept separately
+    set_term(one);
+    mvaddstr(1, 0, "FIRST");
+    refresh();
+    mstest::expect_eq(first.received(), "\rFIRST");
+    mstest::expect_eq(second.received(), "");
+}
+
+MSTEST_F(ScreenShould, ReadKeysFromTerminalOfCurrentScreen)
+{
+    Line& first = line();
+    Line& second = line();
+    SCREEN* one = open(first, "msos-tests");
+    SCREEN* two = open(second, "msos-tests");
+    first.type("a");
+    second.type("b");
+    mstest::expect_eq(getch(), 'b');
+    set_term(one);
+    mstest::expect_eq(getch(), 'a');
+    mstest::expect_true(set_term(two) == one);
+}
+
+MSTEST_F(ScreenShould, KeepColorsOfEachScreen)
+{
+    Line& first = line();
+    Line& second = line();
+    SCREEN* one = open(first, "vt220");
+    start_color();
+    init_pair(1, COLOR_RED, COLOR_BLUE);
+    mstest::expect_eq(termname(), std::string("vt220"));
+
+    open(second, "linux");
+    start_color();
+    short fg = 0;
+    short bg = 0;
+    pair_content(1, &fg, &bg);
+    mstest::expect_eq(fg, -1);
+    mstest::expect_eq(termname(), std::string("linux"));
+    mstest::expect_eq(tigetflag("bce"), 1);
+
+    set_term(one);
+    pair_content(1, &fg, &bg);
+    mstest::expect_eq(fg, COLOR_RED);
+    mstest::expect_eq(bg, COLOR_BLUE);
+    mstest::expect_eq(tigetflag("bce"), 0);
+}
+
+MSTEST_F(ScreenShould, ReuseDeletedScreens)
+{
+    int opened = 0;
+    for (int i = 0; i <= MAX_SCREENS; ++i)
+    {
+        opened += open(line(), "msos-tests") != nullptr;
+    }
+    mstest::expect_true(opened > 0 && opened <= MAX_SCREENS);
+
+    Line& extra = line();
+    mstest::expect_true(extra.open("msos-tests") == nullptr);
+    SCREEN* last = set_term(nullptr);
+    endwin();
+    delscreen(last);
+    mstest::expect_true(open(extra, "msos-tests") == last);
+}
+
+MSTEST_F(ScreenShould, DrawSourceOnAttachedViewers)
+{
+    Line& first = line();
+    Line& second = line();
+    SCREEN* viewer = open(second, "vt100");
+    SCREEN* source = open(first, "vt100");
+    mstest::expect_eq(attach_screen(source, viewer), OK);
+    mstest::expect_eq(attach_screen(viewer, source), ERR);
+    first.received();
+    second.received();
+
+    mvaddstr(1, 2, "shared");
+    refresh();
+    const std::string on_viewer = second.received();
+    mstest::expect_true(first.received().find("shared") != std::string::npos);
+    mstest::expect_true(on_viewer.find("\033[H\033[J") != std::string::npos);
+    mstest::expect_true(on_viewer.find("shared") != std::string::npos);
+
+    // Viewer is drawn only by its source
+    set_term(viewer);
+    mvaddstr(3, 0, "own");
+    refresh();
+    mstest::expect_eq(second.received(), "");
+
+    mstest::expect_eq(detach_screen(viewer), OK);
+    mstest::expect_eq(detach_screen(viewer), ERR);
+    refresh();
+    mstest::expect_true(second.received().find("own") != std::string::npos);
+}
+
+MSTEST_F(ScreenShould, SendSameUpdateToViewersOfSameTerminal)
+{
+    Line& first = line();
+    Line& second = line();
+    Line& third = line();
+    SCREEN* one = open(second, "vt100");
+    SCREEN* two = open(third, "vt100");
+    SCREEN* source = open(first, "xterm-256color");
+    attach_screen(source, one);
+    attach_screen(source, two);
+    mvaddstr(0, 0, "first frame");
+    refresh();
+    second.received();
+    third.received();
+
+    attron(A_UNDERLINE);
+    mvaddstr(2, 4, "second frame");
+    refresh();
+    const std::string update = second.received();
+    mstest::expect_true(update.find("second frame") != std::string::npos);
+    mstest::expect_eq(third.received(), update);
+
+    // Remaining viewer takes over state of one drawing for both
+    detach_screen(two);
+    mvaddstr(2, 4, "third");
+    refresh();
+    mstest::expect_eq(second.received(), "\033[12Dthird");
+    mstest::expect_true(third.received().find("third") == std::string::npos);
+}
+
+MSTEST_F(ScreenShould, ContinueViewerFrameAfterDrain)
+{
+    Line& first = line();
+    Line& second = line();
+    SCREEN* viewer = open(second, "vt100");
+    evloop_enable(true);
+    SCREEN* source = open(first, "vt100");
+    attach_screen(source, viewer);
+    for (int y = 0; y < 16; ++y)
+    {
+        mvaddstr(y, 0, "................................................................................");
+    }
+    refresh();
+
+    // Frame does not fit in output queue, drain makes room for the rest
+    set_term(viewer);
+    std::string shown;
+    char drained[256];
+    int size;
+    while ((size = evloop_drain(drained, sizeof(drained))) > 0)
+    {
+        shown.append(drained, static_cast<std::size_t>(size));
+    }
+    mstest::expect_true(shown.size() > 1024);
+    mstest::expect_eq(std::count(shown.begin(), shown.end(), '.'), 16 * 80);
+    // Only attaching cancels and clears, nothing was lost
+    mstest::expect_true(shown.find('\030', 1) == std::string::npos);
+
+    set_term(source);
+    mvaddstr(0, 0, "after");
+    refresh();
+    set_term(viewer);
+    size = evloop_drain(drained, sizeof(drained));
+    mstest::expect_eq(std::string(drained, static_cast<std::size_t>(size)), "\033[1Hafter");
+    set_term(source);
+}
+
+MSTEST_F(ScreenShould, WriteOutputToChosenSink)
+{
+    Line& terminal = line();
+    SCREEN* created = open(terminal, "vt100");
+    terminal.received();
+
+    // Sinks are used until teardown deletes screen
+    static char buffer[32];
+    mstest::expect_eq(set_output_buffer(created, buffer, sizeof(buffer)), OK);
+    mvaddstr(0, 0, "memory");
+    refresh();
+    const std::string stored(buffer, static_cast<std::size_t>(output_buffer_size(created)));
+    mstest::expect_eq(stored.substr(stored.size() - 6), "memory");
+    mstest::expect_eq(terminal.received(), "");
+
+    std::string taken;
+    const output_callback callback = [](void* context, const char* data, int size) {
+        static_cast<std::string*>(context)->append(data, static_cast<std::size_t>(size));
+        return size;
+    };
+    mstest::expect_eq(set_output_callback(created, callback, &taken), OK);
+    mvaddstr(0, 0, "call");
+    printw("ed");
+    refresh();
+    mstest::expect_true(taken.find("call") != std::string::npos);
+    mstest::expect_true(taken.find("ed") != std::string::npos);
+    mstest::expect_eq(output_buffer_size(created), ERR);
+
+    int pipe_fds[2];
+    static_cast<void>(pipe(pipe_fds));
+    mstest::expect_eq(set_output_fd(created, pipe_fds[1]), OK);
+    mvaddstr(0, 0, "fd");
+    refresh();
+    char received[32] = {};
+    static_cast<void>(read(pipe_fds[0], received, sizeof(received) - 1));
+    mstest::expect_true(std::string(received).find("fd") != std::string::npos);
+    set_output_buffer(created, buffer, sizeof(buffer));
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    mstest::expect_true(printf_history().empty());
+}
+
+MSTEST_F(ScreenShould, RepaintWhenSinkIsFull)
+{
+    Line& terminal = line();
+    SCREEN* created = open(terminal, "vt100");
+    static char buffer[8];
+    set_output_buffer(created, buffer, sizeof(buffer));
+    mvaddstr(0, 0, "longer than buffer");
+    refresh();
+    mstest::expect_eq(output_buffer_size(created), 8);
+
+    static char larger[256];
+    set_output_buffer(created, larger, sizeof(larger));
+    refresh();
+    const std::string repainted(larger, static_cast<std::size_t>(output_buffer_size(created)));
+    mstest::expect_eq(repainted.substr(0, 1), "\030");
+    mstest::expect_true(repainted.find("longer than buffer") != std::string::npos);
+}
+
+MSTEST_F(ScreenShould, WakeWaitingGetchOnResize)
+{
+    Line& terminal = line();
+    SCREEN* created = open(terminal, "vt100");
+    mstest::expect_true(created != nullptr);
+    resize_term(1, 1);
+    // Key typed later ends waiting if resize is missed
+    std::thread resizer([&terminal] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        kill(getpid(), SIGWINCH);
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        terminal.type("x");
+    });
+    mstest::expect_eq(getch(), KEY_RESIZE);
+    resizer.join();
+    mstest::expect_eq(getch(), 'x');
+}
+
+MSTEST_F(ScreenShould, ReturnErrorWhenInputEnds)
+{
+    Line& terminal = line();
+    SCREEN* created = open(terminal, "vt100");
+    mstest::expect_true(created != nullptr);
+    terminal.type("ab");
+    terminal.hang_up();
+    mstest::expect_eq(getch(), 'a');
+    mstest::expect_eq(getch(), 'b');
+    mstest::expect_eq(getch(), ERR);
+}
@@ -0,0 +1,138 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <mstest/mstest.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+#include "msos/libc/printf.hpp"
+
+#include "curses.h"
+
+#include "stats.hpp"
+
+// Nothing is counted when statistics are compiled out
+#if CURSES_STATS
+
+class StatsShould : public mstest::Test
+{
+public:
+    void setup() override
+    {
+        initial_ = set_term(nullptr);
+        output_ = std::fopen("/dev/null", "w");
+        input_ = std::fopen("/dev/null", "r");
+        created_ = newterm("vt100", output_, input_);
+        // Buffer outlives screen, teardown output goes there too
+        set_output_buffer(created_, buffer_, sizeof(buffer_));
+        reset_screen_stats(created_);
+    }
+
+    void teardown() override
+    {
+        set_term(created_);
+        evloop_enable(false);
+        endwin();
+        delscreen(created_);
+        std::fclose(output_);
+        std::fclose(input_);
+        set_term(initial_);
+        printf_history().clear();
+        clear_flush_counter();
+        clear_tcgetattr();
+        clear_tcsetattr();
+    }
+
+protected:
+    static char buffer_[4096];
+    SCREEN* created_ = nullptr;
+
+private:
+    SCREEN* initial_ = nullptr;
+    FILE* output_ = nullptr;
+    FILE* input_ = nullptr;
+};
+
+char StatsShould::buffer_[4096];
+
+MSTEST_F(StatsShould, CountRenderedOutputByKind)
+{
+    mvaddstr(2, 3, "hello");
+    attron(A_BOLD);
+    mvaddstr(2, 10, "bold");
+    refresh();
+
+    SCREEN_STATS stats;
+    mstest::expect_eq(screen_stats(created_, &stats), OK);
+    mstest::expect_eq(stats.frames, 1ul);
+    mstest::expect_eq(stats.cells_diffed, 80ul);
+    mstest::expect_eq(stats.cells_changed, 9ul);
+    mstest::expect_eq(stats.bytes, static_cast<unsigned long>(output_buffer_size(created_)));
+    mstest::expect_eq(stats.text_bytes, 9ul);
+    mstest::expect_true(stats.motion_bytes > 0);
+    mstest::expect_true(stats.attribute_bytes > 0);
+    mstest::expect_eq(stats.text_bytes + stats.motion_bytes + stats.attribute_bytes + stats.erase_bytes, stats.bytes);
+    // Memory sink never calls system
+    mstest::expect_eq(stats.syscalls, 0ul);
+    mstest::expect_true(stats.refresh_p50_us <= stats.refresh_p99_us);
+    mstest::expect_true(stats.refresh_p99_us <= stats.refresh_max_us);
+
+    clear();
+    refresh();
+    mstest::expect_eq(screen_stats(nullptr, &stats), OK);
+    mstest::expect_eq(stats.frames, 2ul);
+    mstest::expect_true(stats.erase_bytes > 0);
+
+    mstest::expect_eq(reset_screen_stats(created_), OK);
+    mstest::expect_eq(screen_stats(created_, &stats), OK);
+    mstest::expect_eq(stats.frames, 0ul);
+    mstest::expect_eq(stats.bytes, 0ul);
+    mstest::expect_eq(screen_stats(created_, nullptr), ERR);
+}
+
+MSTEST_F(StatsShould, CountInputBytesAndKeys)
+{
+    evloop_enable(true);
+    keypad(stdscr, true);
+    int keys[4];
+    mstest::expect_eq(evloop_feed("ab\033[A", 5, keys, 4, NULL), 3);
+
+    SCREEN_STATS stats;
+    screen_stats(created_, &stats);
+    mstest::expect_eq(stats.input_bytes, 5ul);
+    mstest::expect_eq(stats.keys, 3ul);
+}
+
+MSTEST_F(StatsShould, EstimateLatencyPercentiles)
+{
+    msos::curses::LatencyHistogram histogram;
+    mstest::expect_eq(histogram.percentile(500), 0ul);
+    for (unsigned long i = 1; i <= 1000; ++i)
+    {
+        histogram.add(i);
+    }
+    // Reported bound is above real value by at most a quarter
+    mstest::expect_true(histogram.percentile(500) >= 500 && histogram.percentile(500) <= 625);
+    mstest::expect_true(histogram.percentile(990) >= 990 && histogram.percentile(990) <= 1000);
+    mstest::expect_eq(histogram.maximum(), 1000ul);
+
+    histogram.add(1ul << 30);
+    mstest::expect_eq(histogram.percentile(1000), 1ul << 30);
+}
+
+#endif // CURSES_STATS
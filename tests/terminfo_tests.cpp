@@ -0,0 +1,671 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <mstest/mstest.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "msos/libc/printf.hpp"
+
+#include "curses.h"
+#include "line_speed.hpp"
+
+namespace
+{
+
+// Positions of capabilities in compiled entry, see term(5)
+constexpr std::size_t auto_right_margin = 1;
+constexpr std::size_t back_color_erase = 28;
+constexpr std::size_t columns = 0;
+constexpr std::size_t max_colors = 13;
+constexpr std::size_t clear_screen = 5;
+constexpr std::size_t clr_eol = 6;
+constexpr std::size_t clr_eos = 7;
+constexpr std::size_t cursor_address = 10;
+constexpr std::size_t xon_xoff = 20;
+constexpr std::size_t padding_baud_rate = 5;
+constexpr std::size_t pad_char = 104;
+
+struct Entry
+{
+    std::string names;
+    std::vector<std::size_t> booleans;
+    std::vector<std::pair<std::size_t, int>> numbers;
+    std::vector<std::pair<std::size_t, std::string>> strings;
+    std::vector<std::string> extended_booleans;
+    std::vector<std::pair<std::string, std::string>> extended_strings;
+    bool wide_numbers = false;
+};
+
+void put_short(std::vector<std::uint8_t>& data, int value)
+{
+    data.push_back(static_cast<std::uint8_t>(value & 0xff));
+    data.push_back(static_cast<std::uint8_t>((value >> 8) & 0xff));
+}
+
+void put_number(std::vector<std::uint8_t>& data, int value, bool wide)
+{
+    put_short(data, value);
+    if (wide)
+    {
+        put_short(data, value >> 16);
+    }
+}
+
+void align(std::vector<std::uint8_t>& data)
+{
+    if (data.size() & 1)
+    {
+        data.push_back(0);
+    }
+}
+
+std::vector<std::uint8_t> compile(const Entry& entry)
+{
+    std::size_t boolean_count = 0;
+    for (std::size_t index : entry.booleans)
+    {
+        boolean_count = std::max(boolean_count, index + 1);
+    }
+    std::size_t number_count = 0;
+    for (const auto& number : entry.numbers)
+    {
+        number_count = std::max(number_count, number.first + 1);
+    }
+    std::size_t string_count = 0;
+    std::string table;
+    std::vector<int> offsets;
+    for (const auto& string : entry.strings)
+    {
+        string_count = std::max(string_count, string.first + 1);
+    }
+    offsets.assign(string_count, -1);
+    for (const auto& string : entry.strings)
+    {
+        offsets[string.first] = static_cast<int>(table.size());
+        table += string.second;
+        table += '\0';
+    }
+
+    std::vector<std::uint8_t> data;
+    put_short(data, entry.wide_numbers ? 01036 : 0432);
+    put_short(data, static_cast<int>(entry.names.size() + 1));
+    put_short(data, static_cast<int>(boolean_count));
+    put_short(data, static_cast<int>(number_count));
+    put_short(data, static_cast<int>(string_count));
+    put_short(data, static_cast<int>(table.size()));
+    data.insert(data.end(), entry.names.begin(), entry.names.end());
+    data.push_back(0);
+    for (std::size_t i = 0; i < boolean_count; ++i)
+    {
+        bool set = false;
+        for (std::size_t index : entry.booleans)
+        {
+            set = set || index == i;
+        }
+        data.push_back(set ? 1 : 0);
+    }
+    align(data);
+    for (std::size_t i = 0; i < number_count; ++i)
+    {
+        int value = -1;
+        for (const auto& number : entry.numbers)
+        {
+            value = number.first == i ? number.second : value;
+        }
+        put_number(data, value, entry.wide_numbers);
+    }
+    for (int offset : offsets)
+    {
+        put_short(data, offset);
+    }
+    data.insert(data.end(), table.begin(), table.end());
+
+    if (entry.extended_booleans.empty() && entry.extended_strings.empty())
+    {
+        return data;
+    }
+
+    // Extended values are followed by names of all extended capabilities
+    std::string extended_table;
+    std::vector<int> extended_offsets;
+    for (const auto& string : entry.extended_strings)
+    {
+        extended_offsets.push_back(static_cast<int>(extended_table.size()));
+        extended_table += string.second;
+        extended_table += '\0';
+    }
+    const std::size_t names_start = extended_table.size();
+    for (const auto& name : entry.extended_booleans)
+    {
+        extended_offsets.push_back(static_cast<int>(extended_table.size() - names_start));
+        extended_table += name;
+        extended_table += '\0';
+    }
+    for (const auto& string : entry.extended_strings)
+    {
+        extended_offsets.push_back(static_cast<int>(extended_table.size() - names_start));
+        extended_table += string.first;
+        extended_table += '\0';
+    }
+
+    align(data);
+    put_short(data, static_cast<int>(entry.extended_booleans.size()));
+    put_short(data, 0);
+    put_short(data, static_cast<int>(entry.extended_strings.size()));
+    put_short(data, static_cast<int>(extended_offsets.size()));
+    put_short(data, static_cast<int>(extended_table.size()));
+    data.insert(data.end(), entry.extended_booleans.size(), 1);
+    align(data);
+    for (int offset : extended_offsets)
+    {
+        put_short(data, offset);
+    }
+    data.insert(data.end(), extended_table.begin(), extended_table.end());
+    return data;
+}
+
+std::string collected;
+
+int collect(int c)
+{
+    collected += static_cast<char>(c);
+    return c;
+}
+
+void report_speed(speed_t speed)
+{
+    struct termios line = {};
+    cfsetospeed(&line, speed);
+    set_tcgetattr(&line);
+}
+
+std::string printed()
+{
+    std::string data;
+    for (const auto& call : printf_history())
+    {
+        data += call.str();
+    }
+    return data;
+}
+
+} // namespace
+
+class TerminfoShould : public mstest::Test
+{
+public:
+    void setup() override
+    {
+        char directory[] = "/tmp/msos_curses_terminfo_XXXXXX";
+        directory_ = mkdtemp(directory);
+        setenv("TERMINFO", directory_.c_str(), 1);
+        const char* home = std::getenv("HOME");
+        home_ = home != nullptr ? home : "";
+    }
+
+    void teardown() override
+    {
+        for (const auto& file : files_)
+        {
+            std::remove(file.c_str());
+        }
+        for (auto it = directories_.rbegin(); it != directories_.rend(); ++it)
+        {
+            rmdir(it->c_str());
+        }
+        rmdir(directory_.c_str());
+        unsetenv("TERMINFO");
+        unsetenv("TERMINFO_DIRS");
+        setenv("HOME", home_.c_str(), 1);
+        setenv("TERM", "msos-tests", 1);
+        setupterm(nullptr, STDOUT_FILENO, nullptr);
+        printf_history().clear();
+        clear_flush_counter();
+        clear_tcgetattr();
+        clear_tcsetattr();
+    }
+
+    void install(const char* subdirectory, const char* name, const Entry& entry)
+    {
+        const std::string directory = directory_ + "/" + subdirectory;
+        mkdir(directory.c_str(), 0700);
+        directories_.push_back(directory);
+
+        const std::string path = directory + "/" + name;
+        const std::vector<std::uint8_t> data = compile(entry);
+        FILE* file = std::fopen(path.c_str(), "wb");
+        std::fwrite(data.data(), 1, data.size(), file);
+        std::fclose(file);
+        files_.push_back(path);
+    }
+
+    // Hides system database, so only entries installed by test are found
+    void hide_database()
+    {
+        setenv("TERMINFO_DIRS", directory_.c_str(), 1);
+        setenv("HOME", directory_.c_str(), 1);
+    }
+
+private:
+    std::string directory_;
+    std::string home_;
+    std::vector<std::string> directories_;
+    std::vector<std::string> files_;
+};
+
+MSTEST_F(TerminfoShould, ReadCapabilitiesOfCompiledEntry)
+{
+    Entry entry;
+    entry.names = "msos-test|MSOS test terminal";
+    entry.booleans = {auto_right_margin, back_color_erase};
+    entry.numbers = {{columns, 80}, {max_colors, 8}};
+    entry.strings = {{clear_screen, "\033[H\033[2J"}, {clr_eol, "\033[K$<3>"}};
+    install("m", "msos-test", entry);
+
+    int result = -1;
+    mstest::expect_eq(setupterm("msos-test", STDOUT_FILENO, &result), OK);
+    mstest::expect_eq(result, 1);
+    mstest::expect_eq(tigetflag("am"), 1);
+    mstest::expect_eq(tigetflag("bce"), 1);
+    mstest::expect_eq(tigetflag("xenl"), 0);
+    mstest::expect_eq(tigetnum("cols"), 80);
+    mstest::expect_eq(tigetnum("lines"), -1);
+    mstest::expect_eq(std::string(tigetstr("el")), "\033[K$<3>");
+    mstest::expect_true(tigetstr("cup") == nullptr);
+    mstest::expect_eq(std::string(termname()), "msos-test");
+    mstest::expect_eq(std::string(longname()), "MSOS test terminal");
+}
+
+MSTEST_F(TerminfoShould, ReportCapabilitiesOfOtherType)
+{
+    Entry entry;
+    entry.names = "msos-test";
+    entry.booleans = {auto_right_margin};
+    install("m", "msos-test", entry);
+
+    mstest::expect_eq(setupterm("msos-test", STDOUT_FILENO, nullptr), OK);
+    mstest::expect_eq(tigetflag("cols"), -1);
+    mstest::expect_eq(tigetnum("am"), -2);
+    mstest::expect_true(tigetstr("am") == reinterpret_cast<char*>(-1));
+    mstest::expect_eq(tigetflag("unknown"), -1);
+}
+
+MSTEST_F(TerminfoShould, ReadTermcapNames)
+{
+    Entry entry;
+    entry.names = "msos-test";
+    entry.booleans = {back_color_erase};
+    entry.numbers = {{columns, 132}};
+    entry.strings = {{clr_eol, "\033[K"}};
+    install("m", "msos-test", entry);
+
+    mstest::expect_eq(tgetent(nullptr, "msos-test"), 1);
+    mstest::expect_eq(tgetflag("ut"), 1);
+    mstest::expect_eq(tgetnum("co"), 132);
+    char buffer[16];
+    char* area = buffer;
+    mstest::expect_eq(std::string(tgetstr("ce", &area)), "\033[K");
+    mstest::expect_true(area == buffer + 4);
+    mstest::expect_true(tgetstr("cm", &area) == nullptr);
+}
+
+MSTEST_F(TerminfoShould, ReadNumbersOfExtendedNumberFormat)
+{
+    Entry entry;
+    entry.names = "msos-direct";
+    entry.numbers = {{columns, 80}, {max_colors, 0x1000000}};
+    entry.wide_numbers = true;
+    install("m", "msos-direct", entry);
+
+    mstest::expect_eq(setupterm("msos-direct", STDOUT_FILENO, nullptr), OK);
+    mstest::expect_eq(tigetnum("colors"), 0x1000000);
+    mstest::expect_eq(tigetnum("cols"), 80);
+}
+
+MSTEST_F(TerminfoShould, FindExtendedCapabilities)
+{
+    Entry entry;
+    entry.names = "msos-test";
+    entry.booleans = {auto_right_margin};
+    entry.strings = {{clr_eol, "\033[K"}};
+    entry.extended_booleans = {"RGB"};
+    entry.extended_strings = {{"Ms", "\033]52;%p1%s;%p2%s\007"}, {"XM", "\033[?1006;1000%?%p1%{1}%=%th%el%;"}};
+    install("m", "msos-test", entry);
+
+    mstest::expect_eq(setupterm("msos-test", STDOUT_FILENO, nullptr), OK);
+    mstest::expect_eq(tigetflag("RGB"), 1);
+    mstest::expect_eq(std::string(tigetstr("XM")), "\033[?1006;1000%?%p1%{1}%=%th%el%;");
+    mstest::expect_eq(std::string(tigetstr("Ms")), "\033]52;%p1%s;%p2%s\007");
+    mstest::expect_true(tigetstr("Cs") == reinterpret_cast<char*>(-1));
+}
+
+MSTEST_F(TerminfoShould, FindEntryInHexadecimalDirectory)
+{
+    Entry entry;
+    entry.names = "msos-test";
+    install("6d", "msos-test", entry);
+    mstest::expect_eq(setupterm("msos-test", STDOUT_FILENO, nullptr), OK);
+}
+
+MSTEST_F(TerminfoShould, FailWhenEntryIsMissingOrBroken)
+{
+    int result = -1;
+    mstest::expect_eq(setupterm("msos-missing", STDOUT_FILENO, &result), ERR);
+    mstest::expect_eq(result, 0);
+    mstest::expect_eq(setupterm("../msos-test", STDOUT_FILENO, nullptr), ERR);
+
+    Entry entry;
+    entry.names = "msos-broken";
+    entry.numbers = {{columns, 80}};
+    install("m", "msos-broken", entry);
+    const std::string path = std::string(std::getenv("TERMINFO")) + "/m/msos-broken";
+    truncate(path.c_str(), 20);
+    mstest::expect_eq(setupterm("msos-broken", STDOUT_FILENO, nullptr), ERR);
+}
+
+MSTEST_F(TerminfoShould, UseTerminalStringsForOutput)
+{
+    Entry entry;
+    entry.names = "msos-test";
+    entry.booleans = {back_color_erase};
+    entry.numbers = {{max_colors, 256}};
+    entry.strings = {{clear_screen, "\033[2J\033[H$<50>"}, {clr_eos, "\033[0J$<5>"}};
+    install("m", "msos-test", entry);
+
+    setenv("TERM", "msos-test", 1);
+    initscr();
+    clear();
+    mstest::expect_eq(printf_history().back().str(), "\033[2J\033[H");
+
+    mvaddstr(0, 0, "abcdefgh");
+    refresh();
+    printf_history().clear();
+    mvaddstr(0, 0, "ab      ");
+    refresh();
+    mstest::expect_eq(printed(), "\033[6D\033[0J\033[6C");
+
+    start_color();
+    init_pair(1, 197, COLOR_BLACK);
+    printf_history().clear();
+    attrset(COLOR_PAIR(1));
+    mvaddch(1, 0, 'x');
+    refresh();
+    attrset(A_NORMAL);
+    mstest::expect_eq(printed(), "\r\n\033(B\033[0;38;5;196;40mx");
+    endwin();
+}
+
+MSTEST_F(TerminfoShould, AddressCursorWithTerminalString)
+{
+    Entry entry;
+    entry.names = "msos-test";
+    entry.strings = {{cursor_address, "\033Y%p1%' '%+%c%p2%' '%+%c$<5>"}};
+    install("m", "msos-test", entry);
+
+    setenv("TERM", "msos-test", 1);
+    initscr();
+    clear();
+    refresh();
+    printf_history().clear();
+    mvaddch(2, 3, 'x');
+    mvaddch(2, 1, 'y');
+    refresh();
+    mstest::expect_eq(printed(), "\033Y\"!\033(B\033[0my x\033Y\"\"");
+    endwin();
+}
+
+MSTEST_F(TerminfoShould, UseBuiltInDescriptionWithoutDatabaseEntry)
+{
+    hide_database();
+    int result = -1;
+    mstest::expect_eq(setupterm("vt200", STDOUT_FILENO, &result), OK);
+    mstest::expect_eq(result, 1);
+    mstest::expect_eq(std::string(longname()), "DEC VT220");
+    mstest::expect_eq(tigetnum("cols"), 80);
+    mstest::expect_eq(tigetflag("am"), 1);
+    mstest::expect_eq(tigetflag("bce"), 0);
+    mstest::expect_eq(std::string(tigetstr("clear")), "\033[H\033[J");
+    mstest::expect_eq(tigetstr("setaf") == nullptr, true);
+
+    mstest::expect_eq(setupterm("linux", STDOUT_FILENO, nullptr), OK);
+    mstest::expect_eq(tigetflag("bce"), 1);
+    mstest::expect_eq(tigetnum("colors"), 8);
+    mstest::expect_eq(setupterm("DEC VT220", STDOUT_FILENO, nullptr), ERR);
+}
+
+MSTEST_F(TerminfoShould, PreferDatabaseEntryOverBuiltInDescription)
+{
+    hide_database();
+    Entry entry;
+    entry.names = "vt220|MSOS replacement";
+    entry.numbers = {{columns, 132}};
+    install("v", "vt220", entry);
+    mstest::expect_eq(setupterm("vt220", STDOUT_FILENO, nullptr), OK);
+    mstest::expect_eq(tigetnum("cols"), 132);
+}
+
+MSTEST_F(TerminfoShould, EnableAlternateCharacterSetOnInit)
+{
+    hide_database();
+    setenv("TERM", "vt100", 1);
+    initscr();
+    mstest::expect_eq(printf_history().front().str(), "\033(B\033)0");
+    endwin();
+}
+
+MSTEST_F(TerminfoShould, PadCapabilitiesForReportedLineSpeed)
+{
+    hide_database();
+    Entry entry;
+    entry.names = "msos-pad";
+    entry.strings = {{pad_char, "_"}};
+    install("m", "msos-pad", entry);
+
+    report_speed(B9600);
+    mstest::expect_eq(setupterm("msos-pad", STDOUT_FILENO, nullptr), OK);
+    mstest::expect_eq(baudrate(), 9600);
+    mstest::expect_eq(ospeed, static_cast<short>(B9600));
+    mstest::expect_eq(PC, '_');
+
+    collected.clear();
+    tputs("\033[K$<3>", 1, collect);
+    mstest::expect_eq(collected, std::string("\033[K___"));
+    collected.clear();
+    tputs("\033[L$<2*>", 4, collect);
+    mstest::expect_eq(collected, std::string("\033[L________"));
+
+    clear_tcgetattr();
+    mstest::expect_eq(setupterm("msos-pad", STDOUT_FILENO, nullptr), OK);
+    mstest::expect_eq(baudrate(), CURSES_BAUDRATE);
+    mstest::expect_eq(ospeed, static_cast<short>(0));
+    collected.clear();
+    tputs("\033[K$<3>", 1, collect);
+    mstest::expect_eq(collected, std::string("\033[K"));
+}
+
+MSTEST_F(TerminfoShould, PadOnlyMandatoryDelaysWithFlowControl)
+{
+    hide_database();
+    Entry entry;
+    entry.names = "msos-xon";
+    entry.booleans = {xon_xoff};
+    entry.numbers = {{padding_baud_rate, 19200}};
+    entry.strings = {{pad_char, "_"}};
+    install("m", "msos-xon", entry);
+
+    report_speed(B38400);
+    mstest::expect_eq(setupterm("msos-xon", STDOUT_FILENO, nullptr), OK);
+    collected.clear();
+    tputs("a$<5>b$<5/>", 1, collect);
+    mstest::expect_eq(collected, std::string("ab") + std::string(20, '_'));
+
+    // Below padding_baud_rate no padding is needed at all
+    report_speed(B9600);
+    mstest::expect_eq(setupterm("msos-xon", STDOUT_FILENO, nullptr), OK);
+    collected.clear();
+    tputs("a$<5>b$<5/>", 1, collect);
+    mstest::expect_eq(collected, std::string("ab"));
+}
+
+MSTEST_F(TerminfoShould, DelayOutputWithPadCharacters)
+{
+    hide_database();
+    Entry entry;
+    entry.names = "msos-pad";
+    entry.strings = {{pad_char, "_"}};
+    install("m", "msos-pad", entry);
+
+    report_speed(B9600);
+    setenv("TERM", "msos-pad", 1);
+    initscr();
+    clear();
+    refresh();
+    printf_history().clear();
+    delay_output(10);
+    refresh();
+    mstest::expect_eq(printed(), std::string(10, '_'));
+    endwin();
+}
+
+MSTEST_F(TerminfoShould, PreferRelativeMotionOnSlowLine)
+{
+    hide_database();
+    setenv("TERM", "vt100", 1);
+
+    report_speed(B921600);
+    initscr();
+    clear();
+    refresh();
+    mvaddch(5, 10, 'x');
+    refresh();
+    printf_history().clear();
+    mvaddch(7, 10, 'y');
+    refresh();
+    mstest::expect_eq(printed().find("\033[8;11H") != std::string::npos, true);
+    endwin();
+
+    report_speed(B9600);
+    initscr();
+    clear();
+    refresh();
+    mvaddch(5, 10, 'x');
+    refresh();
+    printf_history().clear();
+    mvaddch(7, 10, 'y');
+    refresh();
+    mstest::expect_eq(printed().find("\033[8;11H"), std::string::npos);
+    mstest::expect_eq(printed().find("\033[2B\b") != std::string::npos, true);
+    endwin();
+}
+
+MSTEST_F(TerminfoShould, HideCursorWhileItJumpsAroundScreen)
+{
+    hide_database();
+    setenv("TERM", "vt220", 1);
+    initscr();
+    clear();
+    refresh();
+
+    // Single motion costs less than hiding cursor
+    printf_history().clear();
+    mvaddch(2, 3, 'x');
+    refresh();
+    mstest::expect_eq(printed().find("\033[?25l"), std::string::npos);
+
+    printf_history().clear();
+    mvaddch(10, 10, 'a');
+    mvaddch(20, 40, 'b');
+    mvaddch(5, 5, 'c');
+    refresh();
+    const std::string frame = printed();
+    // Second jump makes motions cost more than hiding cursor
+    mstest::expect_eq(frame.find("\033[?25l"), frame.find("\033[11;11H") - 6);
+    mstest::expect_eq(frame.rfind("\033[?25h"), frame.size() - 6);
+    endwin();
+}
+
+MSTEST_F(TerminfoShould, SetCursorVisibility)
+{
+    hide_database();
+    setenv("TERM", "vt220", 1);
+    initscr();
+    clear();
+    refresh();
+
+    printf_history().clear();
+    mstest::expect_eq(curs_set(0), 1);
+    mstest::expect_eq(printed(), "\033[?25l");
+    mstest::expect_eq(curs_set(3), ERR);
+
+    // Invisible cursor is neither hidden nor shown by update
+    printf_history().clear();
+    mvaddch(10, 10, 'a');
+    mvaddch(20, 40, 'b');
+    mvaddch(5, 5, 'c');
+    refresh();
+    mstest::expect_eq(printed().find("\033[?25"), std::string::npos);
+
+    printf_history().clear();
+    endwin();
+    mstest::expect_true(printed().find("\033[?25h") != std::string::npos);
+    printf_history().clear();
+    refresh();
+    mstest::expect_eq(printed().rfind("\033[?25l", 0), 0u);
+    mstest::expect_eq(curs_set(1), 0);
+    endwin();
+
+    setenv("TERM", "vt100", 1);
+    initscr();
+    mstest::expect_eq(curs_set(0), ERR);
+    endwin();
+}
+
+MSTEST_F(TerminfoShould, LeaveCursorWhereUpdateEnds)
+{
+    hide_database();
+    setenv("TERM", "vt220", 1);
+    initscr();
+    clear();
+    refresh();
+
+    printf_history().clear();
+    mvaddch(5, 5, 'x');
+    move(0, 0);
+    refresh();
+    mstest::expect_eq(printed().substr(printed().size() - 5), "x\033[1H");
+
+    mstest::expect_eq(leaveok(stdscr, true), OK);
+    printf_history().clear();
+    mvaddch(5, 5, 'y');
+    move(0, 0);
+    refresh();
+    mstest::expect_eq(printed(), "\033[6;6Hy");
+    mstest::expect_eq(stdscr->cursor_y, 0);
+    leaveok(stdscr, false);
+    endwin();
+}
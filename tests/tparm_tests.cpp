@@ -0,0 +1,121 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <mstest/mstest.hpp>
+
+#include <climits>
+#include <string>
+
+#include "curses.h"
+
+namespace
+{
+
+std::string expanded(const char* result)
+{
+    return result != nullptr ? result : "(null)";
+}
+
+} // namespace
+
+class TparmShould : public mstest::Test
+{
+};
+
+MSTEST_F(TparmShould, ExpandCursorAddress)
+{
+    const char* cup = "\033[%i%p1%d;%p2%dH";
+    mstest::expect_eq(expanded(tparm(cup, 4L, 9L)), "\033[5;10H");
+    mstest::expect_eq(expanded(tiparm(cup, 0, 0)), "\033[1;1H");
+    mstest::expect_eq(expanded(tgoto(cup, 9, 4)), "\033[5;10H");
+    mstest::expect_eq(expanded(tiparm("\033Y%p1%' '%+%c%p2%' '%+%c", 2, 3)), "\033Y\"#");
+}
+
+MSTEST_F(TparmShould, ChooseBranchOfConditional)
+{
+    const char* setaf = "\033[%?%p1%{8}%<%t3%p1%d%e%p1%{16}%<%t9%p1%{8}%-%d%e38;5;%p1%d%;m";
+    mstest::expect_eq(expanded(tiparm(setaf, 1)), "\033[31m");
+    mstest::expect_eq(expanded(tiparm(setaf, 9)), "\033[91m");
+    mstest::expect_eq(expanded(tiparm(setaf, 200)), "\033[38;5;200m");
+    mstest::expect_eq(expanded(tiparm("%?%p1%t%?%p2%tboth%eone%;%enone%;", 1, 0)), "one");
+    mstest::expect_eq(expanded(tiparm("%?%p1%t%?%p2%tboth%eone%;%enone%;", 0, 1)), "none");
+}
+
+MSTEST_F(TparmShould, EvaluateOperators)
+{
+    mstest::expect_eq(expanded(tiparm("%p1%p2%*%{3}%/%d", 6, 7)), "14");
+    mstest::expect_eq(expanded(tiparm("%p1%{4}%m%d %p1%{-1}%^%d %p1%!%d %p2%~%d", 7, 0)), "3 -8 0 -1");
+    mstest::expect_eq(expanded(tiparm("%p1%{0}%/%d", 5)), "0");
+    mstest::expect_eq(expanded(tiparm("%p1%Pa%ga%ga%+%d %%", 21)), "42 %");
+}
+
+MSTEST_F(TparmShould, WrapArithmeticOverflow)
+{
+    const std::string min = std::to_string(LONG_MIN);
+    mstest::expect_eq(expanded(tparm("%p1%p2%/%d", LONG_MIN, -1L)), min);
+    mstest::expect_eq(expanded(tparm("%p1%p2%m%d", LONG_MIN, -1L)), "0");
+    mstest::expect_eq(expanded(tparm("%p1%{1}%+%d", LONG_MAX)), min);
+    mstest::expect_eq(expanded(tparm("%p1%{2}%*%d", LONG_MAX)), "-2");
+}
+
+MSTEST_F(TparmShould, SaturateLongNumbers)
+{
+    mstest::expect_eq(expanded(tiparm("%{99999999999}%d")), std::to_string(INT_MAX));
+    mstest::expect_eq(expanded(tiparm("%{-99999999999}%d")), std::to_string(-INT_MAX));
+    mstest::expect_eq(tiparm("%p1%99999999999d", 1) == nullptr, true);
+    mstest::expect_eq(tiparm("%p1%.99999999999d", 1) == nullptr, true);
+}
+
+MSTEST_F(TparmShould, FormatNumbersAndStrings)
+{
+    mstest::expect_eq(expanded(tiparm("%p1%03d|%p1%x|%p1%#o|%p1%:-4d|", 10)), "010|a|012|10  |");
+    mstest::expect_eq(expanded(tparm("%p1%s=%p1%l%d", "name")), "name=4");
+    mstest::expect_eq(expanded(tiparm("%p2%s:%p1%d", 7, "x")), "x:7");
+}
+
+MSTEST_F(TparmShould, KeepStaticVariablesBetweenCalls)
+{
+    tiparm("%p1%PZ", 12);
+    mstest::expect_eq(expanded(tiparm("%gZ%d")), "12");
+    tiparm("%p1%PZ", 13);
+    mstest::expect_eq(expanded(tiparm("%gZ%d")), "13");
+}
+
+MSTEST_F(TparmShould, ReuseResultForSameArguments)
+{
+    const char* cup = "\033[%i%p1%d;%p2%dH";
+    const char* first = tiparm(cup, 1, 2);
+    mstest::expect_eq(tiparm(cup, 1, 2) == first, true);
+    mstest::expect_eq(expanded(tiparm(cup, 2, 2)), "\033[3;3H");
+
+    char buffer[] = "%p1%d";
+    mstest::expect_eq(expanded(tiparm(buffer, 5)), "5");
+    buffer[4] = 'x';
+    mstest::expect_eq(expanded(tiparm(buffer, 5)), "5");
+    buffer[4] = 'o';
+    mstest::expect_eq(expanded(tiparm(buffer, 8)), "10");
+}
+
+MSTEST_F(TparmShould, RejectMalformedStrings)
+{
+    mstest::expect_eq(tiparm("%p0%d", 1) == nullptr, true);
+    mstest::expect_eq(tiparm("%?%p1%t1", 1) == nullptr, true);
+    mstest::expect_eq(tiparm("%;", 1) == nullptr, true);
+    mstest::expect_eq(tiparm("%{12", 1) == nullptr, true);
+    mstest::expect_eq(tiparm("%q", 1) == nullptr, true);
+    mstest::expect_eq(tparm(nullptr) == nullptr, true);
+}
@@ -0,0 +1,632 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "vt_emulator.hpp"
+
+#include <algorithm>
+
+#include "unicode.hpp"
+
+namespace msos::curses
+{
+
+namespace
+{
+
+constexpr unsigned char bell = 0x07;
+constexpr unsigned char backspace = 0x08;
+constexpr unsigned char tab = 0x09;
+constexpr unsigned char shift_out = 0x0e;
+constexpr unsigned char shift_in = 0x0f;
+constexpr unsigned char cancel = 0x18;
+constexpr unsigned char substitute = 0x1a;
+constexpr unsigned char escape_code = 0x1b;
+
+// DEC special graphics replace only these characters
+constexpr bool graphic_character(std::uint32_t c)
+{
+    return c >= 0x5f && c <= 0x7e;
+}
+
+} // namespace
+
+VtEmulator::VtEmulator(int lines, int columns, bool background_erase)
+    : lines_(lines)
+    , columns_(columns)
+    , background_erase_(background_erase)
+    , cells_(static_cast<std::size_t>(lines * columns))
+    , bottom_(lines - 1)
+{
+}
+
+void VtEmulator::set_background_erase(bool enabled)
+{
+    background_erase_ = enabled;
+}
+
+void VtEmulator::feed(const char* data, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        byte(static_cast<unsigned char>(data[i]));
+    }
+}
+
+const VtEmulator::Cell& VtEmulator::cell(int y, int x) const
+{
+    return cells_[static_cast<std::size_t>(y * columns_ + x)];
+}
+
+int VtEmulator::cursor_y() const
+{
+    return cursor_y_;
+}
+
+int VtEmulator::cursor_x() const
+{
+    return cursor_x_;
+}
+
+void VtEmulator::byte(unsigned char c)
+{
+    if (state_ == State::string || state_ == State::string_escape)
+    {
+        // Strings end with BEL or ST, contents are ignored
+        if (c == bell || (state_ == State::string_escape && c == '\\'))
+        {
+            state_ = State::ground;
+        }
+        else
+        {
+            state_ = c == escape_code ? State::string_escape : State::string;
+        }
+        return;
+    }
+
+    if (c == cancel || c == substitute || c == escape_code)
+    {
+        utf8_remaining_ = 0;
+        state_ = c == escape_code ? State::escape : State::ground;
+        return;
+    }
+    if (c < 0x20)
+    {
+        // Controls are executed also in the middle of sequences
+        control(c);
+        return;
+    }
+
+    switch (state_)
+    {
+        case State::escape:
+            escape(c);
+            return;
+        case State::charset:
+            graphics_[intermediate_ == ')' ? 1 : 0] = c == '0';
+            state_ = State::ground;
+            return;
+        case State::csi:
+            if (c >= '0' && c <= '9')
+            {
+                if (parameters_.empty())
+                {
+                    parameters_.push_back(0);
+                }
+                parameters_.back() = parameters_.back() * 10 + (c - '0');
+                parameter_started_ = true;
+            }
+            else if (c == ';')
+            {
+                if (parameters_.empty())
+                {
+                    parameters_.push_back(0);
+                }
+                parameters_.push_back(0);
+            }
+            else if (c >= '<' && c <= '?')
+            {
+                private_ = static_cast<char>(c);
+            }
+            else if (c >= 0x20 && c <= 0x2f)
+            {
+                intermediate_ = static_cast<char>(c);
+            }
+            else if (c >= 0x40 && c <= 0x7e)
+            {
+                state_ = State::ground;
+                csi(c);
+            }
+            return;
+        default:
+            break;
+    }
+
+    if (c == 0x7f)
+    {
+        return;
+    }
+    if (c < 0x80)
+    {
+        utf8_remaining_ = 0;
+        print(c);
+        return;
+    }
+
+    if (utf8_remaining_ > 0 && (c & 0xc0) == 0x80)
+    {
+        utf8_ = (utf8_ << 6) | (c & 0x3f);
+        if (--utf8_remaining_ == 0)
+        {
+            print(utf8_);
+        }
+        return;
+    }
+    const std::size_t length = utf8_length(c);
+    if (length < 2)
+    {
+        utf8_remaining_ = 0;
+        print(replacement_character);
+        return;
+    }
+    utf8_remaining_ = static_cast<int>(length) - 1;
+    utf8_ = c & (0x7fu >> length);
+}
+
+void VtEmulator::control(unsigned char c)
+{
+    switch (c)
+    {
+        case '\r':
+            move(cursor_y_, 0);
+            break;
+        case '\n':
+        case '\v':
+        case '\f':
+            wrap_pending_ = false;
+            line_feed();
+            break;
+        case backspace:
+            move(cursor_y_, cursor_x_ - 1);
+            break;
+        case tab:
+            move(cursor_y_, std::min(columns_ - 1, (cursor_x_ / 8 + 1) * 8));
+            break;
+        case shift_out:
+            shift_ = 1;
+            break;
+        case shift_in:
+            shift_ = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+void VtEmulator::escape(unsigned char c)
+{
+    state_ = State::ground;
+    switch (c)
+    {
+        case '[':
+            state_ = State::csi;
+            parameters_.clear();
+            parameter_started_ = false;
+            private_ = 0;
+            intermediate_ = 0;
+            break;
+        case ']':
+        case 'P':
+        case '_':
+        case '^':
+            state_ = State::string;
+            break;
+        case '(':
+        case ')':
+            state_ = State::charset;
+            intermediate_ = static_cast<char>(c);
+            break;
+        case '7':
+            saved_y_ = cursor_y_;
+            saved_x_ = cursor_x_;
+            break;
+        case '8':
+            move(saved_y_, saved_x_);
+            break;
+        case 'D':
+            wrap_pending_ = false;
+            line_feed();
+            break;
+        case 'E':
+            move(cursor_y_, 0);
+            line_feed();
+            break;
+        case 'M':
+            wrap_pending_ = false;
+            if (cursor_y_ == top_)
+            {
+                scroll_down(top_, bottom_, 1);
+            }
+            else if (cursor_y_ > 0)
+            {
+                --cursor_y_;
+            }
+            break;
+        case 'c':
+            *this = VtEmulator(lines_, columns_, background_erase_);
+            break;
+        default:
+            break;
+    }
+}
+
+void VtEmulator::csi(unsigned char final)
+{
+    if (private_ != 0 || intermediate_ != 0)
+    {
+        // Modes and queries do not change screen contents
+        return;
+    }
+
+    const int count = std::max(1, parameter(0, 1));
+    const int index = cursor_y_ * columns_ + cursor_x_;
+    switch (final)
+    {
+        case 'A':
+            move(cursor_y_ - count, cursor_x_);
+            break;
+        case 'B':
+            move(cursor_y_ + count, cursor_x_);
+            break;
+        case 'C':
+            move(cursor_y_, cursor_x_ + count);
+            break;
+        case 'D':
+            move(cursor_y_, cursor_x_ - count);
+            break;
+        case 'E':
+            move(cursor_y_ + count, 0);
+            break;
+        case 'F':
+            move(cursor_y_ - count, 0);
+            break;
+        case 'G':
+            move(cursor_y_, count - 1);
+            break;
+        case 'd':
+            move(count - 1, cursor_x_);
+            break;
+        case 'H':
+        case 'f':
+            move(std::max(1, parameter(0, 1)) - 1, std::max(1, parameter(1, 1)) - 1);
+            break;
+        case 'J':
+            switch (parameter(0, 0))
+            {
+                case 0:
+                    erase(index, lines_ * columns_);
+                    break;
+                case 1:
+                    erase(0, index + 1);
+                    break;
+                case 2:
+                    erase(0, lines_ * columns_);
+                    break;
+                default:
+                    // Scrollback is not kept
+                    break;
+            }
+            break;
+        case 'K':
+            switch (parameter(0, 0))
+            {
+                case 0:
+                    erase(index, cursor_y_ * columns_ + columns_);
+                    break;
+                case 1:
+                    erase(cursor_y_ * columns_, index + 1);
+                    break;
+                case 2:
+                    erase(cursor_y_ * columns_, cursor_y_ * columns_ + columns_);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case 'X':
+            erase(index, std::min(index + count, cursor_y_ * columns_ + columns_));
+            break;
+        case 'b':
+            for (int i = 0; i < count && last_known_; ++i)
+            {
+                print(last_);
+            }
+            break;
+        case '@':
+        {
+            Cell* line = &at(cursor_y_, 0);
+            const int shift = std::min(count, columns_ - cursor_x_);
+            std::copy_backward(line + cursor_x_, line + columns_ - shift, line + columns_);
+            std::fill(line + cursor_x_, line + cursor_x_ + shift, blank());
+            wrap_pending_ = false;
+            break;
+        }
+        case 'P':
+        {
+            Cell* line = &at(cursor_y_, 0);
+            const int shift = std::min(count, columns_ - cursor_x_);
+            std::copy(line + cursor_x_ + shift, line + columns_, line + cursor_x_);
+            std::fill(line + columns_ - shift, line + columns_, blank());
+            wrap_pending_ = false;
+            break;
+        }
+        case 'L':
+            if (cursor_y_ >= top_ && cursor_y_ <= bottom_)
+            {
+                scroll_down(cursor_y_, bottom_, count);
+                move(cursor_y_, 0);
+            }
+            break;
+        case 'M':
+            if (cursor_y_ >= top_ && cursor_y_ <= bottom_)
+            {
+                scroll_up(cursor_y_, bottom_, count);
+                move(cursor_y_, 0);
+            }
+            break;
+        case 'S':
+            scroll_up(top_, bottom_, count);
+            break;
+        case 'T':
+            scroll_down(top_, bottom_, count);
+            break;
+        case 'r':
+        {
+            const int top = std::max(1, parameter(0, 1)) - 1;
+            const int bottom = std::min(lines_, parameter(1, lines_)) - 1;
+            if (top < bottom)
+            {
+                top_ = top;
+                bottom_ = bottom;
+                move(0, 0);
+            }
+            break;
+        }
+        case 's':
+            saved_y_ = cursor_y_;
+            saved_x_ = cursor_x_;
+            break;
+        case 'u':
+            move(saved_y_, saved_x_);
+            break;
+        case 'm':
+            sgr();
+            break;
+        default:
+            break;
+    }
+}
+
+void VtEmulator::sgr()
+{
+    if (parameters_.empty())
+    {
+        parameters_.push_back(0);
+    }
+
+    for (std::size_t i = 0; i < parameters_.size(); ++i)
+    {
+        const int code = parameters_[i];
+        if (code == 38 || code == 48)
+        {
+            int& color = code == 38 ? pen_.fg : pen_.bg;
+            if (parameter(i + 1, 0) == 5)
+            {
+                color = parameter(i + 2, 0);
+                i += 2;
+            }
+            else if (parameter(i + 1, 0) == 2)
+            {
+                color = 0x1000000 | (parameter(i + 2, 0) << 16) | (parameter(i + 3, 0) << 8) | parameter(i + 4, 0);
+                i += 4;
+            }
+            continue;
+        }
+
+        if (code == 0)
+        {
+            const std::uint32_t text = pen_.text;
+            pen_ = Cell();
+            pen_.text = text;
+        }
+        else if (code == 1 || code == 2)
+        {
+            pen_.bold = true;
+        }
+        else if (code == 4)
+        {
+            pen_.underline = true;
+        }
+        else if (code == 7)
+        {
+            pen_.reverse = true;
+        }
+        else if (code == 22)
+        {
+            pen_.bold = false;
+        }
+        else if (code == 24)
+        {
+            pen_.underline = false;
+        }
+        else if (code == 27)
+        {
+            pen_.reverse = false;
+        }
+        else if (code >= 30 && code <= 37)
+        {
+            pen_.fg = code - 30;
+        }
+        else if (code == 39)
+        {
+            pen_.fg = default_color;
+        }
+        else if (code >= 40 && code <= 47)
+        {
+            pen_.bg = code - 40;
+        }
+        else if (code == 49)
+        {
+            pen_.bg = default_color;
+        }
+        else if (code >= 90 && code <= 97)
+        {
+            pen_.fg = code - 90 + 8;
+        }
+        else if (code >= 100 && code <= 107)
+        {
+            pen_.bg = code - 100 + 8;
+        }
+    }
+}
+
+void VtEmulator::print(std::uint32_t c)
+{
+    const int width = character_width(static_cast<char32_t>(c));
+    if (width == 0)
+    {
+        // Mark joins character left of cursor, or under it after last column
+        int x = wrap_pending_ ? cursor_x_ : cursor_x_ - 1;
+        if (x > 0 && at(cursor_y_, x).text == cell_continuation)
+        {
+            --x;
+        }
+        Cell& base = at(cursor_y_, std::max(x, 0));
+        if (x >= 0 && c >= combining_first && c <= combining_last && (base.text >> cell_combining_offset) == 0)
+        {
+            base.text |= (c - combining_first + 1) << cell_combining_offset;
+        }
+        return;
+    }
+    if (width < 0)
+    {
+        return;
+    }
+
+    if (wrap_pending_ || (width == 2 && cursor_x_ == columns_ - 1))
+    {
+        cursor_x_ = 0;
+        wrap_pending_ = false;
+        line_feed();
+    }
+
+    last_ = c;
+    last_known_ = true;
+    put(c);
+    if (width == 2)
+    {
+        ++cursor_x_;
+        put(cell_continuation);
+    }
+    if (cursor_x_ < columns_ - 1)
+    {
+        ++cursor_x_;
+    }
+    else
+    {
+        wrap_pending_ = true;
+    }
+}
+
+void VtEmulator::put(std::uint32_t c)
+{
+    // Overwriting half of double width character blanks the other one
+    if (c != cell_continuation && cursor_x_ > 0 && at(cursor_y_, cursor_x_).text == cell_continuation)
+    {
+        at(cursor_y_, cursor_x_ - 1).text = ' ';
+    }
+    if (cursor_x_ + 1 < columns_ && at(cursor_y_, cursor_x_ + 1).text == cell_continuation)
+    {
+        at(cursor_y_, cursor_x_ + 1).text = ' ';
+    }
+
+    Cell& cell = at(cursor_y_, cursor_x_);
+    cell = pen_;
+    cell.alternate = graphics_[shift_] && graphic_character(c);
+    cell.text = c;
+}
+
+void VtEmulator::line_feed()
+{
+    if (cursor_y_ == bottom_)
+    {
+        scroll_up(top_, bottom_, 1);
+    }
+    else if (cursor_y_ < lines_ - 1)
+    {
+        ++cursor_y_;
+    }
+}
+
+void VtEmulator::scroll_up(int top, int bottom, int count)
+{
+    count = std::min(count, bottom - top + 1);
+    const auto first = cells_.begin() + top * columns_;
+    const auto last = cells_.begin() + (bottom + 1) * columns_;
+    std::copy(first + count * columns_, last, first);
+    std::fill(last - count * columns_, last, blank());
+}
+
+void VtEmulator::scroll_down(int top, int bottom, int count)
+{
+    count = std::min(count, bottom - top + 1);
+    const auto first = cells_.begin() + top * columns_;
+    const auto last = cells_.begin() + (bottom + 1) * columns_;
+    std::copy_backward(first, last - count * columns_, last);
+    std::fill(first, first + count * columns_, blank());
+}
+
+void VtEmulator::erase(int from, int to)
+{
+    std::fill(cells_.begin() + from, cells_.begin() + std::max(from, to), blank());
+    wrap_pending_ = false;
+}
+
+void VtEmulator::move(int y, int x)
+{
+    cursor_y_ = std::clamp(y, 0, lines_ - 1);
+    cursor_x_ = std::clamp(x, 0, columns_ - 1);
+    wrap_pending_ = false;
+}
+
+int VtEmulator::parameter(std::size_t index, int fallback) const
+{
+    return index < parameters_.size() && (parameters_[index] != 0 || parameter_started_) ? parameters_[index] : fallback;
+}
+
+VtEmulator::Cell VtEmulator::blank() const
+{
+    Cell cell;
+    cell.bg = background_erase_ ? pen_.bg : default_color;
+    return cell;
+}
+
+VtEmulator::Cell& VtEmulator::at(int y, int x)
+{
+    return cells_[static_cast<std::size_t>(y * columns_ + x)];
+}
+
+} // namespace msos::curses
@@ -0,0 +1,113 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace msos::curses
+{
+
+// Minimal VT100/xterm terminal, enough to replay output of library and
+// tell what screen would show. Cell text uses window cell encoding:
+// code point, combining mark above cell_combining_offset and
+// cell_continuation for right half of double width character.
+class VtEmulator
+{
+public:
+    static constexpr int default_color = -1;
+
+    struct Cell
+    {
+        std::uint32_t text = ' ';
+        bool alternate = false;
+        bool bold = false;
+        bool underline = false;
+        bool reverse = false;
+        // Palette index or default_color
+        int fg = default_color;
+        int bg = default_color;
+    };
+
+    // Terminals with background color erase fill erased cells with it
+    VtEmulator(int lines, int columns, bool background_erase);
+
+    void set_background_erase(bool enabled);
+
+    void feed(const char* data, std::size_t size);
+
+    const Cell& cell(int y, int x) const;
+    int cursor_y() const;
+    int cursor_x() const;
+
+private:
+    enum class State
+    {
+        ground,
+        escape,
+        charset,
+        csi,
+        string,
+        string_escape
+    };
+
+    void byte(unsigned char c);
+    void control(unsigned char c);
+    void escape(unsigned char c);
+    void csi(unsigned char final);
+    void sgr();
+    void print(std::uint32_t c);
+    void put(std::uint32_t c);
+    void line_feed();
+    void scroll_up(int top, int bottom, int count);
+    void scroll_down(int top, int bottom, int count);
+    void erase(int from, int to);
+    void move(int y, int x);
+    int parameter(std::size_t index, int fallback) const;
+    Cell blank() const;
+    Cell& at(int y, int x);
+
+    int lines_;
+    int columns_;
+    bool background_erase_;
+    std::vector<Cell> cells_;
+    int cursor_y_ = 0;
+    int cursor_x_ = 0;
+    // Last column was written, next character goes to next line
+    bool wrap_pending_ = false;
+    int top_ = 0;
+    int bottom_;
+    int saved_y_ = 0;
+    int saved_x_ = 0;
+    Cell pen_;
+    bool graphics_[2] = {false, false};
+    int shift_ = 0;
+    std::uint32_t last_ = ' ';
+    bool last_known_ = false;
+
+    State state_ = State::ground;
+    char intermediate_ = 0;
+    char private_ = 0;
+    std::vector<int> parameters_;
+    bool parameter_started_ = false;
+    std::uint32_t utf8_ = 0;
+    int utf8_remaining_ = 0;
+};
+
+} // namespace msos::curses
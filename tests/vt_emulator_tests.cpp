@@ -0,0 +1,304 @@
+// This file is part of MSOS Curses project.
+// Copyright (C) 2020 Mateusz Stadnik
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+
+#include <mstest/mstest.hpp>
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "msos/libc/printf.hpp"
+
+#include "curses.h"
+#include "unicode.hpp"
+#include "vt_emulator.hpp"
+
+using msos::curses::VtEmulator;
+
+namespace
+{
+
+std::string text_of(const VtEmulator& emulator, int y, int x, int size)
+{
+    std::string text;
+    for (int i = 0; i < size; ++i)
+    {
+        text += static_cast<char>(emulator.cell(y, x + i).text);
+    }
+    return text;
+}
+
+// What cell looks like. Blank cells show only background, which is
+// foreground color when reversed.
+struct Look
+{
+    std::uint32_t text;
+    bool alternate;
+    bool bold;
+    bool underline;
+    bool reverse;
+    int fg;
+    int bg;
+
+    bool operator==(const Look& other) const
+    {
+        return text == other.text && alternate == other.alternate && bold == other.bold
+            && underline == other.underline && reverse == other.reverse && fg == other.fg && bg == other.bg;
+    }
+};
+
+Look look(const VtEmulator::Cell& cell)
+{
+    if (cell.text == msos::curses::cell_continuation)
+    {
+        return {cell.text, false, false, false, false, 0, 0};
+    }
+    if (cell.text == ' ' && !cell.underline)
+    {
+        constexpr int default_foreground = -2;
+        const int fg = cell.fg == VtEmulator::default_color ? default_foreground : cell.fg;
+        return {' ', false, false, false, false, 0, cell.reverse ? fg : cell.bg};
+    }
+    const bool graphic = cell.text >= 0x5f && cell.text <= 0x7e;
+    return {cell.text, cell.alternate && graphic, cell.bold, cell.underline, cell.reverse, cell.fg, cell.bg};
+}
+
+// Cell of stdscr in form of emulator cell
+VtEmulator::Cell virtual_cell(int y, int x)
+{
+    const int index = y * stdscr->max_x + x;
+    const unsigned bits = static_cast<unsigned short>(stdscr->screen_buffer[index]);
+    const std::uint32_t wide = static_cast<std::uint32_t>(stdscr->wide_buffer[index]);
+    VtEmulator::Cell cell;
+    cell.text = wide != 0 ? wide : bits & A_CHARTEXT;
+    cell.text = cell.text != 0 ? cell.text : ' ';
+    cell.alternate = bits & A_ALTCHARSET;
+    cell.bold = bits & A_BOLD;
+    cell.underline = bits & A_UNDERLINE;
+    cell.reverse = bits & A_REVERSE;
+    // Pair 0 keeps terminal defaults
+    short fg = VtEmulator::default_color;
+    short bg = VtEmulator::default_color;
+    pair_content(static_cast<short>(bits >> 12), &fg, &bg);
+    cell.fg = fg >= COLOR_BLACK ? fg - COLOR_BLACK : VtEmulator::default_color;
+    cell.bg = bg >= COLOR_BLACK ? bg - COLOR_BLACK : VtEmulator::default_color;
+    return cell;
+}
+
+std::string describe(const VtEmulator::Cell& cell)
+{
+    return "text " + std::to_string(cell.text) + " alt " + std::to_string(cell.alternate)
+        + " bold " + std::to_string(cell.bold) + " ul " + std::to_string(cell.underline)
+        + " rev " + std::to_string(cell.reverse) + " fg " + std::to_string(cell.fg)
+        + " bg " + std::to_string(cell.bg);
+}
+
+// Empty when emulator shows virtual screen
+std::string difference(const VtEmulator& emulator)
+{
+    for (int y = 0; y < stdscr->max_y; ++y)
+    {
+        for (int x = 0; x < stdscr->max_x; ++x)
+        {
+            const VtEmulator::Cell expected = virtual_cell(y, x);
+            if (!(look(emulator.cell(y, x)) == look(expected)))
+            {
+                return "cell " + std::to_string(y) + "," + std::to_string(x) + " expected "
+                    + describe(expected) + " shown " + describe(emulator.cell(y, x));
+            }
+        }
+    }
+    if (stdscr->cursor_y < stdscr->max_y
+        && (emulator.cursor_y() != stdscr->cursor_y || emulator.cursor_x() != stdscr->cursor_x))
+    {
+        return "cursor " + std::to_string(emulator.cursor_y()) + "," + std::to_string(emulator.cursor_x());
+    }
+    return "";
+}
+
+ssize_t feed(void* context, const char* data, std::size_t size)
+{
+    static_cast<VtEmulator*>(context)->feed(data, size);
+    return static_cast<ssize_t>(size);
+}
+
+} // namespace
+
+class VtEmulatorShould : public mstest::Test
+{
+public:
+    void teardown() override
+    {
+        if (created_ != nullptr)
+        {
+            endwin();
+            delscreen(created_);
+            created_ = nullptr;
+            std::fclose(output_);
+            std::fclose(input_);
+        }
+        set_term(initial_);
+        printf_history().clear();
+        clear_flush_counter();
+        clear_tcgetattr();
+        clear_tcsetattr();
+    }
+
+    // Screen drawn only to emulator
+    VtEmulator& open(const char* type)
+    {
+        initial_ = set_term(nullptr);
+        // Stream without descriptor, so screen has default size
+        emulator_ = VtEmulator(24, 80, false);
+        output_ = fopencookie(&emulator_, "w", {nullptr, &feed, nullptr, nullptr});
+        setvbuf(output_, nullptr, _IONBF, 0);
+        input_ = std::fopen("/dev/null", "r");
+        created_ = newterm(type, output_, input_);
+        emulator_.set_background_erase(tigetflag("bce") == 1);
+        start_color();
+        clear();
+        refresh();
+        return emulator_;
+    }
+
+private:
+    SCREEN* initial_ = nullptr;
+    SCREEN* created_ = nullptr;
+    std::FILE* output_ = nullptr;
+    std::FILE* input_ = nullptr;
+    VtEmulator emulator_ = VtEmulator(1, 1, false);
+};
+
+MSTEST_F(VtEmulatorShould, PlaceTextWithCursorMoves)
+{
+    VtEmulator emulator(4, 10, false);
+    const std::string output = "ab\033[3;5Hcd\rx\033[2Cy\033[1;9Hwrap";
+    emulator.feed(output.data(), output.size());
+
+    mstest::expect_eq(text_of(emulator, 0, 0, 2), "ab");
+    mstest::expect_eq(text_of(emulator, 2, 0, 6), "x  ycd");
+    mstest::expect_eq(text_of(emulator, 0, 8, 2), "wr");
+    mstest::expect_eq(text_of(emulator, 1, 0, 2), "ap");
+    mstest::expect_eq(emulator.cursor_y(), 1);
+    mstest::expect_eq(emulator.cursor_x(), 2);
+}
+
+MSTEST_F(VtEmulatorShould, TrackAttributesAndErases)
+{
+    VtEmulator emulator(2, 10, true);
+    const std::string output = "\033[0;1;4;31;42mA\033[22;24m\033[38;5;200mB\033[44m\033[3X\033[2bC\033(0q\033(B";
+    emulator.feed(output.data(), output.size());
+
+    mstest::expect_true(emulator.cell(0, 0).bold && emulator.cell(0, 0).underline);
+    mstest::expect_eq(emulator.cell(0, 0).fg, 1);
+    mstest::expect_eq(emulator.cell(0, 0).bg, 2);
+    mstest::expect_false(emulator.cell(0, 1).bold);
+    mstest::expect_eq(emulator.cell(0, 1).fg, 200);
+    mstest::expect_eq(emulator.cell(0, 4).bg, 4);
+    mstest::expect_eq(text_of(emulator, 0, 1, 5), "BBBCq");
+    mstest::expect_true(emulator.cell(0, 5).alternate);
+    mstest::expect_false(emulator.cell(0, 4).alternate);
+}
+
+MSTEST_F(VtEmulatorShould, KeepWideAndCombiningCharacters)
+{
+    VtEmulator emulator(2, 4, false);
+    const std::string output = "e\xcc\x81\xe4\xb8\xad\xe4\xb8\xad";
+    emulator.feed(output.data(), output.size());
+
+    mstest::expect_eq(emulator.cell(0, 0).text, static_cast<std::uint32_t>('e' | (2u << msos::curses::cell_combining_offset)));
+    mstest::expect_eq(emulator.cell(0, 1).text, 0x4e2du);
+    mstest::expect_eq(emulator.cell(0, 2).text, msos::curses::cell_continuation);
+    mstest::expect_eq(emulator.cell(0, 3).text, static_cast<std::uint32_t>(' '));
+    mstest::expect_eq(emulator.cell(1, 0).text, 0x4e2du);
+}
+
+MSTEST_F(VtEmulatorShould, ShowVirtualScreenAfterEveryUpdate)
+{
+    const char* terminals[] = {"xterm-256color", "vt100", "vt220", "screen"};
+    for (const char* terminal : terminals)
+    {
+        VtEmulator& emulator = open(terminal);
+        std::mt19937 random(static_cast<unsigned>(std::string(terminal).size()));
+        const auto pick = [&random](int from, int to) {
+            return std::uniform_int_distribution<int>(from, to)(random);
+        };
+        const int colors = tigetnum("colors") >= 256 ? 256 : 8;
+        for (short pair = 1; pair < 8; ++pair)
+        {
+            init_pair(pair, static_cast<short>(pick(COLOR_BLACK, colors)), static_cast<short>(pick(COLOR_BLACK, colors)));
+        }
+
+        const char* samples[] = {"\xe4\xb8\xad\xe6\x96\x87", "e\xcc\x81t\xc3\xa9", "\xc5\x82\xc3\xb3" "d\xc5\xba"};
+        std::string failure;
+        for (int frame = 0; frame < 200 && failure.empty(); ++frame)
+        {
+            const int operations = pick(1, 6);
+            for (int i = 0; i < operations; ++i)
+            {
+                wattrset(stdscr, pick(0, 7) | COLOR_PAIR(pick(0, 7)));
+                move(pick(0, stdscr->max_y - 1), pick(0, stdscr->max_x - 1));
+                switch (pick(0, 6))
+                {
+                    case 0:
+                    {
+                        std::string text;
+                        for (int length = pick(1, 30); length > 0; --length)
+                        {
+                            text += static_cast<char>(pick(' ', '~'));
+                        }
+                        addstr(text.c_str());
+                        break;
+                    }
+                    case 1:
+                        addstr(std::string(static_cast<std::size_t>(pick(3, 40)), "x= -"[pick(0, 3)]).c_str());
+                        break;
+                    case 2:
+                        addstr(std::string(static_cast<std::size_t>(pick(3, 60)), ' ').c_str());
+                        break;
+                    case 3:
+                        for (int length = pick(1, 10); length > 0; --length)
+                        {
+                            addch(static_cast<chtype>(pick(0x5f, 0x7e) | A_ALTCHARSET));
+                        }
+                        break;
+                    case 4:
+                        addstr(samples[pick(0, 2)]);
+                        break;
+                    case 5:
+                        if (pick(0, 20) == 0)
+                        {
+                            clear();
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+            refresh();
+            failure = difference(emulator);
+            if (!failure.empty())
+            {
+                failure = std::string(terminal) + " frame " + std::to_string(frame) + ": " + failure;
+            }
+        }
+        mstest::expect_eq(failure, "");
+        attrset(A_NORMAL);
+        teardown();
+    }
+}